@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "storage/index_builder.h"
+#include "query/search_engine.h"
+
+using namespace search_engine;
+
+namespace {
+
+bool sameResults(const std::vector<SearchResult>& a, const std::vector<SearchResult>& b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](const SearchResult& x, const SearchResult& y) {
+               return x.doc_id == y.doc_id && x.score == y.score;
+           });
+}
+
+} // namespace
+
+/**
+ * @brief 批量查询测试
+ *
+ * 用法: batch_bench [文档数] [查询数] [词表大小]
+ * 模拟查询日志：每个查询2~4个词，词从一个较小的热门词表中按Zipf分布抽取，查询之间大量共享词。
+ * 比较逐个调用search()与一次searchBatch()的吞吐，并校验两者结果一致
+ */
+int main(int argc, char* argv[]) {
+    const size_t num_docs = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const size_t num_queries = argc > 2 ? std::stoul(argv[2]) : 2000;
+    const size_t vocabulary = argc > 3 ? std::stoul(argv[3]) : 300;
+    const size_t top_k = 10;
+
+    std::mt19937_64 rng(17);
+    auto zipf = [&rng](size_t n) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return static_cast<size_t>(std::pow(static_cast<double>(n), u)) - 1;
+    };
+
+    IndexBuilder builder;
+    for (size_t d = 1; d <= num_docs; ++d) {
+        size_t length = 30 + rng() % 60;
+        std::string text;
+        for (size_t i = 0; i < length; ++i) {
+            text += 'w';
+            text += std::to_string(zipf(50000));
+            text += ' ';
+        }
+        builder.addDocument(Document(static_cast<int64_t>(d), text));
+    }
+
+    std::vector<std::string> queries;
+    for (size_t q = 0; q < num_queries; ++q) {
+        const size_t terms = 2 + rng() % 3;
+        std::string query;
+        for (size_t t = 0; t < terms; ++t) {
+            query += "w" + std::to_string(5 + zipf(vocabulary)) + " ";
+        }
+        queries.push_back(query);
+    }
+
+    SearchEngine engine;
+    engine.setInvertedIndex(&builder.getInvertedIndex());
+    engine.setSnippetEnabled(false);
+
+    std::vector<std::string> distinct(queries);
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+    std::cout << "文档数: " << num_docs << " | 查询数: " << num_queries << "（不重复 " << distinct.size()
+              << "） | 词表: " << vocabulary << std::endl;
+
+    for (const char* name : {"TF-IDF", "BM25", "自定义"}) {
+        if (std::string(name) == "BM25") {
+            engine.setScorer(std::make_unique<Bm25Scorer>());
+        } else if (std::string(name) == "自定义") {
+            // 自定义排序器走逐文档虚函数打分，只共享求交
+            class CustomScorer : public TfIdfScorer {
+            public:
+                ScoringModel model() const override { return ScoringModel::kCustom; }
+            };
+            engine.setScorer(std::make_unique<CustomScorer>());
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::vector<SearchResult>> expected;
+        size_t hits = 0;
+        for (const auto& query : queries) {
+            expected.push_back(engine.search(query, top_k));
+            hits += expected.back().size();
+        }
+        double loop_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        auto actual = engine.searchBatch(queries, top_k);
+        double batch_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        size_t mismatches = 0;
+        for (size_t q = 0; q < queries.size(); ++q) {
+            mismatches += sameResults(expected[q], actual[q]) ? 0 : 1;
+        }
+
+        std::cout << "\n" << name << "（平均每个查询 " << std::fixed << std::setprecision(1)
+                  << static_cast<double>(hits) / queries.size() << " 个结果）" << std::endl;
+        std::cout << "  逐个search()   " << std::setw(9) << loop_ms << " ms  " << std::setw(9)
+                  << queries.size() / (loop_ms / 1000.0) << " QPS" << std::endl;
+        std::cout << "  searchBatch()  " << std::setw(9) << batch_ms << " ms  " << std::setw(9)
+                  << queries.size() / (batch_ms / 1000.0) << " QPS  (" << std::setprecision(2)
+                  << loop_ms / batch_ms << "x)" << std::endl;
+        std::cout << "  结果不一致的查询: " << mismatches << std::endl;
+    }
+    return 0;
+}
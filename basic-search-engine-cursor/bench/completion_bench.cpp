@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "index/completion_trie.h"
+
+using namespace search_engine;
+
+/**
+ * @brief 前缀补全吞吐测试
+ *
+ * 用法: completion_bench [条目数] [查询次数]
+ * 生成合成查询日志（Zipf权重），构建补全索引，保存后通过mmap加载，
+ * 单线程测量随机前缀查询的吞吐（目标：每核每秒百万次以上）
+ */
+int main(int argc, char* argv[]) {
+    const size_t num_entries = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t num_lookups = argc > 2 ? std::stoul(argv[2]) : 5000000;
+    const size_t top_k = 10;
+
+    // 1. 生成合成查询日志：2~4个词组成的查询，权重服从Zipf分布
+    std::mt19937_64 rng(42);
+    std::vector<std::string> vocabulary;
+    for (size_t i = 0; i < 20000; ++i) {
+        std::string word;
+        size_t length = 2 + rng() % 8;
+        for (size_t k = 0; k < length; ++k) {
+            word.push_back(static_cast<char>('a' + rng() % 26));
+        }
+        vocabulary.push_back(word);
+    }
+    std::vector<std::pair<std::string, uint64_t>> entries;
+    entries.reserve(num_entries);
+    for (size_t i = 0; i < num_entries; ++i) {
+        std::string query = vocabulary[rng() % vocabulary.size()];
+        size_t words = 1 + rng() % 3;
+        for (size_t w = 0; w < words; ++w) {
+            query += ' ';
+            query += vocabulary[rng() % vocabulary.size()];
+        }
+        entries.emplace_back(std::move(query), 1000000 / (i + 1) + 1);
+    }
+
+    // 2. 构建 + 持久化 + mmap加载
+    auto start = std::chrono::steady_clock::now();
+    CompletionTrie built;
+    built.build(entries, top_k);
+    double build_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const std::string path = "completion_bench.trie";
+    CompletionTrie trie;
+    if (!built.save(path) || !trie.load(path)) {
+        std::cerr << "保存/加载补全索引失败" << std::endl;
+        return 1;
+    }
+    std::remove(path.c_str());
+
+    std::cout << "条目数: " << trie.size() << " | 节点数: " << trie.nodeCount()
+              << " | 索引大小: " << trie.bytes() / 1048576.0 << " MB"
+              << " | 构建耗时: " << build_seconds << " s" << std::endl;
+
+    // 3. 随机前缀（取自真实条目，长度1~12字节）
+    std::vector<std::string> prefixes;
+    prefixes.reserve(100000);
+    for (size_t i = 0; i < 100000; ++i) {
+        const std::string& text = entries[rng() % entries.size()].first;
+        prefixes.push_back(text.substr(0, 1 + rng() % std::min<size_t>(text.size(), 12)));
+    }
+
+    std::vector<Completion> results;
+    size_t checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_lookups; ++i) {
+        checksum += trie.complete(prefixes[i % prefixes.size()], top_k, results);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double qps = num_lookups / seconds;
+    std::cout << "查询次数: " << num_lookups << " | 平均返回: " << double(checksum) / num_lookups
+              << " | 吞吐: " << qps / 1e6 << " M次/秒/核"
+              << " | 平均延迟: " << seconds * 1e9 / num_lookups << " ns"
+              << (qps >= 1e6 ? " [达标]" : " [未达标]") << std::endl;
+    return 0;
+}
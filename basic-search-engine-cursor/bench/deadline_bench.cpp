@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "storage/index_builder.h"
+#include "query/search_engine.h"
+
+using namespace search_engine;
+
+/**
+ * @brief 查询截止时间测试
+ *
+ * 用法: deadline_bench [文档数] [查询数]
+ * 在Zipf语料上执行由多个高频词组成的"病态"查询，分别在不设截止时间和
+ * 不同截止时间下统计延迟分布、超时比例以及各阶段被中断的次数
+ */
+int main(int argc, char* argv[]) {
+    const size_t num_docs = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t num_queries = argc > 2 ? std::stoul(argv[2]) : 300;
+
+    std::mt19937_64 rng(5);
+    auto zipf = [&rng](size_t n) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return static_cast<size_t>(std::pow(static_cast<double>(n), u)) - 1;
+    };
+
+    IndexBuilder builder;
+    for (size_t d = 0; d < num_docs; ++d) {
+        size_t length = 50 + rng() % 150;
+        std::string text;
+        for (size_t i = 0; i < length; ++i) {
+            text += 'w';
+            text += std::to_string(zipf(100000));
+            text += ' ';
+        }
+        builder.addDocument(Document(static_cast<int64_t>(d + 1), text));
+    }
+
+    // 2~5个高频词（排名前50）组成的查询，匹配文档数很多
+    std::vector<std::string> queries;
+    for (size_t q = 0; q < num_queries; ++q) {
+        std::string query;
+        size_t terms = 2 + rng() % 4;
+        for (size_t i = 0; i < terms; ++i) {
+            query += "w" + std::to_string(rng() % 50) + " ";
+        }
+        queries.push_back(query);
+    }
+
+    SearchEngine engine;
+    engine.setInvertedIndex(&builder.getInvertedIndex());
+    engine.setForwardIndex(&builder.getForwardIndex());
+
+    std::cout << "文档数: " << num_docs << " | 查询数: " << num_queries << std::endl;
+    for (double millis : {0.0, 20.0, 5.0, 1.0}) {
+        std::vector<double> samples;
+        size_t timed_out = 0;
+        for (const auto& query : queries) {
+            QueryContext context;
+            if (millis > 0.0) {
+                context.setTimeout(std::chrono::duration_cast<QueryContext::Clock::duration>(
+                    std::chrono::duration<double, std::milli>(millis)));
+            }
+            auto start = std::chrono::steady_clock::now();
+            engine.search(query, 10, context);
+            samples.push_back(std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count());
+            timed_out += context.timedOut() ? 1 : 0;
+        }
+        std::sort(samples.begin(), samples.end());
+        double mean = 0.0;
+        for (double sample : samples) {
+            mean += sample;
+        }
+        mean /= samples.size();
+
+        std::cout << std::fixed << std::setprecision(1) << "截止时间 ";
+        if (millis > 0.0) {
+            std::cout << std::setw(5) << millis << " ms";
+        } else {
+            std::cout << "   不限";
+        }
+        std::cout << " | 平均 " << std::setprecision(2) << mean
+                  << " ms | p50 " << samples[samples.size() / 2]
+                  << " ms | p99 " << samples[samples.size() * 99 / 100]
+                  << " ms | max " << samples.back()
+                  << " ms | 超时 " << timed_out << "/" << queries.size() << std::endl;
+    }
+
+    const auto& counters = engine.getStageCounters();
+    std::cout << "各阶段中断次数: 求交 " << counters.get(QueryStage::kIntersection)
+              << " | 打分 " << counters.get(QueryStage::kScoring)
+              << " | 重排序 " << counters.get(QueryStage::kRerank)
+              << " | 摘要 " << counters.get(QueryStage::kSnippet) << std::endl;
+    return 0;
+}
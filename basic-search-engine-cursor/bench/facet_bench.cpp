@@ -0,0 +1,136 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "storage/index_builder.h"
+#include "query/search_engine.h"
+
+using namespace search_engine;
+
+/**
+ * @brief 分面/聚合测试
+ *
+ * 用法: facet_bench [文档数] [查询数]
+ * 查询词覆盖约一半到全部文档，比较：
+ * - 只收集分面（top_k=0，不打分）
+ * - top-10 + 分面
+ * - 先取出全部匹配结果、逐个读取正排文档再计数（应用层计数，作为对照）
+ */
+int main(int argc, char* argv[]) {
+    const size_t num_docs = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const size_t num_queries = argc > 2 ? std::stoul(argv[2]) : 20;
+
+    std::mt19937_64 rng(5);
+    auto zipf = [&rng](size_t n) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return static_cast<size_t>(std::pow(static_cast<double>(n), u)) - 1;
+    };
+
+    // 前几个高频词（h0~h3）每个覆盖一半以上的文档，保证单次查询有10万级命中
+    IndexBuilder builder;
+    DocValues& doc_values = builder.getDocValues();
+    for (size_t d = 1; d <= num_docs; ++d) {
+        std::string category = "c" + std::to_string(zipf(50));
+        std::string text;
+        for (size_t h = 0; h < 4; ++h) {
+            if (rng() % 4 != 0) {
+                text += "h" + std::to_string(h) + " ";
+            }
+        }
+        for (size_t i = 0; i < 20; ++i) {
+            text += "w" + std::to_string(zipf(20000)) + " ";
+        }
+        Document doc(static_cast<int64_t>(d), text);
+        doc.title = category;
+        builder.addDocument(doc);
+        doc_values.setKeyword(static_cast<int64_t>(d), "category", category);
+        doc_values.setInt(static_cast<int64_t>(d), "year", 1990 + static_cast<int64_t>(rng() % 35));
+        doc_values.setDouble(static_cast<int64_t>(d), "price",
+                             std::uniform_real_distribution<double>(0.0, 1000.0)(rng));
+    }
+
+    std::vector<std::string> queries;
+    for (size_t q = 0; q < num_queries; ++q) {
+        queries.push_back("h" + std::to_string(q % 4));
+    }
+
+    SearchEngine engine;
+    engine.setInvertedIndex(&builder.getInvertedIndex());
+    engine.setForwardIndex(&builder.getForwardIndex());
+    engine.setDocValues(&doc_values);
+    engine.setSnippetEnabled(false);
+
+    SearchOptions options;
+    options.facets = {
+        FacetRequest::terms("category", 10),
+        FacetRequest::histogram("year", 5),
+        FacetRequest::stats("price"),
+    };
+
+    auto measure = [&](auto&& run) {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& query : queries) {
+            run(query);
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() /
+               queries.size();
+    };
+
+    size_t hits = 0;
+    std::vector<FacetResult> facets;
+    double facet_only_ms = measure([&](const std::string& query) {
+        engine.search(query, 0, options, &facets);
+        hits += facets[0].other + facets[0].missing;
+        for (const auto& bucket : facets[0].buckets) {
+            hits += bucket.count;
+        }
+    });
+
+    double with_top_k_ms = measure([&](const std::string& query) {
+        engine.search(query, 10, options, &facets);
+    });
+
+    double search_only_ms = measure([&](const std::string& query) {
+        engine.search(query, 10);
+    });
+
+    // 应用层计数：取回全部匹配，逐个读取正排文档
+    const ForwardIndex& forward_index = builder.getForwardIndex();
+    double naive_ms = measure([&](const std::string& query) {
+        auto results = engine.search(query, std::numeric_limits<size_t>::max());
+        std::unordered_map<std::string, uint64_t> counts;
+        for (const auto& result : results) {
+            counts[forward_index.getDocument(result.doc_id).title]++;
+        }
+    });
+
+    std::cout << "文档数: " << num_docs << " | 查询数: " << num_queries
+              << " | 平均命中: " << hits / num_queries << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "只收集分面（不打分）   " << std::setw(8) << facet_only_ms << " ms/查询" << std::endl;
+    std::cout << "top-10 + 分面          " << std::setw(8) << with_top_k_ms << " ms/查询" << std::endl;
+    std::cout << "top-10（无分面）       " << std::setw(8) << search_only_ms << " ms/查询" << std::endl;
+    std::cout << "应用层计数（正排文档） " << std::setw(8) << naive_ms << " ms/查询" << std::endl;
+
+    // 最后一次查询的分面结果
+    engine.search(queries.back(), 0, options, &facets);
+    std::cout << "\n查询 \"" << queries.back() << "\" 的分面:" << std::endl;
+    std::cout << "  category:";
+    for (const auto& bucket : facets[0].buckets) {
+        std::cout << " " << bucket.label << "=" << bucket.count;
+    }
+    std::cout << " 其他=" << facets[0].other << std::endl;
+    std::cout << "  year:";
+    for (const auto& bucket : facets[1].buckets) {
+        std::cout << " " << std::setprecision(0) << bucket.key << "+=" << bucket.count;
+    }
+    std::cout << std::endl;
+    std::cout << "  price: count=" << facets[2].count << std::setprecision(2) << " min=" << facets[2].min
+              << " max=" << facets[2].max << " avg=" << facets[2].average() << std::endl;
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "storage/index_builder.h"
+#include "query/search_engine.h"
+
+using namespace search_engine;
+
+/**
+ * @brief 属性过滤 / 按字段排序测试
+ *
+ * 用法: filter_bench [文档数] [查询数]
+ * 每个文档带 category(关键字, 20种) / year(整数) / price(浮点) 三个属性，
+ * 在不同选择率的过滤条件下比较：
+ * - 过滤位图参与求交（SearchOptions::filters）
+ * - 先对全部匹配文档打分再逐个过滤（后过滤，作为对照）
+ */
+int main(int argc, char* argv[]) {
+    const size_t num_docs = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const size_t num_queries = argc > 2 ? std::stoul(argv[2]) : 200;
+    const size_t top_k = 10;
+
+    std::mt19937_64 rng(3);
+    auto zipf = [&rng](size_t n) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return static_cast<size_t>(std::pow(static_cast<double>(n), u)) - 1;
+    };
+
+    IndexBuilder builder;
+    DocValues& doc_values = builder.getDocValues();
+    for (size_t d = 1; d <= num_docs; ++d) {
+        size_t length = 30 + rng() % 60;
+        std::string text;
+        for (size_t i = 0; i < length; ++i) {
+            text += 'w';
+            text += std::to_string(zipf(50000));
+            text += ' ';
+        }
+        builder.addDocument(Document(static_cast<int64_t>(d), text));
+        doc_values.setKeyword(static_cast<int64_t>(d), "category", "c" + std::to_string(zipf(20)));
+        doc_values.setInt(static_cast<int64_t>(d), "year", 2000 + static_cast<int64_t>(rng() % 25));
+        doc_values.setDouble(static_cast<int64_t>(d), "price",
+                             std::uniform_real_distribution<double>(0.0, 1000.0)(rng));
+    }
+
+    std::vector<std::string> queries;
+    for (size_t q = 0; q < num_queries; ++q) {
+        queries.push_back("w" + std::to_string(rng() % 30) + " w" + std::to_string(rng() % 200));
+    }
+
+    SearchEngine engine;
+    engine.setInvertedIndex(&builder.getInvertedIndex());
+    engine.setDocValues(&doc_values);
+    engine.setSnippetEnabled(false);
+
+    struct Case {
+        std::string label;
+        Filter filter;
+    };
+    const Case cases[] = {
+        {"price<=1 (0.1%)", Filter::doubleRange("price", 0.0, 1.0)},
+        {"category=c5 (~3%)", Filter::equals("category", std::string("c5"))},
+        {"year>=2001 (96%)", Filter::intRange("year", 2001, 3000)},
+    };
+    const DocValuesColumn* year = doc_values.column("year");
+
+    auto average = [&](auto&& run) {
+        auto start = std::chrono::steady_clock::now();
+        size_t hits = 0;
+        for (const auto& query : queries) {
+            hits += run(query);
+        }
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        return std::make_pair(us / queries.size(), hits);
+    };
+
+    std::cout << "文档数: " << num_docs << " | 查询数: " << num_queries
+              << " | 属性列: " << std::fixed << std::setprecision(1)
+              << doc_values.bytes() / 1048576.0 << " MB" << std::endl;
+
+    for (const auto& test : cases) {
+        // 先编译一次，计时只包含查询本身（缓存命中）
+        engine.getFilterCache().get(test.filter, doc_values);
+
+        SearchOptions options;
+        options.filters.push_back(test.filter);
+        auto [filtered_us, filtered_hits] = average([&](const std::string& query) {
+            return engine.search(query, top_k, options).size();
+        });
+
+        DocBitset bitset;
+        test.filter.compile(doc_values, bitset);
+        auto [post_us, post_hits] = average([&](const std::string& query) {
+            auto results = engine.search(query, std::numeric_limits<size_t>::max());
+            size_t kept = 0;
+            for (const auto& result : results) {
+                if (bitset.test(result.doc_id) && ++kept == top_k) {
+                    break;
+                }
+            }
+            return kept;
+        });
+
+        std::cout << std::left << std::setw(22) << test.label << std::right << std::setprecision(1)
+                  << " | 求交时过滤 " << std::setw(8) << filtered_us << " us"
+                  << " | 后过滤 " << std::setw(8) << post_us << " us"
+                  << " | 结果数 " << filtered_hits << "/" << post_hits << std::endl;
+    }
+
+    // 按字段排序：只为top-k打分 vs 全部打分后排序
+    SearchOptions by_year;
+    by_year.sort_field = "year";
+    auto [sorted_us, sorted_hits] = average([&](const std::string& query) {
+        return engine.search(query, top_k, by_year).size();
+    });
+    auto [full_us, full_hits] = average([&](const std::string& query) {
+        auto results = engine.search(query, std::numeric_limits<size_t>::max());
+        size_t keep = std::min(top_k, results.size());
+        std::partial_sort(results.begin(), results.begin() + keep, results.end(),
+                          [year](const SearchResult& a, const SearchResult& b) {
+                              return year->intValue(a.doc_id) > year->intValue(b.doc_id);
+                          });
+        return keep;
+    });
+    std::cout << std::left << std::setw(22) << "sort by year desc" << std::right
+              << " | 字段top-k   " << std::setw(8) << sorted_us << " us"
+              << " | 全量排序 " << std::setw(8) << full_us << " us"
+              << " | 结果数 " << sorted_hits << "/" << full_hits << std::endl;
+
+    std::cout << "过滤缓存: 命中 " << engine.getFilterCache().hits()
+              << " | 未命中 " << engine.getFilterCache().misses() << std::endl;
+    return 0;
+}
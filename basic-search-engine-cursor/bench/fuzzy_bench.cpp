@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "index/inverted_index.h"
+#include "index/term_dictionary.h"
+#include "query/fuzzy_matcher.h"
+
+using namespace search_engine;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 字节级编辑距离（合成词典只有ASCII），超过max_edits时返回max_edits + 1
+int boundedDistance(const std::string& a, std::string_view b, int max_edits) {
+    if (static_cast<int>(a.size()) - static_cast<int>(b.size()) > max_edits ||
+        static_cast<int>(b.size()) - static_cast<int>(a.size()) > max_edits) {
+        return max_edits + 1;
+    }
+    std::vector<int> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) {
+        row[j] = static_cast<int>(j);
+    }
+    for (size_t i = 1; i <= a.size(); ++i) {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        for (size_t j = 1; j <= b.size(); ++j) {
+            int above = row[j];
+            row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diagonal = above;
+        }
+    }
+    return std::min(row[b.size()], max_edits + 1);
+}
+
+/**
+ * @brief 暴力扫描整个词典，按(距离升序, 文档频率降序, 词典序)取前max_expansions个
+ */
+std::vector<std::string> bruteForce(const TermDictionary& dictionary, const InvertedIndex& index,
+                                    const std::string& query, int max_edits, size_t max_expansions) {
+    std::vector<std::tuple<int, int64_t, size_t>> matches;
+    for (size_t i = 0; i < dictionary.size(); ++i) {
+        int distance = boundedDistance(query, dictionary.term(i), max_edits);
+        if (distance <= max_edits) {
+            auto df = static_cast<int64_t>(index.getDocumentFrequency(std::string(dictionary.term(i))));
+            matches.emplace_back(distance, -df, i);
+        }
+    }
+    std::sort(matches.begin(), matches.end());
+    std::vector<std::string> terms;
+    for (size_t i = 0; i < std::min(matches.size(), max_expansions); ++i) {
+        terms.emplace_back(dictionary.term(std::get<2>(matches[i])));
+    }
+    return terms;
+}
+
+// 对词做edits次随机编辑（替换/插入/删除）
+std::string misspell(std::string word, size_t edits, std::mt19937_64& rng) {
+    for (size_t e = 0; e < edits && !word.empty(); ++e) {
+        size_t pos = rng() % word.size();
+        char c = static_cast<char>('a' + rng() % 26);
+        switch (rng() % 3) {
+            case 0: word[pos] = c; break;
+            case 1: word.insert(word.begin() + pos, c); break;
+            default: word.erase(word.begin() + pos); break;
+        }
+    }
+    return word;
+}
+
+} // namespace
+
+/**
+ * @brief 模糊扩展延迟与结果正确性测试
+ *
+ * 用法: fuzzy_bench [文档数] [词表大小] [查询数]
+ * 用Zipf分布的随机词构建倒排索引和有序词典，对随机抽取的词做0~2次随机编辑作为查询，
+ * 测量不同编辑距离、前缀长度、扩展数下expand()的延迟，并与暴力扫描整个词典的
+ * 前max_expansions个结果（按距离、文档频率排序）逐个比对
+ */
+int main(int argc, char* argv[]) {
+    const size_t num_docs = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t vocabulary_size = argc > 2 ? std::stoul(argv[2]) : 500000;
+    const size_t num_queries = argc > 3 ? std::stoul(argv[3]) : 2000;
+    const size_t num_checked = std::min<size_t>(num_queries, 50);
+
+    // 1. 合成语料：短词多、前缀稠密，距离1~2的term数量很多
+    std::mt19937_64 rng(7);
+    std::vector<std::string> vocabulary;
+    vocabulary.reserve(vocabulary_size);
+    for (size_t i = 0; i < vocabulary_size; ++i) {
+        std::string word;
+        size_t length = 3 + rng() % 6;
+        for (size_t k = 0; k < length; ++k) {
+            word.push_back(static_cast<char>('a' + rng() % 26));
+        }
+        vocabulary.push_back(std::move(word));
+    }
+    auto zipf = [&rng](size_t n) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return static_cast<size_t>(std::pow(static_cast<double>(n), u)) - 1;
+    };
+
+    InvertedIndex index;
+    std::vector<std::string> tokens;
+    for (size_t d = 1; d <= num_docs; ++d) {
+        tokens.clear();
+        size_t length = 20 + rng() % 60;
+        for (size_t i = 0; i < length; ++i) {
+            tokens.push_back(vocabulary[zipf(vocabulary.size())]);
+        }
+        index.addDocument(static_cast<int64_t>(d), tokens);
+    }
+    TermDictionary dictionary;
+    dictionary.build(index);
+    std::cout << "文档数: " << num_docs << " | 词典term数: " << dictionary.size() << " | 查询数: " << num_queries
+              << "\n" << std::endl;
+
+    std::vector<std::string> queries;
+    queries.reserve(num_queries);
+    for (size_t q = 0; q < num_queries; ++q) {
+        std::string word(dictionary.term(rng() % dictionary.size()));
+        queries.push_back(misspell(std::move(word), rng() % 3, rng));
+    }
+
+    // 2. 各配置的延迟与正确性
+    struct Config {
+        std::string name;
+        int max_edits;
+        size_t prefix_length;
+        size_t max_expansions;
+    };
+    const std::vector<Config> configs = {
+        {"距离1", 1, 0, 50},
+        {"距离2", 2, 0, 50},
+        {"距离2 前缀1", 2, 1, 50},
+        {"距离2 扩展10", 2, 0, 10},
+        {"距离2 扩展500", 2, 0, 500},
+    };
+
+    FuzzyMatcher matcher(dictionary, &index);
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& config : configs) {
+        FuzzyOptions options;
+        options.max_edits = config.max_edits;
+        options.prefix_length = config.prefix_length;
+        options.max_expansions = config.max_expansions;
+
+        std::vector<double> latencies;
+        latencies.reserve(queries.size());
+        size_t expansions = 0;
+        for (const auto& query : queries) {
+            auto start = Clock::now();
+            auto result = matcher.expand(query, options);
+            latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            expansions += result.size();
+        }
+        std::sort(latencies.begin(), latencies.end());
+        double total = 0.0;
+        for (double latency : latencies) {
+            total += latency;
+        }
+
+        // 暴力比对只在没有前缀约束的配置上做（前缀约束会排除部分距离内的term）
+        size_t matched = 0;
+        if (config.prefix_length == 0) {
+            for (size_t q = 0; q < num_checked; ++q) {
+                auto result = matcher.expand(queries[q], options);
+                auto expected = bruteForce(dictionary, index, queries[q], config.max_edits, config.max_expansions);
+                bool same = result.size() == expected.size();
+                for (size_t i = 0; same && i < result.size(); ++i) {
+                    same = result[i].term == expected[i];
+                }
+                matched += same ? 1 : 0;
+            }
+        }
+
+        std::cout << std::left << std::setw(20) << config.name << std::right
+                  << " 平均 " << std::setw(8) << total / latencies.size() << " us"
+                  << " | p99 " << std::setw(8) << latencies[latencies.size() * 99 / 100] << " us"
+                  << " | 平均扩展 " << std::setw(5) << static_cast<double>(expansions) / queries.size();
+        if (config.prefix_length == 0) {
+            std::cout << " | 与暴力结果一致 " << matched << "/" << num_checked;
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
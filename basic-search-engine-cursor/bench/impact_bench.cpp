@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "storage/index_builder.h"
+#include "query/search_engine.h"
+
+using namespace search_engine;
+
+namespace {
+
+struct Latency {
+    double mean_us = 0.0;
+    double p50_us = 0.0;
+    double p99_us = 0.0;
+};
+
+Latency summarize(std::vector<double> samples) {
+    Latency latency;
+    if (samples.empty()) {
+        return latency;
+    }
+    std::sort(samples.begin(), samples.end());
+    for (double sample : samples) {
+        latency.mean_us += sample;
+    }
+    latency.mean_us /= samples.size();
+    latency.p50_us = samples[samples.size() / 2];
+    latency.p99_us = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    return latency;
+}
+
+void printRow(const std::string& label, const Latency& latency, double postings, double overlap) {
+    std::cout << std::left << std::setw(22) << label << std::right << std::fixed << std::setprecision(1)
+              << " | 平均 " << std::setw(8) << latency.mean_us << " us"
+              << " | p50 " << std::setw(8) << latency.p50_us << " us"
+              << " | p99 " << std::setw(8) << latency.p99_us << " us";
+    if (postings >= 0) {
+        std::cout << " | posting " << std::setw(9) << std::setprecision(0) << postings;
+    }
+    if (overlap >= 0) {
+        std::cout << " | top-10重合 " << std::setprecision(1) << overlap * 100 << "%";
+    }
+    std::cout << std::endl;
+}
+
+} // namespace
+
+/**
+ * @brief 影响值索引 + 带预算的score-at-a-time查询测试
+ *
+ * 用法: impact_bench [文档数] [查询数]
+ * 语料词频服从近似Zipf分布，查询混合高频词和中低频词。比较：
+ * - search()：AND求交 + TfIdfScorer逐文档计算
+ * - searchImpact()：不限预算 / posting预算 / 时间预算
+ * 输出延迟分布，以及有预算时top-10与不限预算结果的重合率
+ */
+int main(int argc, char* argv[]) {
+    const size_t num_docs = argc > 1 ? std::stoul(argv[1]) : 50000;
+    const size_t num_queries = argc > 2 ? std::stoul(argv[2]) : 500;
+    const size_t top_k = 10;
+
+    // 1. 合成语料
+    std::mt19937_64 rng(11);
+    const size_t vocabulary_size = 100000;
+    auto zipf = [&rng](size_t n) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return static_cast<size_t>(std::pow(static_cast<double>(n), u)) - 1;
+    };
+
+    IndexBuilder builder;
+    for (size_t d = 0; d < num_docs; ++d) {
+        size_t length = 50 + rng() % 150;
+        std::string text;
+        for (size_t i = 0; i < length; ++i) {
+            text += 'w';
+            text += std::to_string(zipf(vocabulary_size));
+            text += ' ';
+        }
+        builder.addDocument(Document(static_cast<int64_t>(d + 1), text));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const ImpactIndex& impact_index = builder.buildImpactIndex();
+    double build_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "文档数: " << num_docs << " | posting数: " << impact_index.getPostingCount()
+              << " | 段数: " << impact_index.getSegmentCount()
+              << " | 影响值索引: " << std::setprecision(1) << std::fixed
+              << impact_index.bytes() / 1048576.0 << " MB | 构建耗时: "
+              << std::setprecision(2) << build_seconds << " s" << std::endl;
+
+    // 2. 查询：2~4个词，至少一个高频词
+    std::vector<std::string> queries;
+    for (size_t q = 0; q < num_queries; ++q) {
+        std::string query = "w" + std::to_string(rng() % 20) + " ";
+        size_t extra = 1 + rng() % 3;
+        for (size_t i = 0; i < extra; ++i) {
+            query += "w" + std::to_string(zipf(vocabulary_size / 10)) + " ";
+        }
+        queries.push_back(query);
+    }
+
+    SearchEngine engine;
+    engine.setInvertedIndex(&builder.getInvertedIndex());
+    engine.setImpactIndex(&impact_index);
+    engine.setSnippetEnabled(false);
+
+    auto timeQuery = [](auto&& run) {
+        auto begin = std::chrono::steady_clock::now();
+        run();
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+    };
+
+    // 3. 基线：AND + TF-IDF逐文档打分
+    std::vector<double> samples;
+    for (const auto& query : queries) {
+        samples.push_back(timeQuery([&] { engine.search(query, top_k); }));
+    }
+    printRow("search (AND, TF-IDF)", summarize(samples), -1, -1);
+
+    // 4. 不限预算的score-at-a-time（作为重合率的参照）
+    std::vector<std::vector<SearchResult>> exact(queries.size());
+    double postings = 0;
+    samples.clear();
+    for (size_t q = 0; q < queries.size(); ++q) {
+        ImpactSearchStats stats;
+        samples.push_back(timeQuery([&] { exact[q] = engine.searchImpact(queries[q], top_k, ImpactBudget(), &stats); }));
+        postings += stats.postings_processed;
+    }
+    printRow("impact (不限预算)", summarize(samples), postings / queries.size(), 1.0);
+
+    // 5. 各种预算
+    std::vector<std::pair<std::string, ImpactBudget>> budgets;
+    for (size_t limit : {2000, 10000, 50000}) {
+        ImpactBudget budget;
+        budget.max_postings = limit;
+        budgets.emplace_back("impact (" + std::to_string(limit) + " postings)", budget);
+    }
+    for (double millis : {0.05, 0.2}) {
+        ImpactBudget budget;
+        budget.max_milliseconds = millis;
+        budgets.emplace_back("impact (" + std::to_string(static_cast<int>(millis * 1000)) + " us)", budget);
+    }
+    for (const auto& [label, budget] : budgets) {
+        samples.clear();
+        postings = 0;
+        double overlap = 0;
+        size_t exhausted = 0;
+        for (size_t q = 0; q < queries.size(); ++q) {
+            ImpactSearchStats stats;
+            std::vector<SearchResult> results;
+            samples.push_back(timeQuery([&] { results = engine.searchImpact(queries[q], top_k, budget, &stats); }));
+            postings += stats.postings_processed;
+            exhausted += stats.budget_exhausted ? 1 : 0;
+
+            std::unordered_set<int64_t> reference;
+            for (const auto& result : exact[q]) {
+                reference.insert(result.doc_id);
+            }
+            size_t common = 0;
+            for (const auto& result : results) {
+                common += reference.count(result.doc_id);
+            }
+            overlap += reference.empty() ? 1.0 : double(common) / reference.size();
+        }
+        printRow(label, summarize(samples), postings / queries.size(), overlap / queries.size());
+        std::cout << "    预算耗尽查询: " << exhausted << "/" << queries.size() << std::endl;
+    }
+    return 0;
+}
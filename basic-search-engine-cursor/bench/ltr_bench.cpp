@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "storage/index_builder.h"
+#include "query/search_engine.h"
+#include "rank/ltr_reranker.h"
+
+using namespace search_engine;
+
+namespace {
+
+struct RandomTree {
+    std::vector<int> split_feature;
+    std::vector<double> threshold;
+    std::vector<int> left;
+    std::vector<int> right;
+    std::vector<double> leaf_value;
+};
+
+/**
+ * @brief 按LightGBM的生长方式随机生成一棵树：每次把一个叶子分裂成内部节点
+ * 阈值取自真实特征值（略微偏移，避免与特征值恰好相等）
+ */
+RandomTree randomTree(size_t num_leaves, const std::vector<std::vector<double>>& samples, std::mt19937_64& rng) {
+    RandomTree tree;
+    tree.leaf_value.push_back(0.0);
+    // 每个叶子记录父节点及其在父节点中的方向
+    std::vector<std::pair<int, bool>> leaf_parent{{-1, false}};
+    while (tree.leaf_value.size() < num_leaves) {
+        const int leaf = static_cast<int>(rng() % tree.leaf_value.size());
+        const int node = static_cast<int>(tree.split_feature.size());
+        const int feature = static_cast<int>(rng() % samples.size());
+        const double value = samples[feature][rng() % samples[feature].size()];
+        tree.split_feature.push_back(feature);
+        tree.threshold.push_back(value + 1e-7 * (std::fabs(value) + 1.0));
+        auto [parent, is_left] = leaf_parent[leaf];
+        if (parent >= 0) {
+            (is_left ? tree.left : tree.right)[parent] = node;
+        }
+        const int new_leaf = static_cast<int>(tree.leaf_value.size());
+        tree.left.push_back(~leaf);
+        tree.right.push_back(~new_leaf);
+        leaf_parent[leaf] = {node, true};
+        leaf_parent.emplace_back(node, false);
+        tree.leaf_value.push_back(0.0);
+    }
+    std::normal_distribution<double> normal(0.0, 0.1);
+    for (auto& value : tree.leaf_value) {
+        value = normal(rng);
+    }
+    return tree;
+}
+
+template <typename T>
+std::string join(const std::vector<T>& values) {
+    std::ostringstream out;
+    out << std::setprecision(17);
+    for (size_t i = 0; i < values.size(); ++i) {
+        out << (i ? " " : "") << values[i];
+    }
+    return out.str();
+}
+
+std::string toLightGbm(const std::vector<RandomTree>& trees) {
+    std::ostringstream out;
+    out << "tree\nversion=v3\nnum_class=1\nnum_tree_per_iteration=1\nobjective=lambdarank\n\n";
+    for (size_t t = 0; t < trees.size(); ++t) {
+        const auto& tree = trees[t];
+        out << "Tree=" << t << "\nnum_leaves=" << tree.leaf_value.size() << "\nnum_cat=0\n"
+            << "split_feature=" << join(tree.split_feature) << "\nthreshold=" << join(tree.threshold)
+            << "\ndecision_type=" << join(std::vector<int>(tree.split_feature.size(), 2))
+            << "\nleft_child=" << join(tree.left) << "\nright_child=" << join(tree.right)
+            << "\nleaf_value=" << join(tree.leaf_value) << "\nshrinkage=0.1\n\n";
+    }
+    out << "end of trees\n";
+    return out.str();
+}
+
+// 同一批树的XGBoost dump（节点按层序编号）
+std::string toXgboost(const std::vector<RandomTree>& trees) {
+    std::ostringstream out;
+    out << std::setprecision(17);
+    for (size_t t = 0; t < trees.size(); ++t) {
+        const auto& tree = trees[t];
+        out << "booster[" << t << "]:\n";
+        if (tree.split_feature.empty()) {
+            out << "0:leaf=" << tree.leaf_value[0] << "\n";
+            continue;
+        }
+        // 广度优先分配编号，保证孩子编号大于父节点
+        std::vector<int> queue{0};
+        std::vector<int> ids{0};
+        int next_id = 1;
+        for (size_t i = 0; i < queue.size(); ++i) {
+            const int item = queue[i];
+            const int id = ids[i];
+            if (item < 0) {
+                out << id << ":leaf=" << tree.leaf_value[~item] << "\n";
+                continue;
+            }
+            const int yes = next_id++;
+            const int no = next_id++;
+            out << id << ":[f" << tree.split_feature[item] << "<" << tree.threshold[item] << "] yes=" << yes
+                << ",no=" << no << ",missing=" << yes << "\n";
+            queue.push_back(tree.left[item]);
+            ids.push_back(yes);
+            queue.push_back(tree.right[item]);
+            ids.push_back(no);
+        }
+    }
+    return out.str();
+}
+
+double elapsedUs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+/**
+ * @brief 第二阶段树模型重排序测试
+ *
+ * 用法: ltr_bench [文档数] [树数] [每棵树叶子数]
+ * 随机生成LightGBM格式的模型（阈值取自真实特征分布），在N=100/1000个候选上比较：
+ * - 特征提取（按列批量）
+ * - 批量评估（QuickScorer）与逐文档逐树遍历（打平数组）
+ * 并校验批量/逐文档/XGBoost格式三者得分一致
+ */
+int main(int argc, char* argv[]) {
+    const size_t num_docs = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t num_trees = argc > 2 ? std::stoul(argv[2]) : 500;
+    const size_t num_leaves = argc > 3 ? std::stoul(argv[3]) : 32;
+    const size_t rounds = 50;
+
+    std::mt19937_64 rng(11);
+    auto zipf = [&rng](size_t n) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return static_cast<size_t>(std::pow(static_cast<double>(n), u)) - 1;
+    };
+
+    IndexBuilder builder;
+    for (size_t d = 1; d <= num_docs; ++d) {
+        size_t length = 20 + rng() % 80;
+        std::string text;
+        for (size_t i = 0; i < length; ++i) {
+            text += "w" + std::to_string(zipf(30000)) + " ";
+        }
+        builder.addDocument(Document(static_cast<int64_t>(d), text));
+    }
+
+    SearchEngine engine;
+    engine.setInvertedIndex(&builder.getInvertedIndex());
+    engine.setForwardIndex(&builder.getForwardIndex());
+    engine.setSnippetEnabled(false);
+
+    // 高频词组合，保证每个查询至少有1000个候选
+    std::vector<std::string> queries;
+    for (size_t q = 0; q < 20; ++q) {
+        queries.push_back("w" + std::to_string(q % 3) + " w" + std::to_string(3 + q % 5));
+    }
+
+    LtrReranker reranker;
+    FeatureMatrix features;
+
+    // 用真实候选的特征值作为随机树的阈值来源
+    std::vector<std::vector<double>> samples(static_cast<size_t>(RankFeature::kCount));
+    for (const auto& query : queries) {
+        auto candidates = engine.search(query, 1000);
+        reranker.extractFeatures(candidates, Tokenizer().tokenize(query), builder.getInvertedIndex(), features);
+        for (size_t f = 0; f < samples.size(); ++f) {
+            samples[f].insert(samples[f].end(), features.column(f), features.column(f) + features.rows());
+        }
+    }
+    std::vector<RandomTree> trees;
+    for (size_t t = 0; t < num_trees; ++t) {
+        trees.push_back(randomTree(num_leaves, samples, rng));
+    }
+    if (!reranker.loadFromString(toLightGbm(trees))) {
+        std::cerr << "模型加载失败: " << reranker.lastError() << std::endl;
+        return 1;
+    }
+    TreeEnsemble xgboost;
+    if (!xgboost.loadFromString(toXgboost(trees))) {
+        std::cerr << "XGBoost模型加载失败: " << xgboost.lastError() << std::endl;
+        return 1;
+    }
+
+    std::cout << "文档数: " << num_docs << " | 树: " << reranker.model().getTreeCount()
+              << " | 节点: " << reranker.model().getNodeCount()
+              << " | 叶子: " << reranker.model().getLeafCount() << std::endl;
+
+    for (size_t n : {100, 1000}) {
+        double extract_us = 0.0, batch_us = 0.0, scalar_us = 0.0, search_us = 0.0, rerank_search_us = 0.0;
+        double max_diff = 0.0;
+        size_t samples_taken = 0;
+        std::vector<double> batch_scores, xgboost_scores, row(static_cast<size_t>(RankFeature::kCount));
+
+        engine.setReranker(nullptr);
+        for (size_t r = 0; r < rounds; ++r) {
+            const auto& query = queries[r % queries.size()];
+            const auto terms = Tokenizer().tokenize(query);
+            auto candidates = engine.search(query, n);
+
+            auto start = std::chrono::steady_clock::now();
+            reranker.extractFeatures(candidates, terms, builder.getInvertedIndex(), features);
+            extract_us += elapsedUs(start);
+
+            start = std::chrono::steady_clock::now();
+            reranker.model().predict(features, batch_scores);
+            batch_us += elapsedUs(start);
+
+            // 逐文档：先转成行式，再逐棵树遍历
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < features.rows(); ++i) {
+                for (size_t f = 0; f < row.size(); ++f) {
+                    row[f] = features.get(i, f);
+                }
+                const double score = reranker.model().predictOne(row.data());
+                max_diff = std::max(max_diff, std::fabs(score - batch_scores[i]));
+            }
+            scalar_us += elapsedUs(start);
+
+            xgboost.predict(features, xgboost_scores);
+            for (size_t i = 0; i < features.rows(); ++i) {
+                max_diff = std::max(max_diff, std::fabs(xgboost_scores[i] - batch_scores[i]));
+            }
+            samples_taken += features.rows();
+        }
+
+        // 端到端：第一阶段top-N + 重排序取top-10
+        for (size_t r = 0; r < rounds; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            engine.search(queries[r % queries.size()], 10);
+            search_us += elapsedUs(start);
+        }
+        RerankOptions options;
+        options.depth = n;
+        auto model = std::make_unique<LtrReranker>(options);
+        model->loadFromString(toLightGbm(trees));
+        engine.setReranker(std::move(model));
+        for (size_t r = 0; r < rounds; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            engine.search(queries[r % queries.size()], 10);
+            rerank_search_us += elapsedUs(start);
+        }
+
+        std::cout << "\nN=" << n << "（平均候选 " << samples_taken / rounds << "）" << std::fixed
+                  << std::setprecision(1) << std::endl;
+        std::cout << "  特征提取         " << std::setw(9) << extract_us / rounds << " us" << std::endl;
+        std::cout << "  QuickScorer      " << std::setw(9) << batch_us / rounds << " us" << std::endl;
+        std::cout << "  逐层遍历         " << std::setw(9) << scalar_us / rounds << " us" << std::endl;
+        std::cout << "  查询（无重排序） " << std::setw(9) << search_us / rounds << " us" << std::endl;
+        std::cout << "  查询（重排序）   " << std::setw(9) << rerank_search_us / rounds << " us" << std::endl;
+        std::cout << "  得分最大差异     " << std::scientific << std::setprecision(2) << max_diff << std::endl;
+    }
+    return 0;
+}
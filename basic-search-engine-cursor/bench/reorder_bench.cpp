@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "storage/index_builder.h"
+#include "query/search_engine.h"
+
+using namespace search_engine;
+
+namespace {
+
+struct Corpus {
+    std::vector<std::string> texts;
+    std::vector<std::vector<std::string>> queries;
+};
+
+/**
+ * @brief 生成按主题聚类的合成语料：文档按随机主题依次生成，相似文档在ID空间中分散
+ */
+Corpus generateCorpus(size_t num_docs, size_t num_queries) {
+    std::mt19937_64 rng(7);
+    const size_t vocabulary_size = 50000;
+    const size_t num_topics = 500;
+    const size_t topic_words = 200;
+
+    std::vector<std::vector<size_t>> topics(num_topics);
+    for (auto& topic : topics) {
+        for (size_t i = 0; i < topic_words; ++i) {
+            topic.push_back(rng() % vocabulary_size);
+        }
+    }
+    // 近似Zipf：对均匀随机数取平方，偏向小编号
+    auto skewed = [&rng](size_t n) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return static_cast<size_t>(u * u * n);
+    };
+
+    Corpus corpus;
+    corpus.texts.reserve(num_docs);
+    for (size_t d = 0; d < num_docs; ++d) {
+        const auto& topic = topics[rng() % num_topics];
+        size_t length = 40 + rng() % 80;
+        std::string text;
+        for (size_t i = 0; i < length; ++i) {
+            size_t word = (rng() % 10 < 7) ? topic[skewed(topic.size())] : skewed(vocabulary_size);
+            text += 'w';
+            text += std::to_string(word);
+            text += ' ';
+        }
+        corpus.texts.push_back(std::move(text));
+    }
+
+    for (size_t q = 0; q < num_queries; ++q) {
+        const auto& topic = topics[rng() % num_topics];
+        std::vector<std::string> terms;
+        size_t count = 2 + rng() % 2;
+        for (size_t i = 0; i < count; ++i) {
+            terms.push_back("w" + std::to_string(topic[skewed(topic.size() / 4)]));
+        }
+        corpus.queries.push_back(std::move(terms));
+    }
+    return corpus;
+}
+
+void buildIndex(IndexBuilder& builder, const Corpus& corpus) {
+    const Tokenizer& tokenizer = builder.getTokenizer();
+    std::vector<std::pair<std::string, int32_t>> term_freqs;
+    for (size_t i = 0; i < corpus.texts.size(); ++i) {
+        auto tokens = tokenizer.tokenize(corpus.texts[i]);
+        std::sort(tokens.begin(), tokens.end());
+        term_freqs.clear();
+        for (auto& token : tokens) {
+            if (!term_freqs.empty() && term_freqs.back().first == token) {
+                term_freqs.back().second++;
+            } else {
+                term_freqs.emplace_back(std::move(token), 1);
+            }
+        }
+        builder.addTokenizedDocument(Document(static_cast<int64_t>(i + 1), corpus.texts[i]), term_freqs);
+    }
+}
+
+// 有序posting列表的归并求交（从最短的列表开始）
+size_t intersect(const InvertedIndex& index, const std::vector<std::string>& terms,
+                 std::vector<int64_t>& result, std::vector<int64_t>& buffer) {
+    std::vector<const std::vector<Posting>*> lists;
+    for (const auto& term : terms) {
+        const auto* postings = index.getPostings(term);
+        if (!postings) {
+            return 0;
+        }
+        lists.push_back(postings);
+    }
+    std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+
+    result.clear();
+    for (const auto& posting : *lists[0]) {
+        result.push_back(posting.doc_id);
+    }
+    for (size_t l = 1; l < lists.size() && !result.empty(); ++l) {
+        buffer.clear();
+        const auto& list = *lists[l];
+        size_t j = 0;
+        for (int64_t doc_id : result) {
+            while (j < list.size() && list[j].doc_id < doc_id) {
+                ++j;
+            }
+            if (j == list.size()) {
+                break;
+            }
+            if (list[j].doc_id == doc_id) {
+                buffer.push_back(doc_id);
+            }
+        }
+        result.swap(buffer);
+    }
+    return result.size();
+}
+
+void report(const std::string& label, IndexBuilder& builder, const Corpus& corpus, size_t rounds) {
+    InvertedIndex& index = builder.getInvertedIndex();
+    const size_t postings = index.getPostingCount();
+    const size_t bytes = index.getEncodedPostingBytes();
+
+    std::vector<int64_t> result, buffer;
+    size_t matches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        for (const auto& terms : corpus.queries) {
+            matches += intersect(index, terms, result, buffer);
+        }
+    }
+    double intersect_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count() / (rounds * corpus.queries.size());
+
+    SearchEngine engine;
+    engine.setInvertedIndex(&index);
+    engine.setSnippetEnabled(false);
+    std::vector<std::string> queries;
+    for (const auto& terms : corpus.queries) {
+        std::string query;
+        for (const auto& term : terms) {
+            query += term + " ";
+        }
+        queries.push_back(query);
+    }
+    size_t hits = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& query : queries) {
+        hits += engine.search(query, 10).size();
+    }
+    double search_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count() / queries.size();
+
+    std::cout << std::left << std::setw(12) << label << std::right << std::fixed
+              << " | posting: " << std::setprecision(2) << bytes / 1048576.0 << " MB ("
+              << std::setprecision(2) << 8.0 * bytes / postings << " bits/posting)"
+              << " | 求交: " << std::setprecision(1) << intersect_us << " us"
+              << " | 查询: " << std::setprecision(1) << search_us << " us"
+              << " | 命中: " << matches / rounds << "/" << hits << std::endl;
+}
+
+} // namespace
+
+/**
+ * @brief 文档重排序效果测试
+ *
+ * 用法: reorder_bench [文档数] [查询数] [线程数]
+ * 在按主题聚类、但ID随机分散的合成语料上比较：原始顺序 / MinHash / 图二分
+ * 输出doc_id差值Varint编码后的posting字节数，以及求交和完整查询的平均延迟
+ */
+int main(int argc, char* argv[]) {
+    const size_t num_docs = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t num_queries = argc > 2 ? std::stoul(argv[2]) : 2000;
+    const size_t num_threads = argc > 3 ? std::stoul(argv[3]) : 0;
+    const size_t rounds = 20;
+
+    Corpus corpus = generateCorpus(num_docs, num_queries);
+    std::cout << "文档数: " << num_docs << " | 查询数: " << num_queries << std::endl;
+
+    const std::pair<std::string, ReorderMethod> methods[] = {
+        {"minhash", ReorderMethod::kMinHash},
+        {"bisection", ReorderMethod::kGraphBisection},
+    };
+    bool baseline_reported = false;
+    for (const auto& [label, method] : methods) {
+        IndexBuilder builder;
+        buildIndex(builder, corpus);
+        if (!baseline_reported) {
+            report("original", builder, corpus, rounds);
+            baseline_reported = true;
+        }
+
+        ReorderOptions options;
+        options.method = method;
+        options.num_threads = num_threads;
+        ReorderStats stats = builder.reorderDocuments(options);
+        std::cout << "  " << label << " 重排耗时: " << std::setprecision(2) << stats.elapsed_seconds
+                  << " s | " << std::setprecision(2) << stats.bitsPerPostingBefore() << " -> "
+                  << stats.bitsPerPostingAfter() << " bits/posting" << std::endl;
+        report(label, builder, corpus, rounds);
+    }
+    return 0;
+}
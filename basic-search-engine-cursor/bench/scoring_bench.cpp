@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "storage/index_builder.h"
+#include "query/search_engine.h"
+#include "rank/score_kernel.h"
+
+using namespace search_engine;
+
+namespace {
+
+/**
+ * @brief 转发给内置排序器但声明为自定义公式，强制走逐文档虚函数调用（对照组）
+ */
+class VirtualOnlyScorer : public Scorer {
+public:
+    explicit VirtualOnlyScorer(std::unique_ptr<Scorer> inner) : inner_(std::move(inner)) {}
+
+    double score(int64_t doc_id, const std::vector<std::string>& query_terms,
+                 const InvertedIndex& inverted_index) const override {
+        return inner_->score(doc_id, query_terms, inverted_index);
+    }
+
+private:
+    std::unique_ptr<Scorer> inner_;
+};
+
+std::unique_ptr<Scorer> makeScorer(ScoringModel model) {
+    switch (model) {
+        case ScoringModel::kBm25:
+            return std::make_unique<Bm25Scorer>();
+        case ScoringModel::kSimple:
+            return std::make_unique<SimpleScorer>();
+        default:
+            return std::make_unique<TfIdfScorer>();
+    }
+}
+
+double elapsedUs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+/**
+ * @brief 批量打分内核测试
+ *
+ * 用法: scoring_bench [文档数] [每组查询数]
+ * 对TF-IDF / BM25 / 简单计数三种公式、1~6个查询词，在同一批候选文档（第一个词的posting列表）上比较：
+ * - 逐文档调用虚函数Scorer::score()
+ * - ScoreKernel按块批量打分
+ * 并校验两者得分逐位一致；最后比较端到端search()（AND查询）的耗时
+ */
+int main(int argc, char* argv[]) {
+    const size_t num_docs = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const size_t num_queries = argc > 2 ? std::stoul(argv[2]) : 20;
+
+    std::mt19937_64 rng(5);
+    auto zipf = [&rng](size_t n) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return static_cast<size_t>(std::pow(static_cast<double>(n), u)) - 1;
+    };
+
+    IndexBuilder builder;
+    for (size_t d = 1; d <= num_docs; ++d) {
+        size_t length = 30 + rng() % 60;
+        std::string text;
+        for (size_t i = 0; i < length; ++i) {
+            text += 'w';
+            text += std::to_string(zipf(50000));
+            text += ' ';
+        }
+        builder.addDocument(Document(static_cast<int64_t>(d), text));
+    }
+    InvertedIndex& index = builder.getInvertedIndex();
+
+    std::cout << "文档数: " << num_docs << " | 平均文档长度: " << std::fixed << std::setprecision(1)
+              << index.getAverageDocLength() << std::endl;
+
+    const std::pair<const char*, ScoringModel> models[] = {
+        {"TF-IDF", ScoringModel::kTfIdf},
+        {"BM25  ", ScoringModel::kBm25},
+        {"简单  ", ScoringModel::kSimple},
+    };
+
+    std::cout << "\n候选打分（每个查询的平均耗时，候选为第一个词的全部文档）" << std::endl;
+    std::cout << "公式    词数   候选数    虚函数(us)   内核(us)   加速比   最大差异" << std::endl;
+    for (const auto& [label, model] : models) {
+        auto scorer = makeScorer(model);
+        for (size_t terms = 1; terms <= 6; ++terms) {
+            // 第一个词取高频词保证候选足够多，其余词在中频范围内随机
+            std::vector<std::vector<std::string>> queries;
+            for (size_t q = 0; q < num_queries; ++q) {
+                std::vector<std::string> query{"w" + std::to_string(q % 5)};
+                for (size_t t = 1; t < terms; ++t) {
+                    query.push_back("w" + std::to_string(rng() % 100));
+                }
+                queries.push_back(std::move(query));
+            }
+
+            double virtual_us = 0.0, kernel_us = 0.0, max_diff = 0.0;
+            size_t candidates = 0;
+            std::vector<double> expected, actual;
+            ScoreKernel kernel;
+            for (const auto& query : queries) {
+                std::vector<int64_t> doc_ids;
+                for (const auto& posting : *index.getPostings(query[0])) {
+                    doc_ids.push_back(posting.doc_id);
+                }
+                candidates += doc_ids.size();
+                expected.resize(doc_ids.size());
+                actual.resize(doc_ids.size());
+
+                auto start = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < doc_ids.size(); ++i) {
+                    expected[i] = scorer->score(doc_ids[i], query, index);
+                }
+                virtual_us += elapsedUs(start);
+
+                start = std::chrono::steady_clock::now();
+                kernel.prepare(*scorer, query, index);
+                kernel.score(doc_ids.data(), doc_ids.size(), actual.data());
+                kernel_us += elapsedUs(start);
+
+                for (size_t i = 0; i < doc_ids.size(); ++i) {
+                    max_diff = std::max(max_diff, std::fabs(expected[i] - actual[i]));
+                }
+            }
+            std::cout << label << "  " << std::setw(4) << terms << std::setw(9) << candidates / num_queries
+                      << std::fixed << std::setprecision(1) << std::setw(13) << virtual_us / num_queries
+                      << std::setw(11) << kernel_us / num_queries << std::setw(8) << std::setprecision(2)
+                      << virtual_us / std::max(kernel_us, 1e-9) << "x" << std::scientific << std::setprecision(1)
+                      << std::setw(11) << max_diff << std::fixed << std::endl;
+        }
+    }
+
+    // 端到端：AND查询的全部匹配文档都要打分，取top-10
+    std::vector<std::string> queries;
+    for (size_t q = 0; q < 100; ++q) {
+        queries.push_back("w" + std::to_string(q % 3) + " w" + std::to_string(3 + q % 7));
+    }
+    std::cout << "\n端到端search()（2词AND查询，top-10）" << std::endl;
+    for (const auto& [label, model] : models) {
+        SearchEngine kernel_engine;
+        kernel_engine.setInvertedIndex(&index);
+        kernel_engine.setSnippetEnabled(false);
+        kernel_engine.setScorer(makeScorer(model));
+        SearchEngine virtual_engine;
+        virtual_engine.setInvertedIndex(&index);
+        virtual_engine.setSnippetEnabled(false);
+        virtual_engine.setScorer(std::make_unique<VirtualOnlyScorer>(makeScorer(model)));
+
+        double kernel_us = 0.0, virtual_us = 0.0;
+        bool same = true;
+        for (const auto& query : queries) {
+            auto start = std::chrono::steady_clock::now();
+            auto expected = virtual_engine.search(query, 10);
+            virtual_us += elapsedUs(start);
+            start = std::chrono::steady_clock::now();
+            auto actual = kernel_engine.search(query, 10);
+            kernel_us += elapsedUs(start);
+            same = same && expected.size() == actual.size() &&
+                   std::equal(expected.begin(), expected.end(), actual.begin(),
+                              [](const SearchResult& a, const SearchResult& b) {
+                                  return a.doc_id == b.doc_id && a.score == b.score;
+                              });
+        }
+        std::cout << "  " << label << "  虚函数 " << std::setprecision(1) << std::setw(8) << virtual_us / queries.size()
+                  << " us  内核 " << std::setw(8) << kernel_us / queries.size() << " us  结果"
+                  << (same ? "一致" : "不一致") << std::endl;
+    }
+    return 0;
+}
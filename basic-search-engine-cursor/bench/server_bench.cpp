@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+#include "server/index_snapshot.h"
+#include "server/query_server.h"
+
+using namespace search_engine;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct ClientResult {
+    std::vector<double> latencies_us;
+    std::map<uint64_t, size_t> per_snapshot;
+    std::map<int, size_t> per_status;
+    bool failed = false;
+};
+
+std::unique_ptr<IndexBuilder> buildCorpus(size_t num_docs, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    auto zipf = [&rng](size_t n) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return static_cast<size_t>(std::pow(static_cast<double>(n), u)) - 1;
+    };
+    auto builder = std::make_unique<IndexBuilder>();
+    for (size_t d = 1; d <= num_docs; ++d) {
+        size_t length = 20 + rng() % 60;
+        std::string text;
+        for (size_t i = 0; i < length; ++i) {
+            text += 'w';
+            text += std::to_string(zipf(30000));
+            text += ' ';
+        }
+        builder->addDocument(Document(static_cast<int64_t>(d), text));
+    }
+    return builder;
+}
+
+/**
+ * @brief 单个连接：保持depth个请求在途，收到一个响应就补发一个，直到截止时间
+ */
+void runClient(const std::string& host, uint16_t port, size_t depth, Clock::time_point deadline,
+               const std::vector<std::string>& queries, uint64_t seed, ClientResult& result) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, host.c_str(), &address.sin_addr);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        result.failed = true;
+        if (fd >= 0) {
+            close(fd);
+        }
+        return;
+    }
+    int nodelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+    std::mt19937_64 rng(seed);
+    std::unordered_map<uint32_t, Clock::time_point> sent_at;
+    uint32_t next_id = 0;
+    std::string output;
+    auto send = [&](size_t count) {
+        output.clear();
+        for (size_t i = 0; i < count; ++i) {
+            QueryRequest request;
+            request.request_id = next_id++;
+            request.top_k = 10;
+            request.query = queries[rng() % queries.size()];
+            encodeRequest(request, output);
+            sent_at[request.request_id] = Clock::now();
+        }
+        return ::send(fd, output.data(), output.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(output.size());
+    };
+
+    std::string input;
+    char buffer[64 * 1024];
+    bool ok = send(depth);
+    while (ok && !sent_at.empty()) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            ok = false;
+            break;
+        }
+        input.append(buffer, static_cast<size_t>(n));
+        size_t offset = 0;
+        size_t completed = 0;
+        QueryResponse response;
+        size_t consumed = 0;
+        while (decodeResponse(input.data() + offset, input.size() - offset, response, consumed) ==
+               FrameStatus::kComplete) {
+            offset += consumed;
+            auto it = sent_at.find(response.request_id);
+            if (it != sent_at.end()) {
+                result.latencies_us.push_back(
+                    std::chrono::duration<double, std::micro>(Clock::now() - it->second).count());
+                sent_at.erase(it);
+            }
+            result.per_snapshot[response.snapshot_version]++;
+            result.per_status[static_cast<int>(response.status)]++;
+            completed++;
+        }
+        input.erase(0, offset);
+        if (completed > 0 && Clock::now() < deadline) {
+            ok = send(completed);
+        }
+    }
+    result.failed = !ok;
+    close(fd);
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+} // namespace
+
+/**
+ * @brief 查询服务压测（本机回环）
+ *
+ * 用法: server_bench [文档数] [连接数] [每连接在途请求数] [秒数] [host:port]
+ * 不指定host:port时在进程内启动QueryServer（合成语料），压测进行到一半时发布第二份快照，
+ * 验证在线切换索引不影响请求；指定时压测已经运行的search_server。
+ * 报告QPS、延迟分位数，以及各快照版本处理的请求数
+ */
+int main(int argc, char* argv[]) {
+    const size_t num_docs = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t num_connections = argc > 2 ? std::stoul(argv[2]) : 8;
+    const size_t depth = argc > 3 ? std::stoul(argv[3]) : 16;
+    const double seconds = argc > 4 ? std::stod(argv[4]) : 5.0;
+    std::string host = "127.0.0.1";
+    uint16_t port = 0;
+
+    // 高频词组合的查询，词从热门词中抽取
+    std::mt19937_64 rng(23);
+    std::vector<std::string> queries;
+    for (size_t q = 0; q < 1000; ++q) {
+        queries.push_back("w" + std::to_string(rng() % 50) + " w" + std::to_string(rng() % 500));
+    }
+
+    SnapshotHolder snapshots;
+    std::unique_ptr<QueryServer> server;
+    std::shared_ptr<const IndexSnapshot> next_snapshot;
+    if (argc > 5) {
+        std::string target = argv[5];
+        size_t colon = target.rfind(':');
+        host = target.substr(0, colon);
+        port = static_cast<uint16_t>(std::stoul(target.substr(colon + 1)));
+    } else {
+        snapshots.publish(std::make_shared<IndexSnapshot>(buildCorpus(num_docs, 1), 1));
+        next_snapshot = std::make_shared<IndexSnapshot>(buildCorpus(num_docs, 2), 2);
+        ServerOptions options;
+        options.worker_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        server = std::make_unique<QueryServer>(snapshots, options);
+        if (!server->start()) {
+            std::cerr << "服务启动失败: " << server->lastError() << std::endl;
+            return 1;
+        }
+        port = server->port();
+        std::cout << "进程内服务 " << host << ":" << port << " | 文档数: " << num_docs << " | 查询线程: "
+                  << options.worker_threads << std::endl;
+    }
+    std::cout << "连接数: " << num_connections << " | 每连接在途: " << depth << " | 时长: " << seconds << "s"
+              << std::endl;
+
+    const auto start = Clock::now();
+    const auto deadline = start + std::chrono::microseconds(static_cast<int64_t>(seconds * 1e6));
+    std::vector<ClientResult> results(num_connections);
+    std::vector<std::thread> clients;
+    for (size_t c = 0; c < num_connections; ++c) {
+        clients.emplace_back(runClient, host, port, depth, deadline, std::cref(queries), 100 + c,
+                             std::ref(results[c]));
+    }
+    if (next_snapshot) {
+        std::this_thread::sleep_until(start + (deadline - start) / 2);
+        snapshots.publish(std::move(next_snapshot));
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> latencies;
+    std::map<uint64_t, size_t> per_snapshot;
+    std::map<int, size_t> per_status;
+    size_t failed = 0;
+    for (const auto& result : results) {
+        latencies.insert(latencies.end(), result.latencies_us.begin(), result.latencies_us.end());
+        for (const auto& [version, count] : result.per_snapshot) {
+            per_snapshot[version] += count;
+        }
+        for (const auto& [status, count] : result.per_status) {
+            per_status[status] += count;
+        }
+        failed += result.failed ? 1 : 0;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\n请求数: " << latencies.size() << " | QPS: " << latencies.size() / elapsed << std::endl;
+    std::cout << "延迟(us)  p50 " << percentile(latencies, 0.50) << " | p90 " << percentile(latencies, 0.90)
+              << " | p99 " << percentile(latencies, 0.99) << " | p99.9 " << percentile(latencies, 0.999)
+              << " | max " << (latencies.empty() ? 0.0 : latencies.back()) << std::endl;
+    std::cout << "按快照版本:";
+    for (const auto& [version, count] : per_snapshot) {
+        std::cout << " v" << version << "=" << count;
+    }
+    std::cout << "\n按状态:";
+    for (const auto& [status, count] : per_status) {
+        std::cout << " " << status << "=" << count;
+    }
+    std::cout << "\n连接失败: " << failed << std::endl;
+
+    if (server) {
+        server->stop();
+    }
+    return 0;
+}
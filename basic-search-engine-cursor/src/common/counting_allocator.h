@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace search_engine {
+
+/**
+ * @brief 分配计数（当前字节数、当前分配次数、峰值字节数）
+ *
+ * 与所属容器一样不是线程安全的：索引只有一个写入者，查询侧只读不分配
+ */
+struct AllocationCounter {
+    uint64_t bytes = 0;
+    uint64_t allocations = 0;
+    uint64_t peak_bytes = 0;
+};
+
+/**
+ * @brief 计数分配器
+ *
+ * 把分配转交给std::allocator，同时记录到一个计数器中。用于哈希表这类看不到内部分配
+ * （节点、桶数组）的容器；vector/string的堆内存可以由capacity()精确算出，不需要它。
+ *
+ * 设计思路：
+ * - 计数器由分配器以shared_ptr持有，容器rebind出的节点/桶分配器共用同一个计数器，
+ *   移动和交换时随内存一起转移（propagate_on_container_move_assignment/swap）
+ * - 拷贝构造的容器使用新的计数器（select_on_container_copy_construction），
+ *   不会把副本的分配算到原容器上
+ * - 所有实例互相相等：内存都来自std::allocator，可以由任意实例释放
+ */
+template <typename T>
+class CountingAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    CountingAllocator() : counter_(std::make_shared<AllocationCounter>()) {}
+
+    // 只声明拷贝：移动后的分配器必须仍然可用（被移动的容器还会继续分配）
+    CountingAllocator(const CountingAllocator&) noexcept = default;
+    CountingAllocator& operator=(const CountingAllocator&) noexcept = default;
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) noexcept : counter_(other.counter_) {}
+
+    T* allocate(size_t n) {
+        T* p = std::allocator<T>().allocate(n);
+        counter_->bytes += n * sizeof(T);
+        counter_->allocations++;
+        if (counter_->bytes > counter_->peak_bytes) {
+            counter_->peak_bytes = counter_->bytes;
+        }
+        return p;
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        counter_->bytes -= n * sizeof(T);
+        counter_->allocations--;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    CountingAllocator select_on_container_copy_construction() const { return CountingAllocator(); }
+
+    const AllocationCounter& counter() const { return *counter_; }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const noexcept { return false; }
+
+private:
+    template <typename U>
+    friend class CountingAllocator;
+
+    std::shared_ptr<AllocationCounter> counter_;
+};
+
+/**
+ * @brief 记录节点和桶数组分配的哈希表
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+using CountedHashMap =
+    std::unordered_map<Key, Value, Hash, std::equal_to<Key>, CountingAllocator<std::pair<const Key, Value>>>;
+
+namespace memory {
+
+/**
+ * @brief 字符串在堆上占用的字节数（短字符串存放在对象内部时为0）
+ */
+inline size_t heapBytes(const std::string& s) {
+    const auto object = reinterpret_cast<uintptr_t>(&s);
+    const auto data = reinterpret_cast<uintptr_t>(s.data());
+    const bool is_inline = data >= object && data < object + sizeof(std::string);
+    return is_inline ? 0 : s.capacity() + 1;
+}
+
+/**
+ * @brief vector缓冲区占用的字节数（按capacity计，不含元素自身的堆内存）
+ */
+template <typename T, typename Alloc>
+size_t heapBytes(const std::vector<T, Alloc>& v) {
+    return v.capacity() * sizeof(T);
+}
+
+} // namespace memory
+
+} // namespace search_engine
@@ -0,0 +1,65 @@
+#include "common/crc32c.h"
+#include <cstring>
+
+namespace search_engine {
+namespace crc32c {
+
+namespace {
+
+const uint32_t kPolynomial = 0x82F63B78;  // 反射形式
+
+struct Tables {
+    uint32_t table[8][256];
+
+    Tables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ ((crc & 1) ? kPolynomial : 0);
+            }
+            table[0][i] = crc;
+        }
+        // table[k][i]：字节i后面再跟k个0字节的CRC，用于一次处理8个字节
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int k = 1; k < 8; ++k) {
+                table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+const Tables& tables() {
+    static const Tables instance;
+    return instance;
+}
+
+} // namespace
+
+uint32_t extend(uint32_t crc, const void* data, size_t size) {
+    const auto& t = tables().table;
+    const auto* p = static_cast<const unsigned char*>(data);
+    uint32_t c = ~crc;
+
+    while (size >= 8) {
+        uint32_t low;
+        uint32_t high;
+        std::memcpy(&low, p, 4);
+        std::memcpy(&high, p + 4, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        low = __builtin_bswap32(low);
+        high = __builtin_bswap32(high);
+#endif
+        low ^= c;
+        c = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+            t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        c = (c >> 8) ^ t[0][(c ^ *p++) & 0xFF];
+    }
+    return ~c;
+}
+
+} // namespace crc32c
+} // namespace search_engine
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace search_engine {
+
+/**
+ * @brief CRC32C（Castagnoli多项式）校验
+ *
+ * 用于预写日志等持久化数据的完整性校验。
+ * 软件实现（slicing-by-8查表，每次处理8个字节），不依赖SSE4.2指令
+ */
+namespace crc32c {
+
+/**
+ * @brief 在已有校验值上继续计算（可分段调用）
+ * @param crc 之前的结果（首段传0）
+ * @param data 数据
+ * @param size 字节数
+ * @return 新的校验值
+ */
+uint32_t extend(uint32_t crc, const void* data, size_t size);
+
+inline uint32_t value(const void* data, size_t size) {
+    return extend(0, data, size);
+}
+
+} // namespace crc32c
+
+} // namespace search_engine
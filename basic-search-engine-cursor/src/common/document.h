@@ -3,9 +3,22 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <utility>
 
 namespace search_engine {
 
+/**
+ * @brief 文本区间 [begin, end)，以字节为单位
+ * 用于记录token在原文中的位置、摘要中的高亮位置
+ */
+struct TextSpan {
+    uint32_t begin;
+    uint32_t end;
+    
+    TextSpan() : begin(0), end(0) {}
+    TextSpan(uint32_t b, uint32_t e) : begin(b), end(e) {}
+};
+
 /**
  * @brief 文档结构体
  * 存储文档的基本信息：ID、内容、元数据
@@ -15,10 +28,11 @@ struct Document {
     std::string content;          // 文档内容
     std::string title;            // 文档标题（可选）
     std::vector<std::string> tokens;  // 分词后的token列表
+    std::vector<TextSpan> token_offsets;  // 每个token在content中的位置（与tokens一一对应）
     
     Document() : doc_id(-1) {}
-    Document(int64_t id, const std::string& text) 
-        : doc_id(id), content(text) {}
+    Document(int64_t id, std::string text) 
+        : doc_id(id), content(std::move(text)) {}
 };
 
 } // namespace search_engine
@@ -0,0 +1,77 @@
+#include "common/line_scanner.h"
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace search_engine {
+namespace scan {
+
+const char* findByte(const char* begin, const char* end, char c) {
+    const char* p = begin;
+
+#if defined(__AVX2__)
+    const __m256i needle = _mm256_set1_epi8(c);
+    while (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned mask = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+#endif
+
+#if defined(__SSE2__)
+    const __m128i needle16 = _mm_set1_epi8(c);
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle16)));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+#endif
+
+    if (p >= end) {
+        return end;
+    }
+    const void* hit = std::memchr(p, static_cast<unsigned char>(c), static_cast<size_t>(end - p));
+    return hit ? static_cast<const char*>(hit) : end;
+}
+
+void splitFields(std::string_view line, char delimiter, std::vector<std::string_view>& fields) {
+    fields.clear();
+    const char* p = line.data();
+    const char* end = p + line.size();
+    while (true) {
+        const char* hit = findByte(p, end, delimiter);
+        fields.emplace_back(p, static_cast<size_t>(hit - p));
+        if (hit == end) {
+            break;
+        }
+        p = hit + 1;
+    }
+}
+
+} // namespace scan
+
+bool LineScanner::next(std::string_view& line) {
+    if (pos_ >= end_) {
+        return false;
+    }
+    const char* nl = scan::findByte(pos_, end_, '\n');
+    const char* line_end = nl;
+    if (line_end > pos_ && *(line_end - 1) == '\r') {
+        --line_end;
+    }
+    line = std::string_view(pos_, static_cast<size_t>(line_end - pos_));
+    pos_ = (nl == end_) ? end_ : nl + 1;
+    return true;
+}
+
+} // namespace search_engine
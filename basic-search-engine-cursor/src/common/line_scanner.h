@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+namespace search_engine {
+
+/**
+ * @brief 字节扫描工具
+ *
+ * 在大块缓冲区中快速定位分隔符（换行、制表符）：
+ * - x86平台使用SSE2/AVX2一次比较16/32字节
+ * - 其他平台回退到memchr
+ */
+namespace scan {
+
+/**
+ * @brief 查找第一个等于c的字节
+ * @param begin 起始位置
+ * @param end 结束位置
+ * @param c 目标字节
+ * @return 指向该字节的指针，未找到返回end
+ */
+const char* findByte(const char* begin, const char* end, char c);
+
+/**
+ * @brief 按分隔符切分字段（不拷贝，返回原缓冲区上的视图）
+ * @param line 一行数据（不含换行符）
+ * @param delimiter 分隔符
+ * @param fields 输出字段列表（会先清空）
+ */
+void splitFields(std::string_view line, char delimiter, std::vector<std::string_view>& fields);
+
+} // namespace scan
+
+/**
+ * @brief 行扫描器
+ *
+ * 在一段内存上逐行迭代，返回不含"\n"（以及行尾"\r"）的视图
+ */
+class LineScanner {
+public:
+    LineScanner(const char* data, size_t size)
+        : begin_(data), pos_(data), end_(data + size) {}
+
+    /**
+     * @brief 读取下一行
+     * @param line 输出行视图
+     * @return 没有更多数据时返回false
+     */
+    bool next(std::string_view& line);
+
+    /**
+     * @brief 已消费的字节数
+     */
+    size_t offset() const { return static_cast<size_t>(pos_ - begin_); }
+
+private:
+    const char* begin_;
+    const char* pos_;
+    const char* end_;
+};
+
+} // namespace search_engine
@@ -0,0 +1,96 @@
+#include "common/mapped_file.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace search_engine {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : fd_(other.fd_), data_(other.data_), size_(other.size_), error_(std::move(other.error_)) {
+    other.fd_ = -1;
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd_ = other.fd_;
+        data_ = other.data_;
+        size_ = other.size_;
+        error_ = std::move(other.error_);
+        other.fd_ = -1;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& filepath) {
+    close();
+    error_.clear();
+
+    fd_ = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        error_ = "open " + filepath + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        error_ = "fstat " + filepath + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0) {
+        // 空文件：mmap长度不能为0，直接返回空视图
+        return true;
+    }
+
+    void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (addr == MAP_FAILED) {
+        error_ = "mmap " + filepath + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+    data_ = static_cast<const char*>(addr);
+    ::madvise(addr, size_, MADV_SEQUENTIAL);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+}
+
+void MappedFile::release(size_t offset, size_t length) {
+    if (data_ == nullptr || offset >= size_) {
+        return;
+    }
+    // madvise要求起始地址按页对齐，向上取整到页边界，只释放完整的页
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t begin = (offset + page - 1) / page * page;
+    size_t end = offset + length < size_ ? offset + length : size_;
+    end = end / page * page;
+    if (end > begin) {
+        ::madvise(const_cast<char*>(data_) + begin, end - begin, MADV_DONTNEED);
+    }
+}
+
+} // namespace search_engine
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace search_engine {
+
+/**
+ * @brief 只读内存映射文件（RAII）
+ *
+ * 用于大文件的零拷贝读取：
+ * - 通过mmap映射整个文件，避免ifstream -> ostringstream -> string的多次拷贝
+ * - 顺序访问时提示内核预读（MADV_SEQUENTIAL）
+ * - 空文件可以正常打开，size()为0，与打开失败区分
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief 映射文件
+     * @param filepath 文件路径
+     * @return 是否成功（失败原因见lastError()）
+     */
+    bool open(const std::string& filepath);
+
+    /**
+     * @brief 解除映射并关闭文件
+     */
+    void close();
+
+    /**
+     * @brief 释放[offset, offset+length)范围内已处理的页面（MADV_DONTNEED）
+     * 流式处理超大文件时用于控制常驻内存
+     */
+    void release(size_t offset, size_t length);
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool isOpen() const { return fd_ >= 0; }
+    const std::string& lastError() const { return error_; }
+
+private:
+    int fd_ = -1;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    std::string error_;
+};
+
+} // namespace search_engine
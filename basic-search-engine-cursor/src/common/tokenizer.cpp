@@ -1,5 +1,4 @@
 #include "common/tokenizer.h"
-#include <sstream>
 #include <algorithm>
 #include <cctype>
 
@@ -10,19 +9,31 @@ std::vector<std::string> Tokenizer::tokenize(const Document& doc) const {
 }
 
 std::vector<std::string> Tokenizer::tokenize(const std::string& text) const {
-    auto tokens = splitBySpace(text);
+    return tokenize(text, nullptr);
+}
+
+std::vector<std::string> Tokenizer::tokenize(const std::string& text,
+                                             std::vector<TextSpan>* offsets) const {
+    std::vector<TextSpan> spans;
+    auto tokens = splitBySpace(text, spans);
     
-    // 标准化每个token
-    for (auto& token : tokens) {
-        token = normalize(token);
+    // 标准化每个token，过滤空token（位置信息同步过滤）
+    size_t kept = 0;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        std::string normalized = normalize(tokens[i]);
+        if (normalized.empty()) {
+            continue;
+        }
+        tokens[kept] = std::move(normalized);
+        spans[kept] = spans[i];
+        kept++;
     }
+    tokens.resize(kept);
     
-    // 过滤空token
-    tokens.erase(
-        std::remove_if(tokens.begin(), tokens.end(),
-            [](const std::string& t) { return t.empty(); }),
-        tokens.end()
-    );
+    if (offsets) {
+        spans.resize(kept);
+        *offsets = std::move(spans);
+    }
     
     return tokens;
 }
@@ -46,13 +57,24 @@ std::string Tokenizer::normalize(const std::string& token) const {
     return normalized;
 }
 
-std::vector<std::string> Tokenizer::splitBySpace(const std::string& text) const {
+std::vector<std::string> Tokenizer::splitBySpace(const std::string& text,
+                                                std::vector<TextSpan>& offsets) const {
     std::vector<std::string> tokens;
-    std::istringstream iss(text);
-    std::string token;
+    const size_t n = text.size();
+    size_t pos = 0;
     
-    while (iss >> token) {
-        tokens.push_back(token);
+    while (pos < n) {
+        while (pos < n && std::isspace(static_cast<unsigned char>(text[pos]))) {
+            ++pos;
+        }
+        size_t start = pos;
+        while (pos < n && !std::isspace(static_cast<unsigned char>(text[pos]))) {
+            ++pos;
+        }
+        if (pos > start) {
+            tokens.emplace_back(text, start, pos - start);
+            offsets.emplace_back(static_cast<uint32_t>(start), static_cast<uint32_t>(pos));
+        }
     }
     
     return tokens;
@@ -33,6 +33,16 @@ public:
      */
     virtual std::vector<std::string> tokenize(const std::string& text) const;
 
+    /**
+     * @brief 对文本进行分词，并记录每个token在原文中的字节区间
+     * 摘要生成依赖这些位置信息，避免查询时重新分词
+     * @param text 待分词的文本
+     * @param offsets 输出每个token的位置（与返回值一一对应），可为nullptr
+     * @return token列表
+     */
+    virtual std::vector<std::string> tokenize(const std::string& text,
+                                              std::vector<TextSpan>* offsets) const;
+
     /**
      * @brief 标准化token（转小写、去除标点等）
      * @param token 原始token
@@ -44,9 +54,11 @@ private:
     /**
      * @brief 基于空格分词（简单实现）
      * @param text 输入文本
+     * @param offsets 输出每个token的位置
      * @return token列表
      */
-    std::vector<std::string> splitBySpace(const std::string& text) const;
+    std::vector<std::string> splitBySpace(const std::string& text,
+                                          std::vector<TextSpan>& offsets) const;
 };
 
 } // namespace search_engine
@@ -1,19 +1,36 @@
 #include "common/utils.h"
 #include <fstream>
 #include <sstream>
+#include <unistd.h>
 
 namespace search_engine {
 namespace utils {
 
 std::string readFile(const std::string& filepath) {
-    std::ifstream file(filepath);
+    std::string content;
+    readFile(filepath, content);
+    return content;
+}
+
+bool readFile(const std::string& filepath, std::string& content) {
+    content.clear();
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
     if (!file.is_open()) {
-        return "";
+        return false;
     }
     
-    std::ostringstream oss;
-    oss << file.rdbuf();
-    return oss.str();
+    // 预先按文件大小分配，一次读入，避免ostringstream的中间拷贝
+    std::streamoff size = file.tellg();
+    if (size < 0) {
+        return false;
+    }
+    content.resize(static_cast<size_t>(size));
+    file.seekg(0, std::ios::beg);
+    if (size > 0 && !file.read(&content[0], size)) {
+        content.clear();
+        return false;
+    }
+    return true;
 }
 
 std::vector<std::string> split(const std::string& str, char delimiter) {
@@ -28,6 +45,46 @@ std::vector<std::string> split(const std::string& str, char delimiter) {
     return tokens;
 }
 
+size_t utf8PrefixLength(std::string_view text, size_t max_bytes) {
+    if (text.size() <= max_bytes) {
+        return text.size();
+    }
+    // 回退到字符起始字节（非10xxxxxx的续字节）
+    size_t len = max_bytes;
+    while (len > 0 && (static_cast<unsigned char>(text[len]) & 0xC0) == 0x80) {
+        --len;
+    }
+    return len;
+}
+
+void appendUtf8(uint32_t cp, std::string& out) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+size_t residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0;
+    size_t resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) {
+        return 0;
+    }
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
 } // namespace utils
 } // namespace search_engine
 
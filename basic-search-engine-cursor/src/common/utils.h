@@ -1,7 +1,9 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstdint>
 
 namespace search_engine {
 
@@ -17,6 +19,14 @@ namespace utils {
  */
 std::string readFile(const std::string& filepath);
 
+/**
+ * @brief 读取文件内容（可区分读取失败与空文件）
+ * @param filepath 文件路径
+ * @param content 输出文件内容
+ * @return 是否读取成功
+ */
+bool readFile(const std::string& filepath, std::string& content);
+
 /**
  * @brief 分割字符串
  * @param str 输入字符串
@@ -25,6 +35,27 @@ std::string readFile(const std::string& filepath);
  */
 std::vector<std::string> split(const std::string& str, char delimiter);
 
+/**
+ * @brief 计算不超过max_bytes、且不会截断UTF-8字符的前缀长度
+ * @param text 输入文本（UTF-8）
+ * @param max_bytes 最大字节数
+ * @return 前缀字节数
+ */
+size_t utf8PrefixLength(std::string_view text, size_t max_bytes);
+
+/**
+ * @brief 将Unicode码点编码为UTF-8追加到out
+ * @param codepoint 码点
+ * @param out 输出字符串
+ */
+void appendUtf8(uint32_t codepoint, std::string& out);
+
+/**
+ * @brief 当前进程的常驻内存（RSS）字节数，读取/proc/self/statm
+ * @return 字节数（不支持的平台返回0）
+ */
+size_t residentBytes();
+
 } // namespace utils
 
 } // namespace search_engine
@@ -0,0 +1,300 @@
+#include "index/completion_trie.h"
+#include "common/line_scanner.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+
+namespace search_engine {
+
+namespace {
+
+const uint32_t kMagic = 0x54435345;   // "ESCT"
+const uint32_t kVersion = 1;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+void CompletionTrie::build(const InvertedIndex& index, size_t top_k) {
+    std::vector<std::pair<std::string, uint64_t>> entries;
+    entries.reserve(index.getTermCount());
+    index.forEachTerm([&entries](const std::string& term, size_t df) {
+        entries.emplace_back(term, df);
+    });
+    build(std::move(entries), top_k);
+}
+
+void CompletionTrie::build(std::vector<std::pair<std::string, uint64_t>> entries, size_t top_k) {
+    top_k = std::max<size_t>(top_k, 1);
+
+    // 1. 排序、合并重复文本
+    std::sort(entries.begin(), entries.end());
+    size_t unique = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (unique > 0 && entries[unique - 1].first == entries[i].first) {
+            entries[unique - 1].second += entries[i].second;
+        } else {
+            if (unique != i) {
+                entries[unique] = std::move(entries[i]);
+            }
+            unique++;
+        }
+    }
+    entries.resize(unique);
+
+    // 每个条目文本在blob中的偏移（条目已按文本排序）
+    std::vector<uint32_t> text_offsets(entries.size());
+    size_t blob_size = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        text_offsets[i] = static_cast<uint32_t>(blob_size);
+        blob_size += entries[i].first.size();
+    }
+
+    // 2. 按BFS顺序建压缩trie（radix tree）：同一节点的孩子编号连续，出边按首字节有序
+    //    单链路径合并到一条边上，边的标签直接引用区间第一个条目文本中的一段
+    struct BuildNode {
+        uint32_t lo, hi, depth;
+        uint32_t label_offset, label_length;
+        int64_t own_entry;
+        uint32_t first_edge, edge_count;
+    };
+    std::vector<BuildNode> nodes;
+    std::vector<uint32_t> edge_targets;
+    std::vector<uint8_t> edge_labels;
+    nodes.push_back({0, static_cast<uint32_t>(entries.size()), 0, 0, 0, -1, 0, 0});
+
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        uint32_t lo = nodes[n].lo;
+        const uint32_t hi = nodes[n].hi;
+        const uint32_t depth = nodes[n].depth;
+        // 有序区间中至多第一个条目恰好等于公共前缀
+        if (lo < hi && entries[lo].first.size() == depth) {
+            nodes[n].own_entry = lo++;
+        }
+        nodes[n].first_edge = static_cast<uint32_t>(edge_targets.size());
+        while (lo < hi) {
+            const uint8_t label = static_cast<uint8_t>(entries[lo].first[depth]);
+            uint32_t end = lo + 1;
+            while (end < hi && static_cast<uint8_t>(entries[end].first[depth]) == label) {
+                ++end;
+            }
+            // 有序区间的公共前缀 = 首尾两个条目的公共前缀
+            const std::string& first = entries[lo].first;
+            const std::string& last = entries[end - 1].first;
+            uint32_t child_depth = depth + 1;
+            while (child_depth < first.size() && child_depth < last.size() &&
+                   first[child_depth] == last[child_depth]) {
+                ++child_depth;
+            }
+            edge_labels.push_back(label);
+            edge_targets.push_back(static_cast<uint32_t>(nodes.size()));
+            nodes.push_back({lo, end, child_depth, text_offsets[lo] + depth, child_depth - depth, -1, 0, 0});
+            lo = end;
+        }
+        nodes[n].edge_count = static_cast<uint32_t>(edge_targets.size()) - nodes[n].first_edge;
+    }
+
+    // 3. 自底向上计算每个节点的top-k（孩子编号总大于父节点，逆序处理即可）
+    auto heavier = [&entries](uint32_t a, uint32_t b) {
+        if (entries[a].second != entries[b].second) {
+            return entries[a].second > entries[b].second;
+        }
+        return a < b;
+    };
+    std::vector<uint32_t> topk_ids;
+    std::vector<std::pair<uint32_t, uint32_t>> topk_slices(nodes.size());   // (begin, count)
+    std::vector<uint32_t> candidates;
+    for (size_t n = nodes.size(); n-- > 0;) {
+        const BuildNode& node = nodes[n];
+        if (node.own_entry < 0 && node.edge_count == 1) {
+            // 单孩子节点（只可能是根）：与孩子共享top-k
+            topk_slices[n] = topk_slices[edge_targets[node.first_edge]];
+            continue;
+        }
+        candidates.clear();
+        if (node.own_entry >= 0) {
+            candidates.push_back(static_cast<uint32_t>(node.own_entry));
+        }
+        for (uint32_t e = node.first_edge; e < node.first_edge + node.edge_count; ++e) {
+            const auto& slice = topk_slices[edge_targets[e]];
+            candidates.insert(candidates.end(), topk_ids.begin() + slice.first,
+                              topk_ids.begin() + slice.first + slice.second);
+        }
+        size_t keep = std::min(candidates.size(), top_k);
+        std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(), heavier);
+        topk_slices[n] = {static_cast<uint32_t>(topk_ids.size()), static_cast<uint32_t>(keep)};
+        topk_ids.insert(topk_ids.end(), candidates.begin(), candidates.begin() + keep);
+    }
+
+    // 4. 写入连续缓冲区
+    const size_t nodes_offset = alignUp(sizeof(Header), 8);
+    const size_t entries_offset = alignUp(nodes_offset + nodes.size() * sizeof(Node), 8);
+    const size_t topk_offset = entries_offset + entries.size() * sizeof(Entry);
+    const size_t targets_offset = topk_offset + topk_ids.size() * sizeof(uint32_t);
+    const size_t labels_offset = targets_offset + edge_targets.size() * sizeof(uint32_t);
+    const size_t blob_offset = labels_offset + edge_labels.size();
+    const size_t total = blob_offset + blob_size;
+
+    mapped_.close();
+    owned_.assign(total, 0);
+    char* data = owned_.data();
+
+    Header header;
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.top_k = static_cast<uint32_t>(top_k);
+    header.num_nodes = static_cast<uint32_t>(nodes.size());
+    header.num_entries = static_cast<uint32_t>(entries.size());
+    header.num_topk_ids = static_cast<uint32_t>(topk_ids.size());
+    header.num_edges = static_cast<uint32_t>(edge_targets.size());
+    header.blob_size = static_cast<uint32_t>(blob_size);
+    std::memcpy(data, &header, sizeof(header));
+
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        Node node{nodes[n].first_edge, nodes[n].edge_count, topk_slices[n].first, topk_slices[n].second,
+                  nodes[n].label_offset, nodes[n].label_length};
+        std::memcpy(data + nodes_offset + n * sizeof(Node), &node, sizeof(node));
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        Entry entry{entries[i].second, text_offsets[i], static_cast<uint32_t>(entries[i].first.size())};
+        std::memcpy(data + entries_offset + i * sizeof(Entry), &entry, sizeof(entry));
+        std::memcpy(data + blob_offset + text_offsets[i], entries[i].first.data(), entries[i].first.size());
+    }
+    std::memcpy(data + topk_offset, topk_ids.data(), topk_ids.size() * sizeof(uint32_t));
+    std::memcpy(data + targets_offset, edge_targets.data(), edge_targets.size() * sizeof(uint32_t));
+    std::memcpy(data + labels_offset, edge_labels.data(), edge_labels.size());
+
+    attach(owned_.data(), owned_.size());
+}
+
+bool CompletionTrie::attach(const char* data, size_t size) {
+    header_ = nullptr;
+    size_bytes_ = 0;
+    if (size < sizeof(Header)) {
+        return false;
+    }
+    const Header* header = reinterpret_cast<const Header*>(data);
+    if (header->magic != kMagic || header->version != kVersion || header->num_nodes == 0) {
+        return false;
+    }
+
+    const size_t nodes_offset = alignUp(sizeof(Header), 8);
+    const size_t entries_offset = alignUp(nodes_offset + size_t(header->num_nodes) * sizeof(Node), 8);
+    const size_t topk_offset = entries_offset + size_t(header->num_entries) * sizeof(Entry);
+    const size_t targets_offset = topk_offset + size_t(header->num_topk_ids) * sizeof(uint32_t);
+    const size_t labels_offset = targets_offset + size_t(header->num_edges) * sizeof(uint32_t);
+    const size_t blob_offset = labels_offset + header->num_edges;
+    if (blob_offset + header->blob_size != size) {
+        return false;
+    }
+
+    header_ = header;
+    nodes_ = reinterpret_cast<const Node*>(data + nodes_offset);
+    entries_ = reinterpret_cast<const Entry*>(data + entries_offset);
+    topk_ids_ = reinterpret_cast<const uint32_t*>(data + topk_offset);
+    edge_targets_ = reinterpret_cast<const uint32_t*>(data + targets_offset);
+    edge_labels_ = reinterpret_cast<const uint8_t*>(data + labels_offset);
+    blob_ = data + blob_offset;
+    size_bytes_ = size;
+    return true;
+}
+
+size_t CompletionTrie::complete(std::string_view prefix, size_t k, std::vector<Completion>& out) const {
+    out.clear();
+    if (!header_) {
+        return 0;
+    }
+
+    // 沿前缀下降：每个节点按首字节二分找出边，再比较边上剩余的标签
+    uint32_t node = 0;
+    size_t pos = 0;
+    while (pos < prefix.size()) {
+        const Node& current = nodes_[node];
+        const uint8_t label = static_cast<uint8_t>(prefix[pos]);
+        const uint8_t* first = edge_labels_ + current.first_edge;
+        const uint8_t* last = first + current.edge_count;
+        const uint8_t* it = std::lower_bound(first, last, label);
+        if (it == last || *it != label) {
+            return 0;
+        }
+        node = edge_targets_[it - edge_labels_];
+
+        const Node& child = nodes_[node];
+        const size_t length = std::min<size_t>(child.label_length, prefix.size() - pos);
+        if (std::memcmp(blob_ + child.label_offset, prefix.data() + pos, length) != 0) {
+            return 0;
+        }
+        // 前缀在边的中间结束时，补全结果就是该子节点的top-k
+        pos += length;
+    }
+
+    const Node& target = nodes_[node];
+    const size_t count = std::min<size_t>(k, target.topk_count);
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const Entry& entry = entries_[topk_ids_[target.topk_begin + i]];
+        out.emplace_back(std::string_view(blob_ + entry.text_offset, entry.text_length), entry.weight);
+    }
+    return count;
+}
+
+bool CompletionTrie::save(const std::string& filepath) const {
+    if (!header_) {
+        return false;
+    }
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(header_), static_cast<std::streamsize>(size_bytes_));
+    return static_cast<bool>(file);
+}
+
+bool CompletionTrie::load(const std::string& filepath) {
+    owned_.clear();
+    owned_.shrink_to_fit();
+    header_ = nullptr;
+    if (!mapped_.open(filepath)) {
+        return false;
+    }
+    if (!attach(mapped_.data(), mapped_.size())) {
+        mapped_.close();
+        return false;
+    }
+    return true;
+}
+
+bool readQueryLog(const std::string& filepath, std::vector<std::pair<std::string, uint64_t>>& entries) {
+    MappedFile file;
+    if (!file.open(filepath)) {
+        return false;
+    }
+
+    LineScanner scanner(file.data(), file.size());
+    std::string_view line;
+    while (scanner.next(line)) {
+        if (line.empty()) {
+            continue;
+        }
+        uint64_t count = 1;
+        size_t tab = line.rfind('\t');
+        if (tab != std::string_view::npos) {
+            std::string_view number = line.substr(tab + 1);
+            auto result = std::from_chars(number.data(), number.data() + number.size(), count);
+            if (result.ec == std::errc() && result.ptr == number.data() + number.size()) {
+                line = line.substr(0, tab);
+            } else {
+                count = 1;
+            }
+        }
+        if (!line.empty()) {
+            entries.emplace_back(std::string(line), count);
+        }
+    }
+    return true;
+}
+
+} // namespace search_engine
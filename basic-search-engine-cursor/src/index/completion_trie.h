@@ -0,0 +1,131 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "common/mapped_file.h"
+#include "index/inverted_index.h"
+
+namespace search_engine {
+
+/**
+ * @brief 补全结果
+ * text指向CompletionTrie内部存储，生命周期与trie相同
+ */
+struct Completion {
+    std::string_view text;
+    uint64_t weight;
+
+    Completion(std::string_view t, uint64_t w) : text(t), weight(w) {}
+};
+
+/**
+ * @brief 前缀补全索引（每个节点预存top-k）
+ *
+ * 设计思路：
+ * - 字节级压缩trie（radix tree），每个节点预先存好该子树中权重最高的top-k条目，
+ *   查询只需沿前缀走O(前缀长度)步，不需要遍历子树
+ * - 单链路径合并成一条边，边标签直接引用条目文本，节点数约为条目数的两倍以内
+ * - 所有数据放在一块连续、按4/8字节对齐的缓冲区中（节点、条目、top-k、边、字符串），
+ *   save()直接写出，load()通过mmap零拷贝加载（按本机字节序，当前仅支持小端）
+ *
+ * 缓冲区布局：
+ *   Header | Node[] | Entry[] | topk_ids(u32)[] | edge_targets(u32)[] | edge_labels(u8)[] | text_blob
+ */
+class CompletionTrie {
+public:
+    CompletionTrie() = default;
+
+    CompletionTrie(const CompletionTrie&) = delete;
+    CompletionTrie& operator=(const CompletionTrie&) = delete;
+
+    /**
+     * @brief 构建补全索引
+     * @param entries (文本, 权重) 列表，重复文本的权重会累加
+     * @param top_k 每个节点保存的条目数
+     */
+    void build(std::vector<std::pair<std::string, uint64_t>> entries, size_t top_k = 10);
+
+    /**
+     * @brief 以倒排索引中的term为条目、文档频率为权重构建
+     */
+    void build(const InvertedIndex& index, size_t top_k = 10);
+
+    /**
+     * @brief 查询前缀补全
+     * @param prefix 前缀
+     * @param k 返回条数（不超过构建时的top_k）
+     * @param out 输出结果（按权重降序，会先清空）
+     * @return 结果条数
+     */
+    size_t complete(std::string_view prefix, size_t k, std::vector<Completion>& out) const;
+
+    /**
+     * @brief 保存到文件
+     */
+    bool save(const std::string& filepath) const;
+
+    /**
+     * @brief 从文件加载（mmap，零拷贝）
+     */
+    bool load(const std::string& filepath);
+
+    size_t size() const { return header_ ? header_->num_entries : 0; }
+    size_t nodeCount() const { return header_ ? header_->num_nodes : 0; }
+    size_t topK() const { return header_ ? header_->top_k : 0; }
+    size_t bytes() const { return size_bytes_; }
+
+private:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t top_k;
+        uint32_t num_nodes;
+        uint32_t num_entries;
+        uint32_t num_topk_ids;
+        uint32_t num_edges;
+        uint32_t blob_size;
+    };
+
+    struct Node {
+        uint32_t first_edge;   // 第一条出边
+        uint32_t edge_count;   // 出边数（边按label有序）
+        uint32_t topk_begin;   // 在topk_ids中的起始位置
+        uint32_t topk_count;   // top-k条数
+        uint32_t label_offset; // 入边标签在text_blob中的位置（压缩路径）
+        uint32_t label_length; // 入边标签长度
+    };
+
+    struct Entry {
+        uint64_t weight;
+        uint32_t text_offset;
+        uint32_t text_length;
+    };
+
+    // 根据缓冲区设置各数组指针，并校验大小
+    bool attach(const char* data, size_t size);
+
+    std::vector<char> owned_;   // build()产生的缓冲区
+    MappedFile mapped_;         // load()映射的文件
+
+    size_t size_bytes_ = 0;
+    const Header* header_ = nullptr;
+    const Node* nodes_ = nullptr;
+    const Entry* entries_ = nullptr;
+    const uint32_t* topk_ids_ = nullptr;
+    const uint32_t* edge_targets_ = nullptr;
+    const uint8_t* edge_labels_ = nullptr;
+    const char* blob_ = nullptr;
+};
+
+/**
+ * @brief 读取查询日志（每行 "查询<TAB>次数"，缺少次数时计为1）
+ * @param filepath 文件路径
+ * @param entries 输出 (查询, 次数) 列表（追加）
+ * @return 是否读取成功
+ */
+bool readQueryLog(const std::string& filepath, std::vector<std::pair<std::string, uint64_t>>& entries);
+
+} // namespace search_engine
@@ -0,0 +1,180 @@
+#include "index/doc_values.h"
+#include <algorithm>
+
+namespace search_engine {
+
+uint32_t DocValuesColumn::findOrdinal(std::string_view keyword) const {
+    auto it = dictionary_index_.find(std::string(keyword));
+    return it != dictionary_index_.end() ? it->second : kMissingOrdinal;
+}
+
+size_t DocValuesColumn::bytes() const {
+    size_t total = present_.size() * sizeof(uint64_t) + ints_.size() * sizeof(int64_t) +
+                   doubles_.size() * sizeof(double) + ordinals_.size() * sizeof(uint32_t);
+    for (const auto& keyword : dictionary_) {
+        total += keyword.size();
+    }
+    return total;
+}
+
+void DocValuesColumn::ensureSize(size_t doc_id) {
+    if (doc_id < size_) {
+        return;
+    }
+    size_ = doc_id + 1;
+    present_.resize((size_ + 63) / 64, 0);
+    switch (type_) {
+        case DocValueType::kInt64:
+            ints_.resize(size_, 0);
+            break;
+        case DocValueType::kDouble:
+            doubles_.resize(size_, 0.0);
+            break;
+        case DocValueType::kKeyword:
+            ordinals_.resize(size_, kMissingOrdinal);
+            break;
+    }
+}
+
+uint32_t DocValuesColumn::internKeyword(const std::string& keyword) {
+    auto [it, inserted] = dictionary_index_.emplace(keyword, static_cast<uint32_t>(dictionary_.size()));
+    if (inserted) {
+        dictionary_.push_back(keyword);
+    }
+    return it->second;
+}
+
+bool DocValues::addColumn(const std::string& field, DocValueType type) {
+    auto it = columns_.find(field);
+    if (it != columns_.end()) {
+        return it->second.type() == type;
+    }
+    columns_.emplace(field, DocValuesColumn(field, type));
+    version_++;
+    return true;
+}
+
+bool DocValues::setMaxDocId(int64_t max_doc_id) {
+    if (max_doc_id < 0 || max_doc_id > kMaxDocId) {
+        return false;
+    }
+    max_doc_id_ = max_doc_id;
+    return true;
+}
+
+DocValuesColumn* DocValues::prepare(int64_t doc_id, const std::string& field, DocValueType type) {
+    if (doc_id < 0 || doc_id > max_doc_id_ || !addColumn(field, type)) {
+        return nullptr;
+    }
+    DocValuesColumn& column = columns_.at(field);
+    column.ensureSize(static_cast<size_t>(doc_id));
+    column.markPresent(static_cast<size_t>(doc_id));
+    version_++;
+    return &column;
+}
+
+bool DocValues::setInt(int64_t doc_id, const std::string& field, int64_t value) {
+    DocValuesColumn* column = prepare(doc_id, field, DocValueType::kInt64);
+    if (!column) {
+        return false;
+    }
+    column->ints_[doc_id] = value;
+    return true;
+}
+
+bool DocValues::setDouble(int64_t doc_id, const std::string& field, double value) {
+    DocValuesColumn* column = prepare(doc_id, field, DocValueType::kDouble);
+    if (!column) {
+        return false;
+    }
+    column->doubles_[doc_id] = value;
+    return true;
+}
+
+bool DocValues::setKeyword(int64_t doc_id, const std::string& field, const std::string& value) {
+    DocValuesColumn* column = prepare(doc_id, field, DocValueType::kKeyword);
+    if (!column) {
+        return false;
+    }
+    column->ordinals_[doc_id] = column->internKeyword(value);
+    return true;
+}
+
+void DocValues::removeDocument(int64_t doc_id) {
+    bool changed = false;
+    for (auto& [field, column] : columns_) {
+        if (!column.hasValue(doc_id)) {
+            continue;
+        }
+        // 值槽位一并复位：关键字分面按序号是否为kMissingOrdinal判断有无值，不看存在位图
+        column.present_[doc_id >> 6] &= ~(uint64_t(1) << (doc_id & 63));
+        switch (column.type_) {
+            case DocValueType::kInt64:
+                column.ints_[doc_id] = 0;
+                break;
+            case DocValueType::kDouble:
+                column.doubles_[doc_id] = 0.0;
+                break;
+            case DocValueType::kKeyword:
+                column.ordinals_[doc_id] = DocValuesColumn::kMissingOrdinal;
+                break;
+        }
+        changed = true;
+    }
+    if (changed) {
+        version_++;
+    }
+}
+
+const DocValuesColumn* DocValues::column(const std::string& field) const {
+    auto it = columns_.find(field);
+    return it != columns_.end() ? &it->second : nullptr;
+}
+
+void DocValues::remapDocIds(const std::unordered_map<int64_t, int64_t>& mapping) {
+    for (auto& [field, column] : columns_) {
+        DocValuesColumn remapped(column.name_, column.type_);
+        remapped.dictionary_ = std::move(column.dictionary_);
+        remapped.dictionary_index_ = std::move(column.dictionary_index_);
+        for (size_t doc_id = 0; doc_id < column.size_; ++doc_id) {
+            if (!column.hasValue(static_cast<int64_t>(doc_id))) {
+                continue;
+            }
+            auto it = mapping.find(static_cast<int64_t>(doc_id));
+            int64_t new_id = it != mapping.end() ? it->second : static_cast<int64_t>(doc_id);
+            if (new_id < 0 || new_id > max_doc_id_) {
+                continue;
+            }
+            remapped.ensureSize(static_cast<size_t>(new_id));
+            remapped.markPresent(static_cast<size_t>(new_id));
+            switch (column.type_) {
+                case DocValueType::kInt64:
+                    remapped.ints_[new_id] = column.ints_[doc_id];
+                    break;
+                case DocValueType::kDouble:
+                    remapped.doubles_[new_id] = column.doubles_[doc_id];
+                    break;
+                case DocValueType::kKeyword:
+                    remapped.ordinals_[new_id] = column.ordinals_[doc_id];
+                    break;
+            }
+        }
+        column = std::move(remapped);
+    }
+    version_++;
+}
+
+size_t DocValues::bytes() const {
+    size_t total = 0;
+    for (const auto& [field, column] : columns_) {
+        total += column.bytes();
+    }
+    return total;
+}
+
+void DocValues::clear() {
+    columns_.clear();
+    version_++;
+}
+
+} // namespace search_engine
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace search_engine {
+
+/**
+ * @brief 属性列类型
+ */
+enum class DocValueType {
+    kInt64,     // 整数（时间戳、数量等）
+    kDouble,    // 浮点数（价格、评分等）
+    kKeyword    // 低基数字符串（分类、来源等），按字典编码成序号存储
+};
+
+/**
+ * @brief 单个属性列
+ *
+ * 列式存储：值数组按doc_id直接寻址（下标即doc_id），另有一个位图记录哪些文档有值。
+ * 关键字列只存uint32序号，字符串放在列内字典中
+ */
+class DocValuesColumn {
+public:
+    static constexpr uint32_t kMissingOrdinal = UINT32_MAX;
+
+    DocValuesColumn(std::string name, DocValueType type) : name_(std::move(name)), type_(type) {}
+
+    const std::string& name() const { return name_; }
+    DocValueType type() const { return type_; }
+
+    /**
+     * @brief 列覆盖的doc_id范围 [0, size())
+     */
+    size_t size() const { return size_; }
+
+    bool hasValue(int64_t doc_id) const {
+        return doc_id >= 0 && static_cast<size_t>(doc_id) < size_ &&
+               ((present_[doc_id >> 6] >> (doc_id & 63)) & 1);
+    }
+
+    int64_t intValue(int64_t doc_id) const { return ints_[doc_id]; }
+    double doubleValue(int64_t doc_id) const { return doubles_[doc_id]; }
+    uint32_t ordinal(int64_t doc_id) const { return ordinals_[doc_id]; }
+
+    /**
+     * @brief 数值列的值统一转成double（整数列可能损失精度）
+     */
+    double numericValue(int64_t doc_id) const {
+        return type_ == DocValueType::kInt64 ? static_cast<double>(ints_[doc_id]) : doubles_[doc_id];
+    }
+
+    // 原始数组（按doc_id寻址），供过滤/聚合批量扫描
+    const int64_t* ints() const { return ints_.data(); }
+    const double* doubles() const { return doubles_.data(); }
+    const uint32_t* ordinals() const { return ordinals_.data(); }
+    const std::vector<uint64_t>& presence() const { return present_; }
+
+    /**
+     * @brief 关键字字典
+     */
+    size_t cardinality() const { return dictionary_.size(); }
+    const std::string& keyword(uint32_t ordinal) const { return dictionary_[ordinal]; }
+
+    /**
+     * @brief 查找关键字的序号
+     * @return 序号（不存在返回kMissingOrdinal）
+     */
+    uint32_t findOrdinal(std::string_view keyword) const;
+
+    /**
+     * @brief 列占用的字节数
+     */
+    size_t bytes() const;
+
+private:
+    friend class DocValues;
+
+    void ensureSize(size_t doc_id);
+    void markPresent(size_t doc_id) { present_[doc_id >> 6] |= uint64_t(1) << (doc_id & 63); }
+    uint32_t internKeyword(const std::string& keyword);
+
+    std::string name_;
+    DocValueType type_;
+    size_t size_ = 0;
+    std::vector<uint64_t> present_;
+    std::vector<int64_t> ints_;
+    std::vector<double> doubles_;
+    std::vector<uint32_t> ordinals_;
+    std::vector<std::string> dictionary_;
+    std::unordered_map<std::string, uint32_t> dictionary_index_;
+};
+
+/**
+ * @brief 文档属性（doc values）
+ *
+ * 每个字段一列，与doc_id对齐的稠密数组，用于查询时的属性过滤、按字段排序和聚合。
+ *
+ * 设计思路：
+ * - doc_id直接作为下标，不需要额外的映射；要求doc_id为较稠密的非负整数
+ *   （自动分配或重排序后的ID满足）。每列按最大doc_id分配，一个离群的大ID就会让整列
+ *   膨胀到GB级，所以超过maxDocId()（默认kDefaultMaxDocId，一个整数列最多128MB）的ID
+ *   会被拒绝；更大的语料用setMaxDocId()调高，上限kMaxDocId
+ * - 每次写入递增version()，查询侧的过滤缓存据此失效
+ * - 只有一个写入者（构建阶段），查询阶段只读
+ */
+class DocValues {
+public:
+    static constexpr int64_t kMaxDocId = (int64_t(1) << 32) - 2;
+    static constexpr int64_t kDefaultMaxDocId = (int64_t(1) << 24) - 1;
+
+    /**
+     * @brief 设置允许写入的最大doc_id（只影响之后的写入）
+     * @return max_doc_id为负数或超过kMaxDocId时返回false
+     */
+    bool setMaxDocId(int64_t max_doc_id);
+    int64_t maxDocId() const { return max_doc_id_; }
+
+    /**
+     * @brief 声明字段
+     * @return 字段已存在且类型不同时返回false
+     */
+    bool addColumn(const std::string& field, DocValueType type);
+
+    /**
+     * @brief 写入属性值（字段不存在时按值类型自动创建）
+     * @return doc_id为负数或超过maxDocId()、字段类型不匹配时返回false
+     */
+    bool setInt(int64_t doc_id, const std::string& field, int64_t value);
+    bool setDouble(int64_t doc_id, const std::string& field, double value);
+    bool setKeyword(int64_t doc_id, const std::string& field, const std::string& value);
+
+    /**
+     * @brief 清除文档在所有列上的值（文档被删除或覆盖时调用）
+     */
+    void removeDocument(int64_t doc_id);
+
+    /**
+     * @brief 获取字段列
+     * @return 列指针（不存在返回nullptr）
+     */
+    const DocValuesColumn* column(const std::string& field) const;
+
+    /**
+     * @brief 按映射重新编号文档（文档重排序时调用）
+     * @param mapping 旧文档ID -> 新文档ID
+     */
+    void remapDocIds(const std::unordered_map<int64_t, int64_t>& mapping);
+
+    /**
+     * @brief 修改版本号（每次写入递增）
+     */
+    uint64_t version() const { return version_; }
+
+    size_t getColumnCount() const { return columns_.size(); }
+
+    /**
+     * @brief 所有列占用的字节数
+     */
+    size_t bytes() const;
+
+    void clear();
+
+private:
+    DocValuesColumn* prepare(int64_t doc_id, const std::string& field, DocValueType type);
+
+    std::unordered_map<std::string, DocValuesColumn> columns_;
+    uint64_t version_ = 0;
+    int64_t max_doc_id_ = kDefaultMaxDocId;
+};
+
+} // namespace search_engine
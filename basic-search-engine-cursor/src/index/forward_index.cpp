@@ -6,6 +6,16 @@ void ForwardIndex::addDocument(const Document& doc) {
     index_[doc.doc_id] = doc;
 }
 
+void ForwardIndex::addDocument(Document&& doc) {
+    int64_t doc_id = doc.doc_id;
+    index_[doc_id] = std::move(doc);
+}
+
+bool ForwardIndex::removeDocument(int64_t doc_id) {
+    original_ids_.erase(doc_id);
+    return index_.erase(doc_id) > 0;
+}
+
 Document ForwardIndex::getDocument(int64_t doc_id) const {
     auto it = index_.find(doc_id);
     if (it != index_.end()) {
@@ -14,12 +24,59 @@ Document ForwardIndex::getDocument(int64_t doc_id) const {
     return Document(); // 返回空文档
 }
 
+const Document* ForwardIndex::findDocument(int64_t doc_id) const {
+    auto it = index_.find(doc_id);
+    return it != index_.end() ? &it->second : nullptr;
+}
+
 bool ForwardIndex::hasDocument(int64_t doc_id) const {
     return index_.find(doc_id) != index_.end();
 }
 
+void ForwardIndex::remapDocIds(const std::unordered_map<int64_t, int64_t>& mapping) {
+    decltype(index_) remapped;
+    decltype(original_ids_) original_ids;
+    remapped.reserve(index_.size());
+    for (auto& [doc_id, doc] : index_) {
+        auto it = mapping.find(doc_id);
+        int64_t new_id = it != mapping.end() ? it->second : doc_id;
+        int64_t original_id = getOriginalDocId(doc_id);
+        if (original_id != new_id) {
+            original_ids[new_id] = original_id;
+        }
+        doc.doc_id = new_id;
+        remapped.emplace(new_id, std::move(doc));
+    }
+    index_ = std::move(remapped);
+    original_ids_ = std::move(original_ids);
+}
+
+int64_t ForwardIndex::getOriginalDocId(int64_t doc_id) const {
+    auto it = original_ids_.find(doc_id);
+    return it != original_ids_.end() ? it->second : doc_id;
+}
+
+ForwardIndexStats ForwardIndex::collectStats() const {
+    ForwardIndexStats stats;
+    stats.documents = index_.size();
+    stats.table_bytes = index_.get_allocator().counter().bytes;
+    stats.table_allocations = index_.get_allocator().counter().allocations;
+    stats.original_id_bytes = original_ids_.get_allocator().counter().bytes;
+    for (const auto& [doc_id, doc] : index_) {
+        stats.content_bytes += memory::heapBytes(doc.content);
+        stats.title_bytes += memory::heapBytes(doc.title);
+        stats.token_bytes += memory::heapBytes(doc.tokens);
+        for (const auto& token : doc.tokens) {
+            stats.token_bytes += memory::heapBytes(token);
+        }
+        stats.token_offset_bytes += memory::heapBytes(doc.token_offsets);
+    }
+    return stats;
+}
+
 void ForwardIndex::clear() {
     index_.clear();
+    original_ids_.clear();
 }
 
 } // namespace search_engine
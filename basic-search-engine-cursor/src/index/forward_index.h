@@ -3,10 +3,29 @@
 #include <unordered_map>
 #include <string>
 #include <cstdint>
+#include "common/counting_allocator.h"
 #include "common/document.h"
 
 namespace search_engine {
 
+/**
+ * @brief 正排索引内存统计（字节）
+ */
+struct ForwardIndexStats {
+    uint64_t documents = 0;
+    uint64_t table_bytes = 0;           // doc_id哈希表的节点（含Document对象本身）和桶数组（计数分配器）
+    uint64_t table_allocations = 0;
+    uint64_t content_bytes = 0;         // 正文
+    uint64_t title_bytes = 0;
+    uint64_t token_bytes = 0;           // tokens：与正文重复的分词结果（数组 + 超出短字符串优化的token）
+    uint64_t token_offset_bytes = 0;    // token_offsets数组
+    uint64_t original_id_bytes = 0;     // 重排序前的原始ID映射（计数分配器）
+
+    uint64_t totalBytes() const {
+        return table_bytes + content_bytes + title_bytes + token_bytes + token_offset_bytes + original_id_bytes;
+    }
+};
+
 /**
  * @brief 正排索引
  * 
@@ -30,6 +49,19 @@ public:
      */
     void addDocument(const Document& doc);
 
+    /**
+     * @brief 添加文档（移动语义，避免批量导入时拷贝内容）
+     * @param doc 文档对象
+     */
+    void addDocument(Document&& doc);
+
+    /**
+     * @brief 删除文档
+     * @param doc_id 文档ID
+     * @return 文档是否存在
+     */
+    bool removeDocument(int64_t doc_id);
+
     /**
      * @brief 根据文档ID获取文档
      * @param doc_id 文档ID
@@ -37,6 +69,13 @@ public:
      */
     Document getDocument(int64_t doc_id) const;
 
+    /**
+     * @brief 根据文档ID查找文档（不拷贝）
+     * @param doc_id 文档ID
+     * @return 文档指针（不存在返回nullptr），索引修改后失效
+     */
+    const Document* findDocument(int64_t doc_id) const;
+
     /**
      * @brief 检查文档是否存在
      * @param doc_id 文档ID
@@ -50,6 +89,35 @@ public:
      */
     size_t size() const { return index_.size(); }
 
+    /**
+     * @brief 遍历所有文档（顺序不确定）
+     * @param visitor 回调（文档）
+     */
+    template <typename Visitor>
+    void forEachDocument(Visitor&& visitor) const {
+        for (const auto& [doc_id, doc] : index_) {
+            visitor(doc);
+        }
+    }
+
+    /**
+     * @brief 按映射重新编号文档（文档重排序后调用），并记录原始ID
+     * @param mapping 旧文档ID -> 新文档ID
+     */
+    void remapDocIds(const std::unordered_map<int64_t, int64_t>& mapping);
+
+    /**
+     * @brief 获取文档导入时的原始ID（未重排序时即doc_id本身）
+     * @param doc_id 当前文档ID
+     * @return 原始文档ID
+     */
+    int64_t getOriginalDocId(int64_t doc_id) const;
+
+    /**
+     * @brief 统计内存占用（遍历所有文档）
+     */
+    ForwardIndexStats collectStats() const;
+
     /**
      * @brief 清空索引
      */
@@ -57,7 +125,10 @@ public:
 
 private:
     // doc_id -> Document 映射
-    std::unordered_map<int64_t, Document> index_;
+    CountedHashMap<int64_t, Document> index_;
+    
+    // 重排序后的doc_id -> 原始doc_id（只记录发生变化的文档）
+    CountedHashMap<int64_t, int64_t> original_ids_;
 };
 
 } // namespace search_engine
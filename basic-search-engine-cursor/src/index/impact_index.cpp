@@ -0,0 +1,116 @@
+#include "index/impact_index.h"
+#include <algorithm>
+#include <cmath>
+
+namespace search_engine {
+
+void ImpactIndex::build(const InvertedIndex& index, const ImpactOptions& options) {
+    clear();
+
+    // 1. 文档稠密编号（按文档ID升序）和文档长度
+    index.forEachPostingList([this](const std::string&, const std::vector<Posting>& postings) {
+        for (const auto& posting : postings) {
+            doc_ids_.push_back(posting.doc_id);
+        }
+    });
+    std::sort(doc_ids_.begin(), doc_ids_.end());
+    doc_ids_.erase(std::unique(doc_ids_.begin(), doc_ids_.end()), doc_ids_.end());
+    if (doc_ids_.empty()) {
+        return;
+    }
+
+    std::unordered_map<int64_t, uint32_t> ordinals;
+    ordinals.reserve(doc_ids_.size());
+    for (size_t i = 0; i < doc_ids_.size(); ++i) {
+        ordinals.emplace(doc_ids_[i], static_cast<uint32_t>(i));
+    }
+    std::vector<uint32_t> doc_lengths(doc_ids_.size(), 0);
+    double total_length = 0.0;
+    index.forEachPostingList([&](const std::string&, const std::vector<Posting>& postings) {
+        for (const auto& posting : postings) {
+            doc_lengths[ordinals[posting.doc_id]] += posting.term_freq;
+            total_length += posting.term_freq;
+        }
+    });
+
+    const double num_docs = static_cast<double>(index.getTotalDocuments());
+    const double avg_length = total_length / doc_ids_.size();
+    auto score = [&](const Posting& posting, size_t df, uint32_t ordinal) {
+        const double tf = posting.term_freq;
+        if (options.model == ImpactModel::kTfIdf) {
+            return tf * std::log(num_docs / df);
+        }
+        const double idf = std::log(1.0 + (num_docs - df + 0.5) / (df + 0.5));
+        const double norm = options.k1 * (1.0 - options.b + options.b * doc_lengths[ordinal] / avg_length);
+        return idf * tf * (options.k1 + 1.0) / (tf + norm);
+    };
+
+    // 2. 全局最大得分决定量化系数
+    double max_score = 0.0;
+    index.forEachPostingList([&](const std::string&, const std::vector<Posting>& postings) {
+        for (const auto& posting : postings) {
+            max_score = std::max(max_score, score(posting, postings.size(), ordinals[posting.doc_id]));
+        }
+    });
+    if (max_score <= 0.0) {
+        return;
+    }
+    scale_ = max_score / 255.0;
+
+    // 3. 逐term量化、按影响值降序分段（得分为0的posting对排序没有贡献，直接丢弃）
+    std::vector<std::pair<uint8_t, uint32_t>> impacts;
+    index.forEachPostingList([&](const std::string& term, const std::vector<Posting>& postings) {
+        impacts.clear();
+        for (const auto& posting : postings) {
+            uint32_t ordinal = ordinals[posting.doc_id];
+            double value = score(posting, postings.size(), ordinal);
+            if (value <= 0.0) {
+                continue;
+            }
+            long quantized = std::lround(value / scale_);
+            impacts.emplace_back(static_cast<uint8_t>(std::clamp(quantized, 1L, 255L)), ordinal);
+        }
+        if (impacts.empty()) {
+            return;
+        }
+        std::sort(impacts.begin(), impacts.end(), [](const auto& a, const auto& b) {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
+
+        TermInfo info{static_cast<uint32_t>(segments_.size()), 0};
+        for (size_t i = 0; i < impacts.size(); ++i) {
+            if (i == 0 || impacts[i].first != impacts[i - 1].first) {
+                segments_.push_back({static_cast<uint32_t>(docs_.size()), 0, impacts[i].first});
+                info.segment_count++;
+            }
+            docs_.push_back(impacts[i].second);
+            segments_.back().end = static_cast<uint32_t>(docs_.size());
+        }
+        terms_.emplace(term, info);
+    });
+}
+
+const ImpactIndex::Segment* ImpactIndex::getSegments(const std::string& term, size_t& count) const {
+    auto it = terms_.find(term);
+    if (it == terms_.end()) {
+        count = 0;
+        return nullptr;
+    }
+    count = it->second.segment_count;
+    return segments_.data() + it->second.first_segment;
+}
+
+size_t ImpactIndex::bytes() const {
+    return segments_.size() * sizeof(Segment) + docs_.size() * sizeof(uint32_t) +
+           doc_ids_.size() * sizeof(int64_t) + terms_.size() * sizeof(TermInfo);
+}
+
+void ImpactIndex::clear() {
+    terms_.clear();
+    segments_.clear();
+    docs_.clear();
+    doc_ids_.clear();
+    scale_ = 0.0;
+}
+
+} // namespace search_engine
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include "index/inverted_index.h"
+
+namespace search_engine {
+
+/**
+ * @brief 影响值（impact）的计算模型
+ */
+enum class ImpactModel {
+    kTfIdf,   // tf * log(N / df)，与TfIdfScorer一致
+    kBm25     // BM25（文档长度取该文档所有term的词频之和）
+};
+
+/**
+ * @brief 影响值索引构建配置
+ */
+struct ImpactOptions {
+    ImpactModel model = ImpactModel::kBm25;
+    double k1 = 1.2;   // BM25参数
+    double b = 0.75;   // BM25参数
+};
+
+/**
+ * @brief 按影响值排序的倒排索引（Impact-Ordered Index）
+ *
+ * 每个posting预先算好该term对该文档的得分贡献，并统一量化到1~255（8位）。
+ * 每个term的posting按影响值分成若干段，段按影响值降序排列，段内doc按升序排列。
+ *
+ * 设计思路：
+ * - 全局统一的线性量化：所有term共用同一个缩放系数，查询时直接做整数累加
+ * - 查询按"段"推进（score-at-a-time）：把所有查询词的段按影响值降序合并处理，
+ *   先处理的总是对得分贡献最大的posting，预算耗尽时已累加的结果就是较好的近似top-k
+ * - 文档用稠密序号（uint32）表示，查询时累加器可以直接用数组
+ */
+class ImpactIndex {
+public:
+    /**
+     * @brief 影响值相同的一段posting
+     */
+    struct Segment {
+        uint32_t begin;   // 在docs中的起始位置
+        uint32_t end;     // 结束位置（不含）
+        uint8_t impact;   // 量化后的影响值（1~255）
+    };
+
+    ImpactIndex() = default;
+
+    /**
+     * @brief 从倒排索引构建（文档集合或posting变化后需重新构建）
+     * @param index 倒排索引
+     * @param options 构建配置
+     */
+    void build(const InvertedIndex& index, const ImpactOptions& options = ImpactOptions());
+
+    /**
+     * @brief 查询term的所有段（按影响值降序）
+     * @param term 查询词
+     * @param count 输出段数
+     * @return 第一段的指针（term不存在时返回nullptr）
+     */
+    const Segment* getSegments(const std::string& term, size_t& count) const;
+
+    /**
+     * @brief 获取一段posting的文档序号
+     */
+    const uint32_t* segmentDocs(const Segment& segment) const { return docs_.data() + segment.begin; }
+
+    /**
+     * @brief 文档序号 -> 文档ID
+     */
+    int64_t docId(uint32_t ordinal) const { return doc_ids_[ordinal]; }
+
+    /**
+     * @brief 量化值 -> 原始得分的缩放系数
+     */
+    double scale() const { return scale_; }
+
+    size_t getTotalDocuments() const { return doc_ids_.size(); }
+    size_t getTermCount() const { return terms_.size(); }
+    size_t getPostingCount() const { return docs_.size(); }
+    size_t getSegmentCount() const { return segments_.size(); }
+    bool empty() const { return docs_.empty(); }
+
+    /**
+     * @brief 索引占用的字节数（不含term字符串）
+     */
+    size_t bytes() const;
+
+    void clear();
+
+private:
+    struct TermInfo {
+        uint32_t first_segment;
+        uint32_t segment_count;
+    };
+
+    std::unordered_map<std::string, TermInfo> terms_;
+    std::vector<Segment> segments_;
+    std::vector<uint32_t> docs_;       // 文档序号，按段连续存放
+    std::vector<int64_t> doc_ids_;     // 文档序号 -> 文档ID（升序）
+    double scale_ = 0.0;
+};
+
+} // namespace search_engine
@@ -0,0 +1,102 @@
+#include "index/index_stats.h"
+#include <cstdio>
+#include <sstream>
+
+namespace search_engine {
+
+namespace {
+
+void appendEscaped(std::ostringstream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+            out << buffer;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+void appendComponents(std::ostringstream& out, const std::vector<ComponentStats>& components) {
+    out << "[";
+    for (size_t i = 0; i < components.size(); ++i) {
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+        appendEscaped(out, components[i].name);
+        out << ", \"entries\": " << components[i].entries << ", \"bytes\": " << components[i].bytes << "}";
+    }
+    out << (components.empty() ? "]" : "\n  ]");
+}
+
+} // namespace
+
+uint64_t IndexStats::totalBytes() const {
+    uint64_t total = inverted.totalBytes() + forward.totalBytes() + doc_values_bytes + term_dictionary_bytes +
+                     impact_index_bytes;
+    for (const auto& component : auxiliary) {
+        total += component.bytes;
+    }
+    for (const auto& cache : caches) {
+        total += cache.bytes;
+    }
+    return total;
+}
+
+std::string IndexStats::toJson() const {
+    std::ostringstream out;
+    const auto& lengths = inverted.list_lengths;
+    out << "{\n";
+    out << "  \"total_bytes\": " << totalBytes() << ",\n";
+    out << "  \"process_rss_bytes\": " << process_rss_bytes << ",\n";
+
+    out << "  \"inverted_index\": {\n"
+        << "    \"terms\": " << inverted.terms << ",\n"
+        << "    \"postings\": " << inverted.postings << ",\n"
+        << "    \"documents\": " << inverted.documents << ",\n"
+        << "    \"bytes\": " << inverted.totalBytes() << ",\n"
+        << "    \"table_bytes\": " << inverted.table_bytes << ",\n"
+        << "    \"table_allocations\": " << inverted.table_allocations << ",\n"
+        << "    \"term_bytes\": " << inverted.term_bytes << ",\n"
+        << "    \"posting_bytes\": " << inverted.posting_bytes << ",\n"
+        << "    \"posting_slack_bytes\": " << inverted.posting_slack_bytes << ",\n"
+        << "    \"doc_length_bytes\": " << inverted.doc_length_bytes << ",\n"
+        << "    \"list_lengths\": {\n"
+        << "      \"p50\": " << lengths.p50 << ", \"p90\": " << lengths.p90 << ", \"p99\": " << lengths.p99
+        << ", \"max\": " << lengths.max << ",\n"
+        << "      \"buckets\": [";
+    for (size_t i = 0; i < lengths.terms.size(); ++i) {
+        out << (i == 0 ? "\n" : ",\n") << "        {\"min\": " << (uint64_t(1) << i)
+            << ", \"max\": " << ((uint64_t(2) << i) - 1) << ", \"terms\": " << lengths.terms[i]
+            << ", \"postings\": " << lengths.postings[i] << "}";
+    }
+    out << (lengths.terms.empty() ? "]\n" : "\n      ]\n") << "    }\n  },\n";
+
+    out << "  \"forward_index\": {\n"
+        << "    \"documents\": " << forward.documents << ",\n"
+        << "    \"bytes\": " << forward.totalBytes() << ",\n"
+        << "    \"table_bytes\": " << forward.table_bytes << ",\n"
+        << "    \"table_allocations\": " << forward.table_allocations << ",\n"
+        << "    \"content_bytes\": " << forward.content_bytes << ",\n"
+        << "    \"title_bytes\": " << forward.title_bytes << ",\n"
+        << "    \"token_bytes\": " << forward.token_bytes << ",\n"
+        << "    \"token_offset_bytes\": " << forward.token_offset_bytes << ",\n"
+        << "    \"original_id_bytes\": " << forward.original_id_bytes << "\n"
+        << "  },\n";
+
+    out << "  \"doc_values\": {\"columns\": " << doc_values_columns << ", \"bytes\": " << doc_values_bytes
+        << "},\n";
+    out << "  \"term_dictionary\": {\"bytes\": " << term_dictionary_bytes << "},\n";
+    out << "  \"impact_index\": {\"bytes\": " << impact_index_bytes << "},\n";
+    out << "  \"auxiliary\": ";
+    appendComponents(out, auxiliary);
+    out << ",\n  \"caches\": ";
+    appendComponents(out, caches);
+    out << "\n}\n";
+    return out.str();
+}
+
+} // namespace search_engine
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "index/inverted_index.h"
+#include "index/forward_index.h"
+
+namespace search_engine {
+
+/**
+ * @brief 附属结构（缓存、补全索引等）的内存统计
+ */
+struct ComponentStats {
+    std::string name;
+    uint64_t entries = 0;
+    uint64_t bytes = 0;
+};
+
+/**
+ * @brief 索引内存统计报告
+ *
+ * 各结构的字节数来源：
+ * - 哈希表（倒排/正排索引的节点和桶数组）：计数分配器记录的实际分配量
+ * - vector/string：按capacity精确计算（不含malloc自身的元数据和对齐开销）
+ * 因此total_bytes略小于这些结构实际占用的常驻内存，process_rss_bytes用于对照
+ *
+ * 由IndexBuilder::collectStats()填充索引部分，缓存等由调用方追加到caches/auxiliary
+ */
+struct IndexStats {
+    InvertedIndexStats inverted;
+    ForwardIndexStats forward;
+    uint64_t doc_values_columns = 0;
+    uint64_t doc_values_bytes = 0;
+    uint64_t term_dictionary_bytes = 0;
+    uint64_t impact_index_bytes = 0;
+    std::vector<ComponentStats> auxiliary;  // 补全索引等由调用方持有的附属结构
+    std::vector<ComponentStats> caches;
+    uint64_t process_rss_bytes = 0;
+
+    /**
+     * @brief 所有结构的字节数之和
+     */
+    uint64_t totalBytes() const;
+
+    /**
+     * @brief 输出为JSON（缩进两个空格）
+     */
+    std::string toJson() const;
+};
+
+} // namespace search_engine
@@ -6,23 +6,99 @@ namespace search_engine {
 void InvertedIndex::addDocument(int64_t doc_id, const std::vector<std::string>& tokens) {
     // 统计每个term在文档中的词频
     std::unordered_map<std::string, int32_t> term_freq;
+    uint32_t length = 0;
     
     for (const auto& token : tokens) {
         if (!token.empty()) {
             term_freq[token]++;
+            length++;
         }
     }
     
     // 添加到倒排索引
     for (const auto& [term, freq] : term_freq) {
-        index_[term].emplace_back(doc_id, freq);
+        appendPosting(index_[term], doc_id, freq);
     }
     
-    // 更新文档计数（去重）
-    if (doc_set_.find(doc_id) == doc_set_.end()) {
-        doc_set_[doc_id] = true;
+    // 更新文档长度和文档计数（去重）
+    addDocLength(doc_id, length);
+}
+
+void InvertedIndex::addDocument(int64_t doc_id,
+                                const std::vector<std::pair<std::string, int32_t>>& term_freqs) {
+    uint32_t length = 0;
+    for (const auto& [term, freq] : term_freqs) {
+        appendPosting(index_[term], doc_id, freq);
+        length += static_cast<uint32_t>(freq);
+    }
+    
+    addDocLength(doc_id, length);
+}
+
+void InvertedIndex::addDocLength(int64_t doc_id, uint32_t length) {
+    auto [it, inserted] = doc_lengths_.emplace(doc_id, 0);
+    if (inserted) {
         total_docs_++;
     }
+    it->second += length;
+    total_length_ += length;
+}
+
+bool InvertedIndex::removeDocument(int64_t doc_id, const std::vector<std::string>& tokens) {
+    auto length_it = doc_lengths_.find(doc_id);
+    if (length_it == doc_lengths_.end()) {
+        return false;
+    }
+    
+    for (const auto& token : tokens) {
+        auto it = index_.find(token);
+        if (it == index_.end()) {
+            continue;  // 重复的token已在前面处理过
+        }
+        auto& postings = it->second;
+        auto pos = std::lower_bound(postings.begin(), postings.end(), doc_id,
+                                    [](const Posting& posting, int64_t id) { return posting.doc_id < id; });
+        if (pos != postings.end() && pos->doc_id == doc_id) {
+            postings.erase(pos);
+        }
+        if (postings.empty()) {
+            index_.erase(it);
+        }
+    }
+    
+    total_length_ -= length_it->second;
+    doc_lengths_.erase(length_it);
+    total_docs_--;
+    return true;
+}
+
+uint32_t InvertedIndex::getDocLength(int64_t doc_id) const {
+    auto it = doc_lengths_.find(doc_id);
+    return it != doc_lengths_.end() ? it->second : 0;
+}
+
+size_t InvertedIndex::seek(const std::vector<Posting>& postings, size_t from, int64_t target) {
+    size_t step = 1;
+    size_t hi = from;
+    while (hi < postings.size() && postings[hi].doc_id < target) {
+        from = hi + 1;
+        hi += step;
+        step <<= 1;
+    }
+    hi = std::min(hi, postings.size());
+    auto it = std::lower_bound(postings.begin() + from, postings.begin() + hi, target,
+                               [](const Posting& posting, int64_t id) { return posting.doc_id < id; });
+    return static_cast<size_t>(it - postings.begin());
+}
+
+void InvertedIndex::appendPosting(std::vector<Posting>& postings, int64_t doc_id, int32_t term_freq) {
+    if (postings.empty() || postings.back().doc_id <= doc_id) {
+        postings.emplace_back(doc_id, term_freq);
+        return;
+    }
+    auto it = std::upper_bound(postings.begin(), postings.end(), doc_id,
+                               [](int64_t id, const Posting& posting) { return id < posting.doc_id; });
+    postings.insert(it, Posting(doc_id, term_freq));
 }
 
 std::vector<Posting> InvertedIndex::search(const std::string& term) const {
@@ -33,6 +109,11 @@ std::vector<Posting> InvertedIndex::search(const std::string& term) const {
     return {};
 }
 
+const std::vector<Posting>* InvertedIndex::getPostings(const std::string& term) const {
+    auto it = index_.find(term);
+    return it != index_.end() ? &it->second : nullptr;
+}
+
 size_t InvertedIndex::getDocumentFrequency(const std::string& term) const {
     auto it = index_.find(term);
     if (it != index_.end()) {
@@ -41,10 +122,99 @@ size_t InvertedIndex::getDocumentFrequency(const std::string& term) const {
     return 0;
 }
 
+void InvertedIndex::remapDocIds(const std::unordered_map<int64_t, int64_t>& mapping) {
+    for (auto& [term, postings] : index_) {
+        for (auto& posting : postings) {
+            auto it = mapping.find(posting.doc_id);
+            if (it != mapping.end()) {
+                posting.doc_id = it->second;
+            }
+        }
+        std::sort(postings.begin(), postings.end(), [](const Posting& a, const Posting& b) {
+            return a.doc_id < b.doc_id;
+        });
+    }
+    
+    decltype(doc_lengths_) remapped;
+    remapped.reserve(doc_lengths_.size());
+    for (const auto& [doc_id, length] : doc_lengths_) {
+        auto it = mapping.find(doc_id);
+        remapped[it != mapping.end() ? it->second : doc_id] = length;
+    }
+    doc_lengths_ = std::move(remapped);
+    total_docs_ = doc_lengths_.size();
+}
+
+size_t InvertedIndex::getEncodedPostingBytes() const {
+    size_t bytes = 0;
+    for (const auto& [term, postings] : index_) {
+        int64_t previous = 0;
+        for (const auto& posting : postings) {
+            uint64_t gap = static_cast<uint64_t>(posting.doc_id - previous);
+            previous = posting.doc_id;
+            do {
+                bytes++;
+                gap >>= 7;
+            } while (gap != 0);
+        }
+    }
+    return bytes;
+}
+
+size_t InvertedIndex::getPostingCount() const {
+    size_t count = 0;
+    for (const auto& [term, postings] : index_) {
+        count += postings.size();
+    }
+    return count;
+}
+
+InvertedIndexStats InvertedIndex::collectStats() const {
+    InvertedIndexStats stats;
+    stats.terms = index_.size();
+    stats.documents = total_docs_;
+    stats.table_bytes = index_.get_allocator().counter().bytes;
+    stats.table_allocations = index_.get_allocator().counter().allocations;
+    stats.doc_length_bytes = doc_lengths_.get_allocator().counter().bytes;
+    
+    auto& distribution = stats.list_lengths;
+    std::vector<uint64_t> lengths;
+    lengths.reserve(index_.size());
+    for (const auto& [term, postings] : index_) {
+        stats.term_bytes += memory::heapBytes(term);
+        stats.posting_bytes += memory::heapBytes(postings);
+        stats.posting_slack_bytes += (postings.capacity() - postings.size()) * sizeof(Posting);
+        stats.postings += postings.size();
+        
+        size_t bucket = 0;
+        while ((uint64_t(2) << bucket) <= postings.size()) {
+            bucket++;
+        }
+        if (distribution.terms.size() <= bucket) {
+            distribution.terms.resize(bucket + 1, 0);
+            distribution.postings.resize(bucket + 1, 0);
+        }
+        distribution.terms[bucket]++;
+        distribution.postings[bucket] += postings.size();
+        lengths.push_back(postings.size());
+    }
+    
+    if (!lengths.empty()) {
+        std::sort(lengths.begin(), lengths.end());
+        auto percentile = [&lengths](double p) { return lengths[static_cast<size_t>(p * (lengths.size() - 1))]; };
+        distribution.p50 = percentile(0.50);
+        distribution.p90 = percentile(0.90);
+        distribution.p99 = percentile(0.99);
+        distribution.max = lengths.back();
+    }
+    return stats;
+}
+
 void InvertedIndex::clear() {
     index_.clear();
-    doc_set_.clear();
+    doc_lengths_.clear();
     total_docs_ = 0;
+    total_length_ = 0;
 }
 
 } // namespace search_engine
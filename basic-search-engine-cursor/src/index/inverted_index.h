@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include "common/counting_allocator.h"
 
 namespace search_engine {
 
@@ -18,6 +19,38 @@ struct Posting {
     Posting(int64_t id, int32_t tf) : doc_id(id), term_freq(tf) {}
 };
 
+/**
+ * @brief posting列表长度分布
+ *
+ * 按2的幂分桶：第i个桶统计长度在 [2^i, 2^(i+1)) 之间的列表
+ */
+struct PostingLengthDistribution {
+    std::vector<uint64_t> terms;      // 每个桶的term数
+    std::vector<uint64_t> postings;   // 每个桶的posting总数
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+    uint64_t max = 0;
+};
+
+/**
+ * @brief 倒排索引内存统计（字节）
+ */
+struct InvertedIndexStats {
+    uint64_t terms = 0;
+    uint64_t postings = 0;
+    uint64_t documents = 0;
+    uint64_t table_bytes = 0;           // term哈希表的节点和桶数组（计数分配器）
+    uint64_t table_allocations = 0;
+    uint64_t term_bytes = 0;            // 超出短字符串优化的term字符串
+    uint64_t posting_bytes = 0;         // posting列表缓冲区（按capacity）
+    uint64_t posting_slack_bytes = 0;   // 其中capacity超出size的部分
+    uint64_t doc_length_bytes = 0;      // 文档长度哈希表（计数分配器）
+    PostingLengthDistribution list_lengths;
+
+    uint64_t totalBytes() const { return table_bytes + term_bytes + posting_bytes + doc_length_bytes; }
+};
+
 /**
  * @brief 倒排索引
  * 
@@ -26,8 +59,8 @@ struct Posting {
  * 
  * 设计思路：
  * - 当前：内存中的unordered_map实现（MVP）
+ * - posting list始终按doc_id升序（按ID递增添加时为O(1)追加，乱序添加时插入到对应位置）
  * - 后续可扩展：
- *   - 支持按doc_id排序的posting list
  *   - 支持压缩存储（Delta编码、Varint）
  *   - 支持mmap持久化
  *   - 支持分片（Sharding）
@@ -44,6 +77,22 @@ public:
      */
     void addDocument(int64_t doc_id, const std::vector<std::string>& tokens);
 
+    /**
+     * @brief 添加已统计好词频的文档（批量导入时词频统计在工作线程完成）
+     * @param doc_id 文档ID
+     * @param term_freqs (term, 词频) 列表，term不重复
+     */
+    void addDocument(int64_t doc_id,
+                     const std::vector<std::pair<std::string, int32_t>>& term_freqs);
+
+    /**
+     * @brief 从倒排索引中删除文档
+     * @param doc_id 文档ID
+     * @param tokens 文档的token列表（与添加时相同，用于定位posting列表）
+     * @return 文档是否存在
+     */
+    bool removeDocument(int64_t doc_id, const std::vector<std::string>& tokens);
+
     /**
      * @brief 查询term对应的文档列表
      * @param term 查询词
@@ -51,6 +100,13 @@ public:
      */
     std::vector<Posting> search(const std::string& term) const;
 
+    /**
+     * @brief 查询term对应的posting列表（不拷贝）
+     * @param term 查询词
+     * @return posting列表指针（按doc_id升序，不存在返回nullptr），索引修改后失效
+     */
+    const std::vector<Posting>* getPostings(const std::string& term) const;
+
     /**
      * @brief 获取term的文档频率（DF）
      * @param term 查询词
@@ -64,6 +120,29 @@ public:
      */
     size_t getTotalDocuments() const { return total_docs_; }
 
+    /**
+     * @brief 获取文档长度（各term词频之和，BM25使用）
+     * @param doc_id 文档ID
+     * @return 文档长度（不存在返回0）
+     */
+    uint32_t getDocLength(int64_t doc_id) const;
+
+    /**
+     * @brief 获取平均文档长度
+     */
+    double getAverageDocLength() const {
+        return total_docs_ > 0 ? static_cast<double>(total_length_) / total_docs_ : 0.0;
+    }
+
+    /**
+     * @brief 在有序posting列表中从from开始倍增 + 二分查找
+     * @param postings posting列表（按doc_id升序）
+     * @param from 起始位置（调用方保证之前的doc_id都小于target）
+     * @param target 目标文档ID
+     * @return 第一个doc_id >= target的位置（不存在返回postings.size()）
+     */
+    static size_t seek(const std::vector<Posting>& postings, size_t from, int64_t target);
+
     /**
      * @brief 清空索引
      */
@@ -74,15 +153,66 @@ public:
      */
     size_t getTermCount() const { return index_.size(); }
 
+    /**
+     * @brief 遍历所有term（顺序不确定）
+     * @param visitor 回调（term, 文档频率）
+     */
+    template <typename Visitor>
+    void forEachTerm(Visitor&& visitor) const {
+        for (const auto& [term, postings] : index_) {
+            visitor(term, postings.size());
+        }
+    }
+
+    /**
+     * @brief 遍历所有posting列表（顺序不确定）
+     * @param visitor 回调（term, posting列表）
+     */
+    template <typename Visitor>
+    void forEachPostingList(Visitor&& visitor) const {
+        for (const auto& [term, postings] : index_) {
+            visitor(term, postings);
+        }
+    }
+
+    /**
+     * @brief 按映射重新编号文档，并把每个posting列表按新ID升序排列
+     * @param mapping 旧文档ID -> 新文档ID（需覆盖索引中的所有文档）
+     */
+    void remapDocIds(const std::unordered_map<int64_t, int64_t>& mapping);
+
+    /**
+     * @brief 估算doc_id按 "差值 + Varint" 编码后posting列表占用的字节数（不含词频）
+     * 用于衡量文档重排序对压缩率的影响
+     */
+    size_t getEncodedPostingBytes() const;
+
+    /**
+     * @brief 获取posting总数
+     */
+    size_t getPostingCount() const;
+
+    /**
+     * @brief 统计内存占用和posting列表长度分布（遍历所有term）
+     */
+    InvertedIndexStats collectStats() const;
+
 private:
+    // 按doc_id有序插入posting
+    static void appendPosting(std::vector<Posting>& postings, int64_t doc_id, int32_t term_freq);
+
     // term -> posting list 映射
-    std::unordered_map<std::string, std::vector<Posting>> index_;
+    CountedHashMap<std::string, std::vector<Posting>> index_;
     
     // 总文档数（用于计算IDF）
     size_t total_docs_ = 0;
     
-    // 文档集合（用于去重）
-    std::unordered_map<int64_t, bool> doc_set_;
+    // 文档长度（同时用于文档去重）
+    CountedHashMap<int64_t, uint32_t> doc_lengths_;
+    uint64_t total_length_ = 0;
+
+    // 记录文档长度，首次出现时计入总文档数
+    void addDocLength(int64_t doc_id, uint32_t length);
 };
 
 } // namespace search_engine
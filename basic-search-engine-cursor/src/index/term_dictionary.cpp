@@ -0,0 +1,119 @@
+#include "index/term_dictionary.h"
+#include <algorithm>
+
+namespace search_engine {
+
+void TermDictionary::build(const InvertedIndex& index) {
+    std::vector<std::string> terms;
+    terms.reserve(index.getTermCount());
+    index.forEachTerm([&terms](const std::string& term, size_t) {
+        terms.push_back(term);
+    });
+    build(std::move(terms));
+}
+
+void TermDictionary::build(std::vector<std::string> terms) {
+    clear();
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    size_t total = 0;
+    for (const auto& term : terms) {
+        total += term.size();
+    }
+    blob_.reserve(total);
+    offsets_.reserve(terms.size() + 1);
+    offsets_.push_back(0);
+    for (const auto& term : terms) {
+        blob_ += term;
+        offsets_.push_back(static_cast<uint32_t>(blob_.size()));
+    }
+}
+
+int64_t TermDictionary::find(std::string_view term) const {
+    size_t lo = 0, hi = size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (this->term(mid) < term) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo < size() && this->term(lo) == term) ? static_cast<int64_t>(lo) : -1;
+}
+
+std::pair<size_t, size_t> TermDictionary::prefixRange(std::string_view prefix) const {
+    // 第一个 >= prefix 的位置
+    size_t lo = 0, hi = size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (term(mid) < prefix) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    const size_t first = lo;
+    // 第一个不以prefix开头的位置
+    hi = size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (term(mid).substr(0, prefix.size()) == prefix) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return {first, lo};
+}
+
+size_t TermDictionary::childEnd(size_t lo, size_t hi, size_t depth) const {
+    // 区间内term共享前缀且有序，因此第depth个字节单调不减
+    const unsigned char c = static_cast<unsigned char>(term(lo)[depth]);
+    size_t left = lo + 1, right = hi;
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+        if (static_cast<unsigned char>(term(mid)[depth]) <= c) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+    return left;
+}
+
+std::pair<size_t, size_t> TermDictionary::seek(size_t lo, size_t hi, size_t depth,
+                                               std::string_view bytes) const {
+    auto suffix = [this, depth, &bytes](size_t i) {
+        std::string_view t = term(i);
+        return t.size() > depth ? t.substr(depth, bytes.size()) : std::string_view();
+    };
+    size_t left = lo, right = hi;
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+        if (suffix(mid) < bytes) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+    const size_t first = left;
+    right = hi;
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+        if (suffix(mid) <= bytes) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+    return {first, left};
+}
+
+void TermDictionary::clear() {
+    blob_.clear();
+    offsets_.clear();
+}
+
+} // namespace search_engine
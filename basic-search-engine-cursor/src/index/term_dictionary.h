@@ -0,0 +1,87 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "index/inverted_index.h"
+
+namespace search_engine {
+
+/**
+ * @brief 有序词典
+ *
+ * 按字节序排列的所有term，紧凑存储在一块连续内存中：
+ * - blob_：所有term首尾相接
+ * - offsets_：第i个term为 blob_[offsets_[i], offsets_[i+1])
+ *
+ * 设计思路：
+ * - 有序数组可以看作一棵"虚拟trie"：共享前缀的term在数组中连续，
+ *   按深度d上的字节二分即可得到子节点区间，无需额外的节点存储
+ * - 用于模糊匹配（Levenshtein自动机求交）、前缀查询等
+ * - 词典是倒排索引的快照，索引更新后需要重新build
+ */
+class TermDictionary {
+public:
+    TermDictionary() = default;
+
+    /**
+     * @brief 从倒排索引构建词典
+     * @param index 倒排索引
+     */
+    void build(const InvertedIndex& index);
+
+    /**
+     * @brief 从term列表构建词典（无需有序、可重复）
+     * @param terms term列表
+     */
+    void build(std::vector<std::string> terms);
+
+    /**
+     * @brief 获取第i个term
+     */
+    std::string_view term(size_t i) const {
+        return std::string_view(blob_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]);
+    }
+
+    /**
+     * @brief 查找term的序号
+     * @return 序号，不存在返回-1
+     */
+    int64_t find(std::string_view term) const;
+
+    /**
+     * @brief 获取以prefix开头的term区间 [first, second)
+     */
+    std::pair<size_t, size_t> prefixRange(std::string_view prefix) const;
+
+    /**
+     * @brief 在共享前缀（长度为depth）的区间[lo, hi)中，
+     *        找到第depth个字节与term(lo)相同的子区间的结束位置
+     * 要求term(lo)长度大于depth
+     */
+    size_t childEnd(size_t lo, size_t hi, size_t depth) const;
+
+    /**
+     * @brief 在共享前缀（长度为depth）的区间[lo, hi)中，
+     *        找到从第depth个字节起以bytes开头的子区间 [first, second)
+     */
+    std::pair<size_t, size_t> seek(size_t lo, size_t hi, size_t depth, std::string_view bytes) const;
+
+    size_t size() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief 占用的字节数（字符串池 + 偏移数组，按capacity）
+     */
+    size_t bytes() const { return blob_.capacity() + offsets_.capacity() * sizeof(uint32_t); }
+
+    void clear();
+
+private:
+    std::string blob_;
+    std::vector<uint32_t> offsets_;
+};
+
+} // namespace search_engine
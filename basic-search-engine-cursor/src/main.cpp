@@ -1,13 +1,34 @@
 #include <iostream>
 #include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
 #include "storage/index_builder.h"
+#include "storage/bulk_loader.h"
 #include "query/search_engine.h"
 #include "index/forward_index.h"
+#include "index/completion_trie.h"
 
 using namespace search_engine;
 
-void printSearchResults(const std::vector<SearchResult>& results, 
-                       const ForwardIndex& forward_index) {
+/**
+ * @brief 用【】标出摘要中的高亮词
+ */
+std::string renderSnippet(const SearchResult& result) {
+    std::string rendered;
+    size_t pos = 0;
+    for (const auto& span : result.highlights) {
+        rendered.append(result.snippet, pos, span.begin - pos);
+        rendered += "【";
+        rendered.append(result.snippet, span.begin, span.end - span.begin);
+        rendered += "】";
+        pos = span.end;
+    }
+    rendered.append(result.snippet, pos, std::string::npos);
+    return rendered;
+}
+
+void printSearchResults(const std::vector<SearchResult>& results, const ForwardIndex& forward_index) {
     if (results.empty()) {
         std::cout << "未找到相关文档\n" << std::endl;
         return;
@@ -17,22 +38,100 @@ void printSearchResults(const std::vector<SearchResult>& results,
     
     for (size_t i = 0; i < results.size(); ++i) {
         const auto& result = results[i];
-        auto doc = forward_index.getDocument(result.doc_id);
         
-        std::cout << "[" << (i + 1) << "] 文档ID: " << result.doc_id 
+        std::cout << "[" << (i + 1) << "] 文档ID: " << forward_index.getOriginalDocId(result.doc_id)
                   << " | 分数: " << std::fixed << std::setprecision(4) << result.score << std::endl;
         
-        // 显示文档内容（截取前100个字符）
-        std::string content = doc.content;
-        if (content.length() > 100) {
-            content = content.substr(0, 100) + "...";
-        }
-        std::cout << "    内容: " << content << std::endl;
+        // 显示查询相关的摘要
+        std::cout << "    内容: " << renderSnippet(result) << std::endl;
         std::cout << std::endl;
     }
 }
 
-int main() {
+/**
+ * @brief 执行查询，精确匹配无结果时回退到容错匹配
+ */
+void runQuery(const SearchEngine& engine, const ForwardIndex& forward_index, const std::string& query) {
+    // 单次查询最多100ms，超时返回已完成的部分结果
+    QueryContext context(std::chrono::milliseconds(100));
+    auto results = engine.search(query, 5, context);
+    if (context.timedOut()) {
+        std::cout << "（查询超时，以下为部分结果）" << std::endl;
+    } else if (results.empty()) {
+        results = engine.searchFuzzy(query, 5);
+        if (!results.empty()) {
+            std::cout << "（精确匹配无结果，以下为容错匹配结果）" << std::endl;
+        }
+    }
+    printSearchResults(results, forward_index);
+}
+
+/**
+ * @brief 打印前缀补全建议
+ */
+void printCompletions(const CompletionTrie& completion, const std::string& prefix) {
+    std::vector<Completion> suggestions;
+    if (completion.complete(prefix, 5, suggestions) == 0) {
+        std::cout << "没有补全建议\n" << std::endl;
+        return;
+    }
+    for (const auto& suggestion : suggestions) {
+        std::cout << "    " << suggestion.text << " (" << suggestion.weight << ")" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief 从JSONL/TSV语料批量构建索引
+ */
+bool loadCorpus(IndexBuilder& builder, const std::string& path, const std::string& format) {
+    BulkLoadOptions options;
+    options.format = (format == "tsv") ? CorpusFormat::kTsv : CorpusFormat::kJsonLines;
+    options.progress_callback = [](const BulkLoadStats& stats) {
+        double percent = stats.total_bytes > 0 ? 100.0 * stats.bytes_processed / stats.total_bytes : 100.0;
+        std::cout << "  进度: " << std::fixed << std::setprecision(1) << percent << "% | "
+                  << stats.docs_indexed << " 篇文档 | "
+                  << std::setprecision(1) << stats.megabytesPerSecond() << " MB/s | "
+                  << std::setprecision(0) << stats.docsPerSecond() << " docs/s" << std::endl;
+    };
+    
+    BulkLoader loader(builder);
+    if (!loader.load(path, options)) {
+        std::cerr << "语料加载失败: " << loader.lastError() << std::endl;
+        return false;
+    }
+    
+    const auto& stats = loader.stats();
+    std::cout << "导入完成: " << stats.docs_indexed << " 篇文档, 跳过格式错误记录 "
+              << stats.malformed << " 条, 跳过重复ID记录 " << stats.duplicate_ids
+              << " 条, 用时 " << std::setprecision(2) << stats.elapsed_seconds << " 秒" << std::endl;
+    return true;
+}
+
+/**
+ * @brief 输出内存统计JSON（path为"-"时输出到标准输出）
+ */
+bool dumpStats(const IndexBuilder& builder, const SearchEngine& engine, const CompletionTrie& completion,
+               const std::string& path) {
+    IndexStats stats = builder.collectStats();
+    stats.auxiliary.push_back({"completion_trie", completion.size(), completion.bytes()});
+    const FilterCache& filter_cache = engine.getFilterCache();
+    stats.caches.push_back({"filter_cache", filter_cache.size(), filter_cache.bytes()});
+    if (path == "-") {
+        std::cout << stats.toJson();
+        return true;
+    }
+    std::ofstream file(path);
+    file << stats.toJson();
+    if (!file) {
+        std::cerr << "写入内存统计失败: " << path << std::endl;
+        return false;
+    }
+    std::cout << "内存统计已写入 " << path << "（索引结构共 " << stats.totalBytes() << " 字节）\n" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
     std::cout << "========================================" << std::endl;
     std::cout << "   基础搜索引擎 Demo (C++17)" << std::endl;
     std::cout << "========================================\n" << std::endl;
@@ -43,14 +142,50 @@ int main() {
     // 2. 添加示例文档
     std::cout << "正在构建索引..." << std::endl;
     
-    builder.addDocument(Document(1, "政采云 技术 团队 欢迎 你"));
-    builder.addDocument(Document(2, "原创 干货 技术 氛围 很好"));
-    builder.addDocument(Document(3, "搜索引擎 技术 实现 倒排索引"));
-    builder.addDocument(Document(4, "C++ 编程 语言 高性能"));
-    builder.addDocument(Document(5, "腾讯 WXG 搜索 团队 图片搜一搜"));
-    builder.addDocument(Document(6, "AI 大模型 生成式 搜索"));
-    builder.addDocument(Document(7, "向量检索 倒排索引 混合搜索"));
-    builder.addDocument(Document(8, "技术 分享 学习 成长"));
+    // 用法: search_demo [语料文件] [jsonl|tsv] [--reorder] [--stats-json 文件|-]
+    std::vector<std::string> args;
+    bool reorder = false;
+    std::string stats_path;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--reorder") {
+            reorder = true;
+        } else if (arg == "--stats-json" && i + 1 < argc) {
+            stats_path = argv[++i];
+        } else {
+            args.push_back(arg);
+        }
+    }
+    const bool use_corpus = !args.empty();
+    if (use_corpus) {
+        if (!loadCorpus(builder, args[0], args.size() > 1 ? args[1] : "jsonl")) {
+            return 1;
+        }
+    } else {
+        builder.addDocument(Document(1, "政采云 技术 团队 欢迎 你"));
+        builder.addDocument(Document(2, "原创 干货 技术 氛围 很好"));
+        builder.addDocument(Document(3, "搜索引擎 技术 实现 倒排索引"));
+        builder.addDocument(Document(4, "C++ 编程 语言 高性能"));
+        builder.addDocument(Document(5, "腾讯 WXG 搜索 团队 图片搜一搜"));
+        builder.addDocument(Document(6, "AI 大模型 生成式 搜索"));
+        builder.addDocument(Document(7, "向量检索 倒排索引 混合搜索"));
+        builder.addDocument(Document(8, "技术 分享 学习 成长"));
+        
+        // 示例文档的属性（发布年份），用于属性过滤和按字段排序
+        const int64_t years[] = {2021, 2023, 2022, 2020, 2024, 2024, 2023, 2022};
+        for (int64_t doc_id = 1; doc_id <= 8; ++doc_id) {
+            builder.getDocValues().setInt(doc_id, "year", years[doc_id - 1]);
+        }
+    }
+    
+    // 可选：按内容相似度重排文档ID，缩小posting列表
+    if (reorder) {
+        ReorderStats stats = builder.reorderDocuments();
+        std::cout << "文档重排序完成: posting列表 " << stats.posting_bytes_before << " -> "
+                  << stats.posting_bytes_after << " 字节 (" << std::fixed << std::setprecision(2)
+                  << stats.bitsPerPostingBefore() << " -> " << stats.bitsPerPostingAfter()
+                  << " bits/posting), 用时 " << stats.elapsed_seconds << " 秒" << std::endl;
+    }
     
     std::cout << "索引构建完成！" << std::endl;
     std::cout << "总文档数: " << builder.getForwardIndex().size() << std::endl;
@@ -61,34 +196,78 @@ int main() {
     SearchEngine engine;
     engine.setInvertedIndex(&builder.getInvertedIndex());
     engine.setForwardIndex(&builder.getForwardIndex());
+    engine.setTermDictionary(&builder.buildTermDictionary());
+    engine.setDocValues(&builder.getDocValues());
+    
+    // 前缀补全索引（以term的文档频率为权重）
+    CompletionTrie completion;
+    completion.build(builder.getInvertedIndex());
     
     // 4. 执行搜索
-    std::vector<std::string> test_queries = {
-        "技术",
-        "搜索",
-        "技术 团队",
-        "AI 大模型",
-        "C++ 编程"
-    };
+    // 示例查询只针对内置的示例文档
+    std::vector<std::string> test_queries;
+    if (!use_corpus) {
+        test_queries = {
+            "技术",
+            "搜索",
+            "技术 团队",
+            "AI 大模型",
+            "C++ 编程",
+            "搜索引鲸"
+        };
+    }
     
     for (const auto& query : test_queries) {
         std::cout << "========================================" << std::endl;
         std::cout << "查询: \"" << query << "\"" << std::endl;
         std::cout << "========================================" << std::endl;
         
-        auto results = engine.search(query, 5);
-        printSearchResults(results, builder.getForwardIndex());
+        runQuery(engine, builder.getForwardIndex(), query);
+    }
+    
+    // 属性过滤 + 按字段排序：2022年以后的“技术”文档，按年份从新到旧
+    if (!use_corpus) {
+        std::cout << "========================================" << std::endl;
+        std::cout << "查询: \"技术\" | year >= 2022 | 按year降序" << std::endl;
+        std::cout << "========================================" << std::endl;
+        
+        SearchOptions options;
+        options.filters.push_back(Filter::intRange("year", 2022, INT64_MAX));
+        options.sort_field = "year";
+        std::string error;
+        if (!engine.validateOptions(options, &error)) {
+            std::cerr << "搜索选项无效: " << error << std::endl;
+        }
+        printSearchResults(engine.search("技术", 5, options), builder.getForwardIndex());
+        
+        // 分面：“技术”全部匹配文档按年份计数（不打分）
+        SearchOptions facet_options;
+        facet_options.facets.push_back(FacetRequest::histogram("year", 1));
+        std::vector<FacetResult> facets;
+        engine.search("技术", 0, facet_options, &facets);
+        std::cout << "按年份分面:";
+        for (const auto& bucket : facets[0].buckets) {
+            std::cout << " " << static_cast<int64_t>(bucket.key) << "(" << bucket.count << ")";
+        }
+        std::cout << "\n" << std::endl;
+    }
+    
+    // 内存统计（示例查询之后，过滤缓存中已有条目）
+    if (!stats_path.empty()) {
+        dumpStats(builder, engine, completion, stats_path);
     }
     
     // 5. 交互式搜索
     std::cout << "\n========================================" << std::endl;
-    std::cout << "进入交互式搜索模式 (输入 'quit' 退出)" << std::endl;
+    std::cout << "进入交互式搜索模式 (输入 'quit' 退出，以 '*' 结尾查看补全建议)" << std::endl;
     std::cout << "========================================\n" << std::endl;
     
     std::string user_query;
     while (true) {
         std::cout << "请输入查询: ";
-        std::getline(std::cin, user_query);
+        if (!std::getline(std::cin, user_query)) {
+            break;
+        }
         
         if (user_query == "quit" || user_query == "exit" || user_query == "q") {
             break;
@@ -98,8 +277,12 @@ int main() {
             continue;
         }
         
-        auto results = engine.search(user_query, 5);
-        printSearchResults(results, builder.getForwardIndex());
+        if (user_query.back() == '*') {
+            printCompletions(completion, user_query.substr(0, user_query.size() - 1));
+            continue;
+        }
+        
+        runQuery(engine, builder.getForwardIndex(), user_query);
     }
     
     std::cout << "\n感谢使用！" << std::endl;
@@ -0,0 +1,238 @@
+#include "query/doc_filter.h"
+#include "common/counting_allocator.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace search_engine {
+
+void DocBitset::intersectWith(const DocBitset& other) {
+    size_ = std::min(size_, other.size_);
+    words_.resize((size_ + 63) / 64);
+    for (size_t i = 0; i < words_.size(); ++i) {
+        words_[i] &= other.words_[i];
+    }
+    recount();
+}
+
+void DocBitset::recount() {
+    count_ = 0;
+    for (uint64_t word : words_) {
+        count_ += static_cast<size_t>(__builtin_popcountll(word));
+    }
+}
+
+size_t DocBitset::nextSetBit(size_t doc_id) const {
+    if (doc_id >= size_) {
+        return size_;
+    }
+    size_t index = doc_id >> 6;
+    uint64_t word = words_[index] & (~uint64_t(0) << (doc_id & 63));
+    while (word == 0) {
+        if (++index >= words_.size()) {
+            return size_;
+        }
+        word = words_[index];
+    }
+    return std::min(size_, index * 64 + static_cast<size_t>(__builtin_ctzll(word)));
+}
+
+Filter Filter::intRange(std::string field, int64_t min, int64_t max) {
+    Filter filter(std::move(field), Kind::kIntRange);
+    filter.int_min_ = min;
+    filter.int_max_ = max;
+    return filter;
+}
+
+Filter Filter::doubleRange(std::string field, double min, double max) {
+    Filter filter(std::move(field), Kind::kDoubleRange);
+    filter.double_min_ = min;
+    filter.double_max_ = max;
+    return filter;
+}
+
+Filter Filter::equals(std::string field, std::string keyword) {
+    return anyOf(std::move(field), {std::move(keyword)});
+}
+
+Filter Filter::anyOf(std::string field, std::vector<std::string> keywords) {
+    Filter filter(std::move(field), Kind::kKeywords);
+    std::sort(keywords.begin(), keywords.end());
+    keywords.erase(std::unique(keywords.begin(), keywords.end()), keywords.end());
+    filter.keywords_ = std::move(keywords);
+    return filter;
+}
+
+namespace {
+
+// 浮点数按位模式编码，保证不同的值得到不同的键（std::to_string只保留6位小数）
+std::string doubleKey(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return std::to_string(bits);
+}
+
+} // namespace
+
+std::string Filter::key() const {
+    // 字段名中可能出现任意字符，用长度前缀分隔
+    std::string key = std::to_string(field_.size()) + ":" + field_;
+    switch (kind_) {
+        case Kind::kIntRange:
+            key += "|i|" + std::to_string(int_min_) + "|" + std::to_string(int_max_);
+            break;
+        case Kind::kDoubleRange:
+            key += "|d|" + doubleKey(double_min_) + "|" + doubleKey(double_max_);
+            break;
+        case Kind::kKeywords:
+            key += "|k";
+            for (const auto& keyword : keywords_) {
+                key += "|" + std::to_string(keyword.size()) + ":" + keyword;
+            }
+            break;
+    }
+    return key;
+}
+
+bool Filter::compile(const DocValues& doc_values, DocBitset& bitset) const {
+    const DocValuesColumn* column = doc_values.column(field_);
+    if (!column) {
+        bitset = DocBitset();
+        return false;
+    }
+
+    const size_t size = column->size();
+    bitset = DocBitset(size);
+    const std::vector<uint64_t>& present = column->presence();
+    std::vector<uint64_t>& words = bitset.words();
+
+    // 按64个文档一组扫描：先取有值的位，再逐位判断条件
+    auto scan = [&](auto&& match) {
+        for (size_t w = 0; w < words.size(); ++w) {
+            uint64_t candidates = present[w];
+            uint64_t result = 0;
+            while (candidates != 0) {
+                const size_t bit = static_cast<size_t>(__builtin_ctzll(candidates));
+                candidates &= candidates - 1;
+                if (match(w * 64 + bit)) {
+                    result |= uint64_t(1) << bit;
+                }
+            }
+            words[w] = result;
+        }
+    };
+
+    switch (column->type()) {
+        case DocValueType::kInt64: {
+            const int64_t* values = column->ints();
+            if (kind_ == Kind::kIntRange) {
+                scan([&](size_t doc) { return values[doc] >= int_min_ && values[doc] <= int_max_; });
+            } else if (kind_ == Kind::kDoubleRange) {
+                scan([&](size_t doc) {
+                    double value = static_cast<double>(values[doc]);
+                    return value >= double_min_ && value <= double_max_;
+                });
+            } else {
+                return false;
+            }
+            break;
+        }
+        case DocValueType::kDouble: {
+            const double* values = column->doubles();
+            double min = kind_ == Kind::kIntRange ? static_cast<double>(int_min_) : double_min_;
+            double max = kind_ == Kind::kIntRange ? static_cast<double>(int_max_) : double_max_;
+            if (kind_ == Kind::kKeywords) {
+                return false;
+            }
+            scan([&](size_t doc) { return values[doc] >= min && values[doc] <= max; });
+            break;
+        }
+        case DocValueType::kKeyword: {
+            if (kind_ != Kind::kKeywords) {
+                return false;
+            }
+            // 关键字先转成序号集合，扫描时只查一张小表
+            std::vector<uint8_t> accepted(column->cardinality(), 0);
+            bool any = false;
+            for (const auto& keyword : keywords_) {
+                uint32_t ordinal = column->findOrdinal(keyword);
+                if (ordinal != DocValuesColumn::kMissingOrdinal) {
+                    accepted[ordinal] = 1;
+                    any = true;
+                }
+            }
+            if (!any) {
+                break;
+            }
+            const uint32_t* ordinals = column->ordinals();
+            scan([&](size_t doc) { return accepted[ordinals[doc]] != 0; });
+            break;
+        }
+    }
+    bitset.recount();
+    return true;
+}
+
+std::shared_ptr<const DocBitset> FilterCache::get(const Filter& filter, const DocValues& doc_values) {
+    const std::string key = filter.key();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (source_ != &doc_values || version_ != doc_values.version()) {
+            entries_.clear();
+            source_ = &doc_values;
+            version_ = doc_values.version();
+        }
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            hits_++;
+            return it->second;
+        }
+        misses_++;
+    }
+
+    // 编译不持锁（并发未命中时可能重复编译同一条件，结果相同）
+    auto bitset = std::make_shared<DocBitset>();
+    filter.compile(doc_values, *bitset);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (source_ == &doc_values && version_ == doc_values.version()) {
+        if (entries_.size() >= capacity_) {
+            entries_.clear();
+        }
+        entries_.emplace(key, bitset);
+    }
+    return bitset;
+}
+
+size_t FilterCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t FilterCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+size_t FilterCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t FilterCache::bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t total = 0;
+    for (const auto& [key, bitset] : entries_) {
+        total += memory::heapBytes(key) + memory::heapBytes(bitset->words());
+    }
+    return total;
+}
+
+void FilterCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    hits_ = 0;
+    misses_ = 0;
+}
+
+} // namespace search_engine
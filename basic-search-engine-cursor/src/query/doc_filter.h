@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "index/doc_values.h"
+
+namespace search_engine {
+
+/**
+ * @brief 按doc_id寻址的位图
+ */
+class DocBitset {
+public:
+    DocBitset() = default;
+    explicit DocBitset(size_t size) : size_(size), words_((size + 63) / 64, 0) {}
+
+    size_t size() const { return size_; }
+
+    bool test(int64_t doc_id) const {
+        return doc_id >= 0 && static_cast<size_t>(doc_id) < size_ &&
+               ((words_[doc_id >> 6] >> (doc_id & 63)) & 1);
+    }
+
+    void set(size_t doc_id) { words_[doc_id >> 6] |= uint64_t(1) << (doc_id & 63); }
+
+    /**
+     * @brief 置位的文档数（compile时计算并缓存）
+     */
+    size_t count() const { return count_; }
+
+    /**
+     * @brief 与另一个位图求交（结果长度取较短者）
+     */
+    void intersectWith(const DocBitset& other);
+
+    /**
+     * @brief 重新统计置位数
+     */
+    void recount();
+
+    /**
+     * @brief 找到 >= doc_id 的第一个置位（不存在返回size()）
+     */
+    size_t nextSetBit(size_t doc_id) const;
+
+    const std::vector<uint64_t>& words() const { return words_; }
+    std::vector<uint64_t>& words() { return words_; }
+
+private:
+    size_t size_ = 0;
+    size_t count_ = 0;
+    std::vector<uint64_t> words_;
+};
+
+/**
+ * @brief 属性过滤条件
+ *
+ * 条件在查询时编译成位图（FilterCache缓存），在求交阶段与posting列表一起推进，
+ * 不在打分之后再过滤
+ */
+class Filter {
+public:
+    enum class Kind {
+        kIntRange,      // min <= 整数值 <= max
+        kDoubleRange,   // min <= 数值 <= max
+        kKeywords       // 关键字属于给定集合
+    };
+
+    /**
+     * @brief 整数范围 [min, max]（也可用于浮点列）
+     */
+    static Filter intRange(std::string field, int64_t min, int64_t max);
+
+    /**
+     * @brief 浮点范围 [min, max]（也可用于整数列）
+     */
+    static Filter doubleRange(std::string field, double min, double max);
+
+    /**
+     * @brief 整数相等
+     */
+    static Filter equals(std::string field, int64_t value) { return intRange(std::move(field), value, value); }
+
+    /**
+     * @brief 关键字相等
+     */
+    static Filter equals(std::string field, std::string keyword);
+
+    /**
+     * @brief 关键字属于集合
+     */
+    static Filter anyOf(std::string field, std::vector<std::string> keywords);
+
+    const std::string& field() const { return field_; }
+    Kind kind() const { return kind_; }
+
+    /**
+     * @brief 规范化的缓存键
+     */
+    std::string key() const;
+
+    /**
+     * @brief 编译成位图
+     * @param doc_values 文档属性
+     * @param bitset 输出位图
+     * @return 字段不存在或类型不支持时返回false（位图为空，即不匹配任何文档）
+     */
+    bool compile(const DocValues& doc_values, DocBitset& bitset) const;
+
+private:
+    Filter(std::string field, Kind kind) : field_(std::move(field)), kind_(kind) {}
+
+    std::string field_;
+    Kind kind_;
+    int64_t int_min_ = 0;
+    int64_t int_max_ = 0;
+    double double_min_ = 0.0;
+    double double_max_ = 0.0;
+    std::vector<std::string> keywords_;
+};
+
+/**
+ * @brief 过滤位图缓存（线程安全）
+ *
+ * 以Filter::key()为键缓存编译好的位图，DocValues的版本变化时整体失效；
+ * 条目数超过容量时清空重建（过滤条件通常来自有限的UI选项，命中率高）
+ */
+class FilterCache {
+public:
+    explicit FilterCache(size_t capacity = 256) : capacity_(capacity) {}
+
+    /**
+     * @brief 获取过滤条件对应的位图（未命中时编译并缓存）
+     */
+    std::shared_ptr<const DocBitset> get(const Filter& filter, const DocValues& doc_values);
+
+    size_t hits() const;
+    size_t misses() const;
+
+    /**
+     * @brief 缓存的条目数 / 位图占用的字节数
+     */
+    size_t size() const;
+    size_t bytes() const;
+
+    void clear();
+
+private:
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    const DocValues* source_ = nullptr;
+    uint64_t version_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    std::unordered_map<std::string, std::shared_ptr<const DocBitset>> entries_;
+};
+
+} // namespace search_engine
@@ -0,0 +1,312 @@
+#include "query/facet_collector.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+namespace search_engine {
+
+namespace {
+
+// 直方图稠密计数数组的最大桶数，超过后新桶放进哈希表
+const size_t kMaxDenseBuckets = 1 << 16;
+
+// 超出该范围的桶号视为无法分桶（避免double转int64溢出）
+const double kMaxBucket = 4.0e18;
+
+/**
+ * @brief 直方图桶计数：以base为起点的稠密数组，按需向两侧扩展
+ */
+class BucketCounter {
+public:
+    void add(int64_t bucket, uint64_t count = 1) {
+        if (bucket >= base_ && bucket - base_ < static_cast<int64_t>(dense_.size())) {
+            dense_[bucket - base_] += count;
+        } else if (grow(bucket)) {
+            dense_[bucket - base_] += count;
+        } else {
+            sparse_[bucket] += count;
+        }
+    }
+
+    void merge(const BucketCounter& other) {
+        other.forEach([this](int64_t bucket, uint64_t count) { add(bucket, count); });
+    }
+
+    template <typename Func>
+    void forEach(Func&& func) const {
+        for (size_t i = 0; i < dense_.size(); ++i) {
+            if (dense_[i] > 0) {
+                func(base_ + static_cast<int64_t>(i), dense_[i]);
+            }
+        }
+        for (const auto& [bucket, count] : sparse_) {
+            func(bucket, count);
+        }
+    }
+
+private:
+    bool grow(int64_t bucket) {
+        if (dense_.empty()) {
+            base_ = bucket;
+            dense_.assign(1, 0);
+            return true;
+        }
+        const int64_t high = base_ + static_cast<int64_t>(dense_.size()) - 1;
+        const int64_t new_low = std::min(base_, bucket);
+        const int64_t new_high = std::max(high, bucket);
+        const uint64_t span = static_cast<uint64_t>(new_high - new_low) + 1;
+        if (span > kMaxDenseBuckets) {
+            return false;
+        }
+        // 向扩展方向多留一半余量，值单调变化时扩展次数为对数级
+        const int64_t headroom = static_cast<int64_t>(std::min<uint64_t>(span / 2, kMaxDenseBuckets - span));
+        const int64_t low = bucket < base_ ? new_low - headroom : new_low;
+        const size_t size = static_cast<size_t>(new_high - low + 1) + (bucket > high ? headroom : 0);
+        std::vector<uint64_t> dense(size, 0);
+        std::copy(dense_.begin(), dense_.end(), dense.begin() + (base_ - low));
+        dense_ = std::move(dense);
+        base_ = low;
+        return true;
+    }
+
+    int64_t base_ = 0;
+    std::vector<uint64_t> dense_;
+    std::unordered_map<int64_t, uint64_t> sparse_;
+};
+
+/**
+ * @brief 单个请求在一个线程内的计数器
+ */
+struct PartialFacet {
+    std::vector<uint64_t> ordinal_counts;   // kTerms：按关键字序号计数
+    BucketCounter buckets;                  // kHistogram
+    uint64_t missing = 0;
+    uint64_t count = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double sum = 0.0;
+
+    void merge(const PartialFacet& other) {
+        if (ordinal_counts.size() < other.ordinal_counts.size()) {
+            ordinal_counts.resize(other.ordinal_counts.size(), 0);
+        }
+        for (size_t i = 0; i < other.ordinal_counts.size(); ++i) {
+            ordinal_counts[i] += other.ordinal_counts[i];
+        }
+        buckets.merge(other.buckets);
+        missing += other.missing;
+        count += other.count;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        sum += other.sum;
+    }
+};
+
+bool isNumeric(const DocValuesColumn& column) {
+    return column.type() == DocValueType::kInt64 || column.type() == DocValueType::kDouble;
+}
+
+// 请求与列类型是否匹配
+bool supports(const FacetRequest& request, const DocValuesColumn* column) {
+    if (!column) {
+        return false;
+    }
+    if (request.kind() == FacetRequest::Kind::kTerms) {
+        return column->type() == DocValueType::kKeyword;
+    }
+    if (request.kind() == FacetRequest::Kind::kHistogram && !(request.interval() > 0.0)) {
+        return false;
+    }
+    return isNumeric(*column);
+}
+
+// 对[begin, end)区间内的匹配文档累加单个请求的计数
+void collectRange(const FacetRequest& request, const DocValuesColumn& column,
+                  const int64_t* docs, size_t begin, size_t end, PartialFacet& partial) {
+    switch (request.kind()) {
+        case FacetRequest::Kind::kTerms: {
+            // 列内无值的位置序号为kMissingOrdinal，不需要再测试存在位图
+            const uint32_t* ordinals = column.ordinals();
+            const size_t size = column.size();
+            partial.ordinal_counts.assign(column.cardinality(), 0);
+            for (size_t i = begin; i < end; ++i) {
+                const int64_t doc_id = docs[i];
+                const uint32_t ordinal = (doc_id >= 0 && static_cast<size_t>(doc_id) < size)
+                                             ? ordinals[doc_id] : DocValuesColumn::kMissingOrdinal;
+                if (ordinal == DocValuesColumn::kMissingOrdinal) {
+                    partial.missing++;
+                } else {
+                    partial.ordinal_counts[ordinal]++;
+                }
+            }
+            break;
+        }
+        case FacetRequest::Kind::kHistogram: {
+            const double interval = request.interval();
+            const double offset = request.offset();
+            for (size_t i = begin; i < end; ++i) {
+                if (!column.hasValue(docs[i])) {
+                    partial.missing++;
+                    continue;
+                }
+                const double bucket = std::floor((column.numericValue(docs[i]) - offset) / interval);
+                if (!(std::fabs(bucket) <= kMaxBucket)) {
+                    partial.missing++;
+                    continue;
+                }
+                partial.buckets.add(static_cast<int64_t>(bucket));
+            }
+            break;
+        }
+        case FacetRequest::Kind::kStats: {
+            for (size_t i = begin; i < end; ++i) {
+                if (!column.hasValue(docs[i])) {
+                    partial.missing++;
+                    continue;
+                }
+                const double value = column.numericValue(docs[i]);
+                partial.count++;
+                partial.min = std::min(partial.min, value);
+                partial.max = std::max(partial.max, value);
+                partial.sum += value;
+            }
+            break;
+        }
+    }
+}
+
+// 把合并后的计数器整理成结果
+void finish(const FacetRequest& request, const DocValuesColumn& column,
+            PartialFacet& partial, FacetResult& result) {
+    result.missing = partial.missing;
+    switch (request.kind()) {
+        case FacetRequest::Kind::kTerms: {
+            std::vector<std::pair<uint32_t, uint64_t>> counts;
+            uint64_t total = 0;
+            for (uint32_t ordinal = 0; ordinal < partial.ordinal_counts.size(); ++ordinal) {
+                if (partial.ordinal_counts[ordinal] > 0) {
+                    counts.emplace_back(ordinal, partial.ordinal_counts[ordinal]);
+                    total += partial.ordinal_counts[ordinal];
+                }
+            }
+            // 数量降序，同数量按关键字升序
+            const size_t keep = request.size() == 0 ? counts.size() : std::min(request.size(), counts.size());
+            std::partial_sort(counts.begin(), counts.begin() + keep, counts.end(),
+                              [&column](const auto& a, const auto& b) {
+                                  if (a.second != b.second) {
+                                      return a.second > b.second;
+                                  }
+                                  return column.keyword(a.first) < column.keyword(b.first);
+                              });
+            for (size_t i = 0; i < keep; ++i) {
+                FacetBucket bucket;
+                bucket.label = column.keyword(counts[i].first);
+                bucket.count = counts[i].second;
+                total -= bucket.count;
+                result.buckets.push_back(std::move(bucket));
+            }
+            result.other = total;
+            break;
+        }
+        case FacetRequest::Kind::kHistogram: {
+            partial.buckets.forEach([&](int64_t index, uint64_t count) {
+                FacetBucket bucket;
+                bucket.key = request.offset() + static_cast<double>(index) * request.interval();
+                bucket.count = count;
+                result.buckets.push_back(std::move(bucket));
+            });
+            std::sort(result.buckets.begin(), result.buckets.end(),
+                      [](const FacetBucket& a, const FacetBucket& b) { return a.key < b.key; });
+            break;
+        }
+        case FacetRequest::Kind::kStats: {
+            result.count = partial.count;
+            if (partial.count > 0) {
+                result.min = partial.min;
+                result.max = partial.max;
+                result.sum = partial.sum;
+            }
+            break;
+        }
+    }
+}
+
+} // namespace
+
+FacetRequest FacetRequest::terms(std::string field, size_t size) {
+    FacetRequest request(std::move(field), Kind::kTerms);
+    request.size_ = size;
+    return request;
+}
+
+FacetRequest FacetRequest::histogram(std::string field, double interval, double offset) {
+    FacetRequest request(std::move(field), Kind::kHistogram);
+    request.interval_ = interval;
+    request.offset_ = offset;
+    return request;
+}
+
+FacetRequest FacetRequest::stats(std::string field) {
+    return FacetRequest(std::move(field), Kind::kStats);
+}
+
+std::vector<FacetResult> FacetCollector::collect(const std::vector<int64_t>& doc_ids,
+                                                 const DocValues& doc_values) const {
+    std::vector<FacetResult> results(requests_.size());
+    std::vector<const DocValuesColumn*> columns(requests_.size(), nullptr);
+    for (size_t r = 0; r < requests_.size(); ++r) {
+        results[r].field = requests_[r].field();
+        results[r].kind = requests_[r].kind();
+        const DocValuesColumn* column = doc_values.column(requests_[r].field());
+        if (supports(requests_[r], column)) {
+            columns[r] = column;
+            results[r].valid = true;
+        } else {
+            results[r].missing = doc_ids.size();
+        }
+    }
+
+    // 每个线程处理一段匹配文档，计数器各自独立
+    auto collectChunk = [&](size_t begin, size_t end, std::vector<PartialFacet>& partials) {
+        for (size_t r = 0; r < requests_.size(); ++r) {
+            if (columns[r]) {
+                collectRange(requests_[r], *columns[r], doc_ids.data(), begin, end, partials[r]);
+            }
+        }
+    };
+
+    size_t threads = std::min<size_t>(options_.max_threads,
+                                      std::max<unsigned>(1, std::thread::hardware_concurrency()));
+    if (doc_ids.size() < options_.parallel_threshold) {
+        threads = 1;
+    }
+    const size_t chunk = (doc_ids.size() + threads - 1) / std::max<size_t>(threads, 1);
+
+    std::vector<std::vector<PartialFacet>> partials(threads, std::vector<PartialFacet>(requests_.size()));
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads && t * chunk < doc_ids.size(); ++t) {
+        const size_t begin = t * chunk;
+        const size_t end = std::min(begin + chunk, doc_ids.size());
+        workers.emplace_back([&, t, begin, end]() { collectChunk(begin, end, partials[t]); });
+    }
+    collectChunk(0, std::min(chunk, doc_ids.size()), partials[0]);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // 合并各线程的计数
+    for (size_t r = 0; r < requests_.size(); ++r) {
+        if (!columns[r]) {
+            continue;
+        }
+        for (size_t t = 1; t < partials.size(); ++t) {
+            partials[0][r].merge(partials[t][r]);
+        }
+        finish(requests_[r], *columns[r], partials[0][r], results[r]);
+    }
+    return results;
+}
+
+} // namespace search_engine
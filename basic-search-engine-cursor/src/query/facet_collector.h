@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "index/doc_values.h"
+
+namespace search_engine {
+
+/**
+ * @brief 分面/聚合请求
+ */
+class FacetRequest {
+public:
+    enum class Kind {
+        kTerms,       // 关键字计数（按数量取前size个）
+        kHistogram,   // 数值直方图（固定宽度分桶，时间戳按天/小时分桶也用它）
+        kStats        // 数值统计（count/min/max/sum）
+    };
+
+    /**
+     * @brief 关键字计数
+     * @param field 关键字字段
+     * @param size 返回数量最多的前size个值（0表示全部）
+     */
+    static FacetRequest terms(std::string field, size_t size = 10);
+
+    /**
+     * @brief 数值直方图，桶为 [offset + i * interval, offset + (i + 1) * interval)
+     * @param field 数值字段（整数或浮点）
+     * @param interval 桶宽度（必须大于0）
+     * @param offset 桶边界偏移
+     */
+    static FacetRequest histogram(std::string field, double interval, double offset = 0.0);
+
+    /**
+     * @brief 数值统计
+     * @param field 数值字段（整数或浮点）
+     */
+    static FacetRequest stats(std::string field);
+
+    const std::string& field() const { return field_; }
+    Kind kind() const { return kind_; }
+    size_t size() const { return size_; }
+    double interval() const { return interval_; }
+    double offset() const { return offset_; }
+
+private:
+    FacetRequest(std::string field, Kind kind) : field_(std::move(field)), kind_(kind) {}
+
+    std::string field_;
+    Kind kind_;
+    size_t size_ = 0;
+    double interval_ = 0.0;
+    double offset_ = 0.0;
+};
+
+/**
+ * @brief 分面桶
+ */
+struct FacetBucket {
+    std::string label;    // 关键字（kTerms）
+    double key = 0.0;     // 桶下界（kHistogram）
+    uint64_t count = 0;
+};
+
+/**
+ * @brief 分面/聚合结果
+ */
+struct FacetResult {
+    std::string field;
+    FacetRequest::Kind kind = FacetRequest::Kind::kTerms;
+    bool valid = false;                // 字段不存在或类型不支持时为false
+    std::vector<FacetBucket> buckets;  // kTerms按数量降序，kHistogram按key升序（只含非空桶）
+    uint64_t missing = 0;              // 没有该字段值的匹配文档数
+    uint64_t other = 0;                // kTerms：未进入前size个的文档数
+
+    // kStats（有值的文档数为0时min/max无意义）
+    uint64_t count = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double sum = 0.0;
+
+    double average() const { return count > 0 ? sum / count : 0.0; }
+};
+
+/**
+ * @brief 分面收集配置
+ */
+struct FacetOptions {
+    size_t parallel_threshold = 65536;  // 匹配文档数达到该值时并行收集
+    size_t max_threads = 4;             // 并行收集的最大线程数
+};
+
+/**
+ * @brief 分面/聚合收集器
+ *
+ * 在求交得到的完整匹配集合上直接读取列式文档属性计数，不需要打分，也不访问正排索引
+ *
+ * 设计思路：
+ * - 按列扫描：每个请求对匹配文档顺序读取一列，关键字列只按序号累加计数数组
+ * - 直方图用可扩展的稠密计数数组（桶号减去基准即下标），跨度过大的桶退化为哈希表
+ * - 匹配文档很多时按区间切分并行，每个线程使用独立的计数器，最后合并，不需要加锁
+ */
+class FacetCollector {
+public:
+    explicit FacetCollector(std::vector<FacetRequest> requests,
+                            const FacetOptions& options = FacetOptions())
+        : requests_(std::move(requests)), options_(options) {}
+
+    /**
+     * @brief 在匹配文档上收集分面
+     * @param doc_ids 匹配的文档ID（任意顺序）
+     * @param doc_values 文档属性
+     * @return 每个请求一个结果（与请求顺序一致）
+     */
+    std::vector<FacetResult> collect(const std::vector<int64_t>& doc_ids,
+                                     const DocValues& doc_values) const;
+
+    const std::vector<FacetRequest>& requests() const { return requests_; }
+
+private:
+    std::vector<FacetRequest> requests_;
+    FacetOptions options_;
+};
+
+} // namespace search_engine
@@ -0,0 +1,230 @@
+#include "query/fuzzy_matcher.h"
+#include "query/levenshtein_automaton.h"
+#include "common/utils.h"
+#include <algorithm>
+
+namespace search_engine {
+
+namespace {
+
+// DFS栈帧：词典区间[lo, hi)共享长度为depth的前缀
+struct Frame {
+    size_t lo;
+    size_t hi;
+    size_t depth;
+    int state;          // 自动机状态
+    uint32_t partial;   // 未解码完的码点
+    uint8_t remaining;  // 该码点还差几个续字节
+};
+
+// 区间内term数不超过该值时逐个扫描
+const size_t kScanThreshold = 16;
+
+struct Candidate {
+    size_t index;
+    int distance;
+    size_t df;
+};
+
+// UTF-8首字节 -> (码点长度, 首字节中的有效位)
+inline void decodeLead(unsigned char c, uint8_t& length, uint32_t& bits) {
+    if (c >= 0xF0) { length = 4; bits = c & 0x07; }
+    else if (c >= 0xE0) { length = 3; bits = c & 0x0F; }
+    else if (c >= 0xC0) { length = 2; bits = c & 0x1F; }
+    else { length = 1; bits = c; }
+}
+
+} // namespace
+
+int FuzzyMatcher::autoMaxEdits(size_t length) {
+    if (length <= 2) {
+        return 0;
+    }
+    return length <= 5 ? 1 : 2;
+}
+
+std::vector<FuzzyTerm> FuzzyMatcher::expand(const std::string& term,
+                                            const FuzzyOptions& options) const {
+    std::vector<FuzzyTerm> expansions;
+    if (term.empty() || dictionary_.empty()) {
+        return expansions;
+    }
+
+    const std::vector<uint32_t> codepoints = decodeUtf8(term);
+    int max_edits = options.max_edits >= 0 ? options.max_edits : autoMaxEdits(codepoints.size());
+    LevenshteinAutomaton automaton(term, max_edits);
+
+    // 1. 精确前缀：直接定位词典区间，并让自动机读入前缀
+    size_t prefix_bytes = 0;
+    int state = automaton.start();
+    const size_t prefix_cps = std::min(options.prefix_length, codepoints.size());
+    for (size_t i = 0; i < prefix_cps; ++i) {
+        uint8_t length = 1;
+        uint32_t bits = 0;
+        decodeLead(static_cast<unsigned char>(term[prefix_bytes]), length, bits);
+        prefix_bytes = std::min(prefix_bytes + length, term.size());
+        state = automaton.step(state, codepoints[i]);
+        if (state == LevenshteinAutomaton::kDeadState) {
+            return expansions;
+        }
+    }
+    auto range = dictionary_.prefixRange(std::string_view(term).substr(0, prefix_bytes));
+    if (range.first >= range.second) {
+        return expansions;
+    }
+
+    // 2. 在虚拟trie上DFS，与自动机求交
+    // 只保留(距离升序, 文档频率降序)最好的max_expansions个候选，堆顶是其中最差的一个；
+    // 堆满后，最小可达距离超过堆顶距离的子树不可能再进入结果，直接剪掉
+    auto better = [](const Candidate& a, const Candidate& b) {
+        if (a.distance != b.distance) {
+            return a.distance < b.distance;
+        }
+        if (a.df != b.df) {
+            return a.df > b.df;
+        }
+        return a.index < b.index;
+    };
+    const size_t limit = options.max_expansions;
+    if (limit == 0) {
+        return expansions;
+    }
+    std::vector<Candidate> best;
+    best.reserve(limit);
+    auto viable = [&](int state) {
+        if (state == LevenshteinAutomaton::kDeadState) {
+            return false;
+        }
+        return best.size() < limit || automaton.minDistance(state) <= best.front().distance;
+    };
+    auto addCandidate = [&](size_t index, int distance) {
+        if (best.size() == limit && distance > best.front().distance) {
+            return;
+        }
+        size_t df = index_ ? index_->getDocumentFrequency(std::string(dictionary_.term(index))) : 0;
+        Candidate candidate{index, distance, df};
+        if (best.size() < limit) {
+            best.push_back(candidate);
+            std::push_heap(best.begin(), best.end(), better);
+        } else if (better(candidate, best.front())) {
+            std::pop_heap(best.begin(), best.end(), better);
+            best.back() = candidate;
+            std::push_heap(best.begin(), best.end(), better);
+        }
+    };
+    std::vector<Frame> stack;
+    stack.push_back({range.first, range.second, prefix_bytes, state, 0, 0});
+
+    while (!stack.empty()) {
+        Frame frame = stack.back();
+        stack.pop_back();
+        if (!viable(frame.state)) {
+            continue;  // 入栈之后堆顶变好了
+        }
+
+        // 区间足够小时直接逐个term跑完剩余后缀，比继续按字节拆分子区间更省（顺序访问）
+        if (frame.hi - frame.lo <= kScanThreshold) {
+            for (size_t i = frame.lo; i < frame.hi; ++i) {
+                std::string_view suffix = dictionary_.term(i).substr(frame.depth);
+                int state = frame.state;
+                uint32_t partial = frame.partial;
+                uint8_t remaining = frame.remaining;
+                for (size_t k = 0; k < suffix.size() && viable(state); ++k) {
+                    unsigned char byte = static_cast<unsigned char>(suffix[k]);
+                    if (remaining == 0) {
+                        uint8_t length = 1;
+                        decodeLead(byte, length, partial);
+                        remaining = static_cast<uint8_t>(length - 1);
+                    } else {
+                        partial = (partial << 6) | (byte & 0x3F);
+                        remaining--;
+                    }
+                    if (remaining == 0) {
+                        state = automaton.step(state, partial);
+                    }
+                }
+                if (viable(state) && remaining == 0 && automaton.isMatch(state)) {
+                    addCandidate(i, automaton.distance(state));
+                }
+            }
+            continue;
+        }
+
+        size_t i = frame.lo;
+        if (dictionary_.term(i).size() == frame.depth) {
+            // 区间中至多第一个term恰好等于公共前缀
+            if (frame.remaining == 0 && automaton.isMatch(frame.state)) {
+                addCandidate(i, automaton.distance(frame.state));
+            }
+            ++i;
+        }
+
+        // 自动机只接受查询词中的字符时，直接在词典中seek这些字符，跳过其余子节点
+        if (frame.remaining == 0 && automaton.requiresAlphabet(frame.state)) {
+            const auto& alphabet = automaton.alphabet();
+            std::string bytes;
+            for (size_t cls = 1; cls <= alphabet.size(); ++cls) {
+                int next = automaton.stepClass(frame.state, cls);
+                if (!viable(next)) {
+                    continue;
+                }
+                bytes.clear();
+                utils::appendUtf8(alphabet[cls - 1], bytes);
+                auto sub = dictionary_.seek(i, frame.hi, frame.depth, bytes);
+                if (sub.first < sub.second) {
+                    stack.push_back({sub.first, sub.second, frame.depth + bytes.size(), next, 0, 0});
+                }
+            }
+            continue;
+        }
+
+        while (i < frame.hi) {
+            size_t j = dictionary_.childEnd(i, frame.hi, frame.depth);
+            unsigned char byte = static_cast<unsigned char>(dictionary_.term(i)[frame.depth]);
+
+            Frame child{i, j, frame.depth + 1, frame.state, 0, 0};
+            uint32_t codepoint = 0;
+            bool complete = false;
+            if (frame.remaining == 0) {
+                uint8_t length = 1;
+                decodeLead(byte, length, codepoint);
+                if (length == 1) {
+                    complete = true;
+                } else {
+                    child.partial = codepoint;
+                    child.remaining = static_cast<uint8_t>(length - 1);
+                }
+            } else {
+                codepoint = (frame.partial << 6) | (byte & 0x3F);
+                if (frame.remaining == 1) {
+                    complete = true;
+                } else {
+                    child.partial = codepoint;
+                    child.remaining = static_cast<uint8_t>(frame.remaining - 1);
+                }
+            }
+
+            if (complete) {
+                child.state = automaton.step(frame.state, codepoint);
+            }
+            if (viable(child.state)) {
+                stack.push_back(child);
+            }
+            i = j;
+        }
+    }
+
+    // 3. 按(距离升序, 文档频率降序)输出
+    std::sort(best.begin(), best.end(), better);
+
+    expansions.reserve(best.size());
+    const double length = static_cast<double>(codepoints.size());
+    for (const auto& candidate : best) {
+        double weight = 1.0 - candidate.distance / (length + 1.0);
+        expansions.emplace_back(std::string(dictionary_.term(candidate.index)),
+                                candidate.distance, weight);
+    }
+    return expansions;
+}
+
+} // namespace search_engine
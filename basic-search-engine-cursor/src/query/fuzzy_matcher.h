@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "index/term_dictionary.h"
+#include "index/inverted_index.h"
+
+namespace search_engine {
+
+/**
+ * @brief 模糊匹配配置
+ */
+struct FuzzyOptions {
+    int max_edits = -1;            // 最大编辑距离（-1表示按词长自动选择：<=2字为0，<=5字为1，否则2）
+    size_t prefix_length = 0;      // 要求精确匹配的前缀码点数（稠密词典上距离为2时，设为1可快数倍）
+    size_t max_expansions = 50;    // 每个查询词最多扩展出的term数（按距离、文档频率取最好的）
+};
+
+/**
+ * @brief 模糊扩展出的term
+ */
+struct FuzzyTerm {
+    std::string term;   // 词典中的term
+    int distance;       // 与查询词的编辑距离
+    double weight;      // 权重（距离越大权重越低）
+
+    FuzzyTerm(std::string t, int d, double w) : term(std::move(t)), distance(d), weight(w) {}
+};
+
+/**
+ * @brief 模糊匹配器
+ *
+ * 将查询词编译成Levenshtein自动机，与有序词典求交，得到编辑距离内的所有term
+ *
+ * 设计思路：
+ * - 在词典的"虚拟trie"上DFS，每走一个字节推进一次UTF-8解码，
+ *   每凑齐一个码点推进一次自动机，自动机进入死状态立即剪枝
+ * - 访问的节点数等于词典中自动机仍然存活的前缀数（每个节点一次二分）；词典越稠密，
+ *   距离内的前缀越多，距离2在百万级词典上约为毫秒级（见README中fuzzy_bench的数据）
+ * - 遍历过程中用大小为max_expansions的堆保留(编辑距离, 文档频率)最好的候选，
+ *   堆满后剪掉最小可达距离超过堆中最差距离的子树：距离更小的term不会因为先遇到
+ *   大量距离较大的term而被漏掉，同时较大距离的子树在结果足够时不再展开
+ */
+class FuzzyMatcher {
+public:
+    /**
+     * @param dictionary 有序词典
+     * @param index 倒排索引（可选，用于按文档频率排序候选）
+     */
+    explicit FuzzyMatcher(const TermDictionary& dictionary, const InvertedIndex* index = nullptr)
+        : dictionary_(dictionary), index_(index) {}
+
+    /**
+     * @brief 扩展查询词
+     * @param term 标准化后的查询词
+     * @param options 模糊匹配配置
+     * @return 扩展出的term列表（按距离升序）
+     */
+    std::vector<FuzzyTerm> expand(const std::string& term, const FuzzyOptions& options) const;
+
+    /**
+     * @brief 按词长（码点数）自动选择最大编辑距离
+     */
+    static int autoMaxEdits(size_t length);
+
+private:
+    const TermDictionary& dictionary_;
+    const InvertedIndex* index_;
+};
+
+} // namespace search_engine
@@ -0,0 +1,125 @@
+#include "query/impact_searcher.h"
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+namespace search_engine {
+
+namespace {
+
+// 处理时间按块检查，避免每个posting都读时钟
+const size_t kClockCheckInterval = 4096;
+
+// 线程私有的累加器：按文档序号寻址，touched记录需要清零的位置
+struct Accumulators {
+    std::vector<uint32_t> values;
+    std::vector<uint32_t> touched;
+
+    void reset(size_t num_docs) {
+        for (uint32_t ordinal : touched) {
+            values[ordinal] = 0;
+        }
+        touched.clear();
+        if (values.size() != num_docs) {
+            values.assign(num_docs, 0);
+        }
+    }
+};
+
+struct WeightedSegment {
+    uint32_t weight;   // 影响值 × 查询词次数
+    const ImpactIndex::Segment* segment;
+};
+
+} // namespace
+
+std::vector<SearchResult> ImpactSearcher::search(const std::vector<std::string>& query_terms,
+                                                 size_t top_k,
+                                                 const ImpactBudget& budget,
+                                                 ImpactSearchStats* stats) const {
+    ImpactSearchStats local_stats;
+    ImpactSearchStats& st = stats ? *stats : local_stats;
+    st = ImpactSearchStats();
+    if (query_terms.empty() || top_k == 0 || index_.empty()) {
+        return {};
+    }
+    const auto start = std::chrono::steady_clock::now();
+
+    // 1. 合并重复查询词，收集所有段并按加权影响值降序排列
+    std::unordered_map<std::string, uint32_t> term_counts;
+    for (const auto& term : query_terms) {
+        term_counts[term]++;
+    }
+    std::vector<WeightedSegment> segments;
+    for (const auto& [term, count] : term_counts) {
+        size_t num_segments = 0;
+        const ImpactIndex::Segment* first = index_.getSegments(term, num_segments);
+        for (size_t i = 0; i < num_segments; ++i) {
+            segments.push_back({first[i].impact * count, &first[i]});
+            st.postings_total += first[i].end - first[i].begin;
+        }
+    }
+    std::stable_sort(segments.begin(), segments.end(), [](const WeightedSegment& a, const WeightedSegment& b) {
+        return a.weight > b.weight;
+    });
+
+    // 2. 逐段累加，预算耗尽时停止
+    thread_local Accumulators accumulators;
+    accumulators.reset(index_.getTotalDocuments());
+    std::vector<uint32_t>& values = accumulators.values;
+    std::vector<uint32_t>& touched = accumulators.touched;
+
+    const size_t max_postings = budget.max_postings > 0 ? budget.max_postings : st.postings_total;
+    const bool timed = budget.max_milliseconds > 0.0;
+    const auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(budget.max_milliseconds));
+
+    for (const auto& weighted : segments) {
+        if (st.postings_processed >= max_postings ||
+            (timed && std::chrono::steady_clock::now() >= deadline)) {
+            st.budget_exhausted = true;
+            break;
+        }
+        const uint32_t* docs = index_.segmentDocs(*weighted.segment);
+        size_t length = std::min<size_t>(weighted.segment->end - weighted.segment->begin,
+                                         max_postings - st.postings_processed);
+        st.segments_processed++;
+
+        size_t i = 0;
+        while (i < length) {
+            const size_t block_end = std::min(length, i + kClockCheckInterval);
+            for (; i < block_end; ++i) {
+                uint32_t& value = values[docs[i]];
+                if (value == 0) {
+                    touched.push_back(docs[i]);
+                }
+                value += weighted.weight;
+            }
+            if (timed && i < length && std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+        }
+        st.postings_processed += i;
+        if (i < weighted.segment->end - weighted.segment->begin) {
+            st.budget_exhausted = true;
+            break;
+        }
+    }
+
+    // 3. 从访问过的文档中选出top-k（直接在touched上排序，不影响下次清零）
+    auto better = [&values](uint32_t a, uint32_t b) {
+        return values[a] != values[b] ? values[a] > values[b] : a < b;
+    };
+    std::vector<uint32_t>& candidates = touched;
+    const size_t keep = std::min(top_k, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(), better);
+
+    std::vector<SearchResult> results;
+    results.reserve(keep);
+    for (size_t i = 0; i < keep; ++i) {
+        results.emplace_back(index_.docId(candidates[i]), values[candidates[i]] * index_.scale());
+    }
+    return results;
+}
+
+} // namespace search_engine
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "index/impact_index.h"
+#include "rank/scorer.h"
+
+namespace search_engine {
+
+/**
+ * @brief 查询预算（两项均为0表示不限制，先耗尽的一项生效）
+ */
+struct ImpactBudget {
+    size_t max_postings = 0;        // 最多处理的posting数（硬上限）
+    double max_milliseconds = 0.0;  // 最长处理时间（每段及每4096个posting检查一次）
+};
+
+/**
+ * @brief 单次查询的执行统计
+ */
+struct ImpactSearchStats {
+    size_t postings_total = 0;       // 查询词的posting总数
+    size_t postings_processed = 0;   // 实际处理的posting数
+    size_t segments_processed = 0;   // 处理过（含部分处理）的段数
+    bool budget_exhausted = false;   // 是否因预算耗尽提前结束
+};
+
+/**
+ * @brief 按影响值逐段求值的查询执行器（score-at-a-time）
+ *
+ * 把所有查询词的段按 影响值 × 查询词次数 降序处理，向整数累加器中累加，
+ * 最后从被访问过的文档中选出top-k。语义为OR：命中越多、越重要的查询词得分越高。
+ *
+ * 设计思路：
+ * - 累加器是线程私有的数组，按文档序号直接寻址，只清理访问过的位置
+ * - 预算耗尽时立即停止，返回当前累加结果中的top-k（anytime），尾延迟有硬上界
+ * - 得分 = 累加值 × 量化系数，与构建时选择的模型（TF-IDF/BM25）同量纲
+ */
+class ImpactSearcher {
+public:
+    explicit ImpactSearcher(const ImpactIndex& index) : index_(index) {}
+
+    /**
+     * @brief 执行查询
+     * @param query_terms 标准化后的查询词（可重复）
+     * @param top_k 返回前K个结果
+     * @param budget 查询预算
+     * @param stats 输出执行统计（可选）
+     * @return 搜索结果列表（按分数降序，同分按文档ID升序）
+     */
+    std::vector<SearchResult> search(const std::vector<std::string>& query_terms,
+                                     size_t top_k,
+                                     const ImpactBudget& budget = ImpactBudget(),
+                                     ImpactSearchStats* stats = nullptr) const;
+
+private:
+    const ImpactIndex& index_;
+};
+
+} // namespace search_engine
@@ -0,0 +1,88 @@
+#include "query/levenshtein_automaton.h"
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+namespace search_engine {
+
+std::vector<uint32_t> decodeUtf8(std::string_view text) {
+    std::vector<uint32_t> codepoints;
+    codepoints.reserve(text.size());
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        size_t len = 1;
+        uint32_t cp = c;
+        if (c >= 0xF0) { len = 4; cp = c & 0x07; }
+        else if (c >= 0xE0) { len = 3; cp = c & 0x0F; }
+        else if (c >= 0xC0) { len = 2; cp = c & 0x1F; }
+        if (len > 1 && i + len <= text.size()) {
+            for (size_t k = 1; k < len; ++k) {
+                cp = (cp << 6) | (static_cast<unsigned char>(text[i + k]) & 0x3F);
+            }
+        } else {
+            len = 1;
+            cp = c;
+        }
+        codepoints.push_back(cp);
+        i += len;
+    }
+    return codepoints;
+}
+
+LevenshteinAutomaton::LevenshteinAutomaton(std::string_view term, int max_edits)
+    : max_edits_(std::clamp(max_edits, 0, kMaxEdits)),
+      term_(decodeUtf8(term)) {
+    alphabet_ = term_;
+    std::sort(alphabet_.begin(), alphabet_.end());
+    alphabet_.erase(std::unique(alphabet_.begin(), alphabet_.end()), alphabet_.end());
+    num_classes_ = alphabet_.size() + 1;
+
+    const size_t m = term_.size();
+    const uint8_t cap = static_cast<uint8_t>(max_edits_ + 1);
+    // DP行用字节串表示，便于哈希去重；rows[id]即状态id对应的行
+    using Row = std::string;
+
+    std::unordered_map<Row, int> ids;
+    std::vector<Row> rows;
+    auto intern = [&](const Row& row) -> int {
+        auto [it, inserted] = ids.emplace(row, static_cast<int>(rows.size()));
+        if (inserted) {
+            rows.push_back(row);
+            distances_.push_back(static_cast<uint8_t>(row[m]));
+            min_distances_.push_back(static_cast<uint8_t>(*std::min_element(row.begin(), row.end())));
+            transitions_.resize(transitions_.size() + num_classes_, kDeadState);
+        }
+        return it->second;
+    };
+
+    // 起始状态：空串与查询词前缀的距离
+    Row initial(m + 1, 0);
+    for (size_t i = 0; i <= m; ++i) {
+        initial[i] = static_cast<char>(std::min<size_t>(i, cap));
+    }
+    intern(initial);
+
+    // BFS展开所有可达状态（rows在展开过程中增长）；字符类0表示不在查询词中的任意字符
+    Row next(m + 1, 0);
+    for (size_t state = 0; state < rows.size(); ++state) {
+        for (size_t cls = 0; cls < num_classes_; ++cls) {
+            const Row& row = rows[state];
+            next[0] = static_cast<char>(std::min<int>(row[0] + 1, cap));
+            int best = next[0];
+            for (size_t i = 1; i <= m; ++i) {
+                int cost = (cls != 0 && term_[i - 1] == alphabet_[cls - 1]) ? 0 : 1;
+                int value = std::min({row[i - 1] + cost, row[i] + 1, next[i - 1] + 1});
+                next[i] = static_cast<char>(std::min<int>(value, cap));
+                best = std::min<int>(best, next[i]);
+            }
+            if (best > max_edits_) {
+                continue;  // 死状态
+            }
+            int target = intern(next);
+            transitions_[state * num_classes_ + cls] = target;
+        }
+    }
+}
+
+} // namespace search_engine
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace search_engine {
+
+/**
+ * @brief Levenshtein自动机（DFA）
+ *
+ * 接受所有与给定词的编辑距离不超过max_edits的字符串（以Unicode码点为单位，
+ * 一个汉字的替换算一次编辑）
+ *
+ * 设计思路：
+ * - 状态 = 编辑距离DP表的一行（截断到max_edits+1），从起始状态BFS预先展开成DFA
+ * - 字符按"是否出现在查询词中"分类：查询词中的每个不同码点一类，其余码点共用一类，
+ *   因此转移表大小只与查询词长度有关，与字母表无关
+ * - 查询时每一步只是一次查表，适合与有序词典/trie做DFS求交
+ */
+class LevenshteinAutomaton {
+public:
+    static constexpr int kDeadState = -1;
+    static constexpr int kMaxEdits = 2;
+
+    /**
+     * @brief 编译自动机
+     * @param term 查询词（UTF-8）
+     * @param max_edits 最大编辑距离（会被截断到[0, kMaxEdits]）
+     */
+    LevenshteinAutomaton(std::string_view term, int max_edits);
+
+    int start() const { return 0; }
+
+    /**
+     * @brief 状态转移
+     * @param state 当前状态
+     * @param codepoint 输入码点
+     * @return 下一个状态，无法再匹配时返回kDeadState
+     */
+    int step(int state, uint32_t codepoint) const {
+        return transitions_[static_cast<size_t>(state) * num_classes_ + classOf(codepoint)];
+    }
+
+    /**
+     * @brief 状态是否接受（当前已读入的字符串与查询词距离不超过max_edits）
+     */
+    bool isMatch(int state) const { return distances_[static_cast<size_t>(state)] <= max_edits_; }
+
+    /**
+     * @brief 接受状态对应的编辑距离
+     */
+    int distance(int state) const { return distances_[static_cast<size_t>(state)]; }
+
+    /**
+     * @brief 从该状态继续读入任意字符串后能达到的最小编辑距离（DP行的最小值）
+     * 用于剪掉只能产生更大距离的子树
+     */
+    int minDistance(int state) const { return min_distances_[static_cast<size_t>(state)]; }
+
+    /**
+     * @brief 读入任意不在查询词中的字符后是否必然死亡
+     * 为true时只需沿查询词中出现的字符继续扩展（可以直接在词典中seek）
+     */
+    bool requiresAlphabet(int state) const {
+        return transitions_[static_cast<size_t>(state) * num_classes_] == kDeadState;
+    }
+
+    /**
+     * @brief 查询词中不同的码点（字符类1..n对应的码点）
+     */
+    const std::vector<uint32_t>& alphabet() const { return alphabet_; }
+
+    /**
+     * @brief 按字符类转移（class 0为"其他字符"，i>0对应alphabet()[i-1]）
+     */
+    int stepClass(int state, size_t cls) const {
+        return transitions_[static_cast<size_t>(state) * num_classes_ + cls];
+    }
+
+    int maxEdits() const { return max_edits_; }
+    size_t stateCount() const { return distances_.size(); }
+    size_t termLength() const { return term_.size(); }
+
+private:
+    uint32_t classOf(uint32_t codepoint) const {
+        for (size_t i = 0; i < alphabet_.size(); ++i) {
+            if (alphabet_[i] == codepoint) {
+                return static_cast<uint32_t>(i + 1);
+            }
+        }
+        return 0;
+    }
+
+    int max_edits_;
+    std::vector<uint32_t> term_;          // 查询词码点
+    std::vector<uint32_t> alphabet_;      // 查询词中不同的码点（字符类1..n）
+    size_t num_classes_ = 1;
+    std::vector<int> transitions_;        // [state * num_classes_ + class] -> state
+    std::vector<uint8_t> distances_;      // 每个状态在词尾的编辑距离
+    std::vector<uint8_t> min_distances_;  // 每个状态DP行的最小值
+};
+
+/**
+ * @brief 将UTF-8解码为码点序列（非法字节按单字节码点处理）
+ */
+std::vector<uint32_t> decodeUtf8(std::string_view text);
+
+} // namespace search_engine
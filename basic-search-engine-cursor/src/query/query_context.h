@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace search_engine {
+
+/**
+ * @brief 查询执行阶段
+ */
+enum class QueryStage {
+    kIntersection = 0,   // 求交
+    kScoring,            // 打分
+    kRerank,             // 第二阶段重排序
+    kSnippet,            // 摘要生成
+    kCount
+};
+
+/**
+ * @brief 查询上下文：截止时间 + 取消标志
+ *
+ * 各阶段以块为粒度调用checkpoint()协作检查，超时或被取消后尽快停止，
+ * 已完成的部分作为结果返回，timedOut()标记结果不完整
+ *
+ * 设计思路：
+ * - cancel()可以从其他线程调用（原子标志）
+ * - 只记录第一次中断发生的阶段，之后的checkpoint()直接返回false
+ * - 不设截止时间时checkpoint()只读一个原子变量，不读时钟
+ */
+class QueryContext {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    QueryContext() = default;
+
+    /**
+     * @param timeout 从现在起的超时时间
+     */
+    explicit QueryContext(Clock::duration timeout) { setTimeout(timeout); }
+
+    QueryContext(const QueryContext&) = delete;
+    QueryContext& operator=(const QueryContext&) = delete;
+
+    void setDeadline(Clock::time_point deadline) {
+        deadline_ = deadline;
+        has_deadline_ = true;
+    }
+
+    void setTimeout(Clock::duration timeout) { setDeadline(Clock::now() + timeout); }
+
+    /**
+     * @brief 取消查询（线程安全）
+     */
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief 是否已超时或被取消
+     */
+    bool expired() const {
+        return cancelled_.load(std::memory_order_relaxed) ||
+               (has_deadline_ && Clock::now() >= deadline_);
+    }
+
+    /**
+     * @brief 协作检查点
+     * @param stage 当前阶段
+     * @return 是否可以继续执行（false表示应停止并返回部分结果）
+     */
+    bool checkpoint(QueryStage stage) {
+        if (timed_out_) {
+            return false;
+        }
+        if (!expired()) {
+            return true;
+        }
+        timed_out_ = true;
+        stage_ = stage;
+        return false;
+    }
+
+    /**
+     * @brief 查询是否被中断（结果不完整）
+     */
+    bool timedOut() const { return timed_out_; }
+
+    /**
+     * @brief 是否因cancel()中断（否则为超时）
+     */
+    bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 中断发生的阶段（timedOut()为true时有效）
+     */
+    QueryStage stage() const { return stage_; }
+
+private:
+    Clock::time_point deadline_{};
+    bool has_deadline_ = false;
+    std::atomic<bool> cancelled_{false};
+    bool timed_out_ = false;
+    QueryStage stage_ = QueryStage::kCount;
+};
+
+/**
+ * @brief 各阶段被截止时间/取消中断的次数（线程安全）
+ */
+class QueryStageCounters {
+public:
+    void record(QueryStage stage) {
+        counts_[static_cast<size_t>(stage)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t get(QueryStage stage) const {
+        return counts_[static_cast<size_t>(stage)].load(std::memory_order_relaxed);
+    }
+
+    void reset() {
+        for (auto& count : counts_) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(QueryStage::kCount)> counts_{};
+};
+
+} // namespace search_engine
@@ -1,10 +1,21 @@
 #include "query/search_engine.h"
-#include <unordered_set>
+#include "rank/score_kernel.h"
 #include <unordered_map>
+#include <map>
+#include <cstdint>
 #include <algorithm>
+#include <cmath>
 
 namespace search_engine {
 
+namespace {
+
+// 求交/打分阶段每处理多少个文档检查一次截止时间
+const size_t kIntersectCheckInterval = 1024;
+const size_t kScoreCheckInterval = ScoreKernel::kBlockSize;
+
+} // namespace
+
 SearchEngine::SearchEngine() {
     // 默认使用TF-IDF排序器
     scorer_ = std::make_unique<TfIdfScorer>();
@@ -15,6 +26,45 @@ void SearchEngine::setScorer(std::unique_ptr<Scorer> scorer) {
 }
 
 std::vector<SearchResult> SearchEngine::search(const std::string& query, size_t top_k) const {
+    QueryContext context;
+    return search(query, top_k, SearchOptions(), context);
+}
+
+std::vector<SearchResult> SearchEngine::search(const std::string& query, size_t top_k,
+                                               QueryContext& context) const {
+    return search(query, top_k, SearchOptions(), context);
+}
+
+std::vector<SearchResult> SearchEngine::search(const std::string& query, size_t top_k,
+                                               const SearchOptions& options,
+                                               std::vector<FacetResult>* facets) const {
+    QueryContext context;
+    return search(query, top_k, options, context, facets);
+}
+
+bool SearchEngine::validateOptions(const SearchOptions& options, std::string* error) const {
+    auto fail = [error](std::string message) {
+        if (error) {
+            *error = std::move(message);
+        }
+        return false;
+    };
+    if ((!options.filters.empty() || !options.sort_field.empty()) && !doc_values_) {
+        return fail("未设置文档属性，无法过滤或按字段排序");
+    }
+    if (!options.sort_field.empty() && !doc_values_->column(options.sort_field)) {
+        return fail("排序字段不存在: " + options.sort_field);
+    }
+    return true;
+}
+
+std::vector<SearchResult> SearchEngine::search(const std::string& query, size_t top_k,
+                                               const SearchOptions& options,
+                                               QueryContext& context,
+                                               std::vector<FacetResult>* facets) const {
+    if (facets) {
+        facets->clear();
+    }
     if (!inverted_index_ || !scorer_) {
         return {};
     }
@@ -25,70 +75,498 @@ std::vector<SearchResult> SearchEngine::search(const std::string& query, size_t
         return {};
     }
     
-    // 2. 执行查询（当前实现：AND查询）
-    auto doc_ids = executeAndQuery(query_terms);
-    if (doc_ids.empty()) {
+    // 2. 属性过滤编译成位图（多个条件取交集）
+    if (!validateOptions(options)) {
         return {};
     }
+    std::shared_ptr<const DocBitset> filter;
+    if (!options.filters.empty()) {
+        filter = filter_cache_.get(options.filters[0], *doc_values_);
+        if (options.filters.size() > 1) {
+            auto combined = std::make_shared<DocBitset>(*filter);
+            for (size_t i = 1; i < options.filters.size(); ++i) {
+                combined->intersectWith(*filter_cache_.get(options.filters[i], *doc_values_));
+            }
+            filter = std::move(combined);
+        }
+        if (filter->count() == 0) {
+            return {};
+        }
+    }
+    
+    // 3. 执行查询（当前实现：AND查询，过滤条件参与求交）
+    auto doc_ids = executeAndQuery(query_terms, filter.get(), context);
+    
+    // 4. 分面在完整匹配集合上收集（只读列式属性，不打分）；top_k为0时到此为止
+    if (facets && !options.facets.empty() && doc_values_) {
+        *facets = FacetCollector(options.facets, facet_options_).collect(doc_ids, *doc_values_);
+    }
+    if (top_k == 0) {
+        doc_ids.clear();
+    }
     
-    // 3. 计算分数并排序
+    // 5. 按字段排序时先按字段值选出top_k，只为这些文档打分
+    const DocValuesColumn* sort_column = nullptr;
+    if (!options.sort_field.empty()) {
+        sort_column = doc_values_->column(options.sort_field);
+    }
+    if (sort_column) {
+        selectByField(doc_ids, top_k, *sort_column, options.sort_descending);
+    }
+    
+    // 6. 计算分数（按块检查截止时间，中断时保留已打分的文档）
+    //    内置排序公式用批量打分内核，自定义排序器逐文档调用虚函数
     std::vector<SearchResult> results;
-    for (int64_t doc_id : doc_ids) {
-        double score = scorer_->score(doc_id, query_terms, *inverted_index_);
-        results.emplace_back(doc_id, score);
+    results.reserve(doc_ids.size());
+    thread_local ScoreKernel kernel;
+    if (kernel.prepare(*scorer_, query_terms, *inverted_index_)) {
+        double scores[kScoreCheckInterval];
+        for (size_t begin = 0; begin < doc_ids.size(); begin += kScoreCheckInterval) {
+            if (!context.checkpoint(QueryStage::kScoring)) {
+                break;
+            }
+            const size_t count = std::min(kScoreCheckInterval, doc_ids.size() - begin);
+            kernel.score(doc_ids.data() + begin, count, scores);
+            for (size_t i = 0; i < count; ++i) {
+                results.emplace_back(doc_ids[begin + i], scores[i]);
+            }
+        }
+    } else {
+        for (size_t i = 0; i < doc_ids.size(); ++i) {
+            if (i % kScoreCheckInterval == 0 && !context.checkpoint(QueryStage::kScoring)) {
+                break;
+            }
+            double score = scorer_->score(doc_ids[i], query_terms, *inverted_index_);
+            results.emplace_back(doc_ids[i], score);
+        }
+    }
+    
+    // 7. 按分数取top_k（按字段排序时已经有序）；有重排序器时先取前depth个交给模型
+    if (!sort_column) {
+        selectTopK(results, query_terms, top_k, context);
+    }
+    
+    // 8. 只为最终的top_k生成摘要
+    if (snippet_enabled_ && forward_index_ && !context.timedOut()) {
+        snippet_generator_.fill(results, query_terms, *forward_index_, &context);
+    }
+    
+    if (context.timedOut()) {
+        stage_counters_.record(context.stage());
+    }
+    return results;
+}
+
+void SearchEngine::selectTopK(std::vector<SearchResult>& results, const std::vector<std::string>& query_terms,
+                              size_t top_k, QueryContext& context) const {
+    const bool rerank = reranker_ && top_k > 0 && !context.timedOut();
+    const size_t keep = rerank ? std::max(top_k, reranker_->options().depth) : top_k;
+    if (results.size() > keep) {
+        std::partial_sort(results.begin(), results.begin() + keep, results.end());
+        results.resize(keep);
+    } else {
+        scorer_->sortResults(results);
+    }
+    if (rerank && context.checkpoint(QueryStage::kRerank)) {
+        reranker_->rerank(results, query_terms, *inverted_index_);
+    }
+    if (results.size() > top_k) {
+        results.resize(top_k);
+    }
+}
+
+std::vector<std::vector<SearchResult>> SearchEngine::searchBatch(const std::vector<std::string>& queries,
+                                                                 size_t top_k) const {
+    std::vector<std::vector<SearchResult>> batch_results(queries.size());
+    if (!inverted_index_ || !scorer_ || top_k == 0) {
+        return batch_results;
+    }
+    
+    // 1. 分词；所有查询中每个不同的词只查一次词典
+    std::unordered_map<std::string, size_t> term_ids;
+    std::vector<const std::vector<Posting>*> lists;
+    std::vector<std::vector<std::string>> query_terms(queries.size());
+    std::vector<std::vector<size_t>> query_term_ids(queries.size());
+    std::vector<std::vector<size_t>> paths(queries.size());   // 去重后按DF升序的词编号
+    std::vector<size_t> alive;
+    std::map<std::vector<std::string>, size_t> first_seen;    // 分词结果完全相同的查询只执行一次
+    std::vector<size_t> duplicate_of(queries.size(), SIZE_MAX);
+    for (size_t q = 0; q < queries.size(); ++q) {
+        query_terms[q] = tokenizer_.tokenize(queries[q]);
+        if (query_terms[q].empty()) {
+            continue;
+        }
+        auto [seen, first] = first_seen.emplace(query_terms[q], q);
+        if (!first) {
+            duplicate_of[q] = seen->second;
+            continue;
+        }
+        bool found = true;
+        for (const auto& term : query_terms[q]) {
+            auto [it, inserted] = term_ids.emplace(term, lists.size());
+            if (inserted) {
+                lists.push_back(inverted_index_->getPostings(term));
+            }
+            // 有词不存在，AND查询为空
+            found = found && lists[it->second] && !lists[it->second]->empty();
+            query_term_ids[q].push_back(it->second);
+        }
+        if (!found) {
+            continue;
+        }
+        auto& path = paths[q];
+        path = query_term_ids[q];
+        std::sort(path.begin(), path.end(), [&lists](size_t a, size_t b) {
+            return lists[a]->size() != lists[b]->size() ? lists[a]->size() < lists[b]->size() : a < b;
+        });
+        path.erase(std::unique(path.begin(), path.end()), path.end());
+        alive.push_back(q);
+    }
+    
+    // 2. 按词路径排序：前缀相同的查询相邻，共享前缀的求交结果
+    std::sort(alive.begin(), alive.end(), [&paths](size_t a, size_t b) {
+        return paths[a] != paths[b] ? paths[a] < paths[b] : a < b;
+    });
+    
+    // 前缀求交的结果：第一层直接引用posting列表，之后为候选文档及路径上每个词的词频
+    struct PrefixNode {
+        const std::vector<Posting>* list = nullptr;
+        std::vector<int64_t> docs;
+        std::vector<std::vector<double>> tfs;   // tfs[j][i]: 路径上第j个词在docs[i]中的词频
+    };
+    
+    thread_local ScoreKernel kernel;
+    std::vector<const std::vector<Posting>*> term_postings;
+    std::vector<const double*> term_freqs;
+    std::vector<int64_t> list_docs;
+    std::vector<double> list_tfs;
+    std::vector<double> scores;
+    
+    // 查询的全部词已求交完：用解码好的词频打分，取top-k
+    auto finish = [&](size_t q, const PrefixNode& node) {
+        const std::vector<int64_t>* docs = &node.docs;
+        if (node.list) {
+            list_docs.resize(node.list->size());
+            list_tfs.resize(node.list->size());
+            for (size_t i = 0; i < node.list->size(); ++i) {
+                list_docs[i] = (*node.list)[i].doc_id;
+                list_tfs[i] = static_cast<double>((*node.list)[i].term_freq);
+            }
+            docs = &list_docs;
+        }
+        
+        term_postings.clear();
+        term_freqs.clear();
+        for (size_t id : query_term_ids[q]) {
+            term_postings.push_back(lists[id]);
+            const size_t j = std::find(paths[q].begin(), paths[q].end(), id) - paths[q].begin();
+            term_freqs.push_back(node.list ? list_tfs.data() : node.tfs[j].data());
+        }
+        
+        auto& results = batch_results[q];
+        results.reserve(docs->size());
+        if (kernel.prepare(*scorer_, term_postings, *inverted_index_)) {
+            scores.resize(docs->size());
+            kernel.score(docs->data(), docs->size(), term_freqs, scores.data());
+            for (size_t i = 0; i < docs->size(); ++i) {
+                results.emplace_back((*docs)[i], scores[i]);
+            }
+        } else {
+            for (int64_t doc_id : *docs) {
+                results.emplace_back(doc_id, scorer_->score(doc_id, query_terms[q], *inverted_index_));
+            }
+        }
+        
+        QueryContext context;
+        selectTopK(results, query_terms[q], top_k, context);
+        if (snippet_enabled_ && forward_index_) {
+            snippet_generator_.fill(results, query_terms[q], *forward_index_, &context);
+        }
+    };
+    
+    // 3. 深度优先遍历路径前缀：[lo, hi)内的查询共享前depth个词的求交结果node，
+    //    下一个词相同的查询共用一次posting列表遍历
+    auto visit = [&](auto& self, size_t lo, size_t hi, size_t depth, const PrefixNode& node) -> void {
+        while (lo < hi && paths[alive[lo]].size() == depth) {
+            finish(alive[lo++], node);
+        }
+        while (lo < hi) {
+            const size_t id = paths[alive[lo]][depth];
+            size_t group_end = lo;
+            while (group_end < hi && paths[alive[group_end]][depth] == id) {
+                group_end++;
+            }
+            
+            const auto& list = *lists[id];
+            PrefixNode child;
+            if (depth == 0) {
+                child.list = &list;
+            } else {
+                // 由较短的前缀结果驱动，在新列表中倍增查找
+                const size_t columns = depth + 1;
+                child.tfs.resize(columns);
+                size_t cursor = 0;
+                const size_t count = node.list ? node.list->size() : node.docs.size();
+                for (size_t i = 0; i < count; ++i) {
+                    const int64_t doc_id = node.list ? (*node.list)[i].doc_id : node.docs[i];
+                    cursor = InvertedIndex::seek(list, cursor, doc_id);
+                    if (cursor == list.size()) {
+                        break;
+                    }
+                    if (list[cursor].doc_id != doc_id) {
+                        continue;
+                    }
+                    child.docs.push_back(doc_id);
+                    if (node.list) {
+                        child.tfs[0].push_back(static_cast<double>((*node.list)[i].term_freq));
+                    } else {
+                        for (size_t j = 0; j < depth; ++j) {
+                            child.tfs[j].push_back(node.tfs[j][i]);
+                        }
+                    }
+                    child.tfs[depth].push_back(static_cast<double>(list[cursor].term_freq));
+                }
+            }
+            if (child.list || !child.docs.empty()) {
+                self(self, lo, group_end, depth + 1, child);
+            }
+            lo = group_end;
+        }
+    };
+    visit(visit, 0, alive.size(), 0, PrefixNode());
+    
+    // 4. 重复的查询直接复制结果
+    for (size_t q = 0; q < queries.size(); ++q) {
+        if (duplicate_of[q] != SIZE_MAX) {
+            batch_results[q] = batch_results[duplicate_of[q]];
+        }
     }
     
-    scorer_->sortResults(results);
+    return batch_results;
+}
+
+void SearchEngine::selectByField(std::vector<int64_t>& doc_ids, size_t top_k,
+                                 const DocValuesColumn& column, bool descending) const {
+    // 关键字列按字典序比较：先算出每个序号的字典序名次
+    std::vector<uint32_t> keyword_rank;
+    if (column.type() == DocValueType::kKeyword) {
+        std::vector<uint32_t> ordinals(column.cardinality());
+        for (uint32_t i = 0; i < ordinals.size(); ++i) {
+            ordinals[i] = i;
+        }
+        std::sort(ordinals.begin(), ordinals.end(), [&column](uint32_t a, uint32_t b) {
+            return column.keyword(a) < column.keyword(b);
+        });
+        keyword_rank.resize(ordinals.size());
+        for (uint32_t rank = 0; rank < ordinals.size(); ++rank) {
+            keyword_rank[ordinals[rank]] = rank;
+        }
+    }
+    
+    auto compare = [](auto x, auto y) { return x < y ? -1 : (x > y ? 1 : 0); };
+    auto before = [&](int64_t a, int64_t b) {
+        const bool has_a = column.hasValue(a);
+        const bool has_b = column.hasValue(b);
+        if (has_a != has_b) {
+            return has_a;
+        }
+        if (has_a) {
+            int order = 0;
+            switch (column.type()) {
+                case DocValueType::kInt64:
+                    order = compare(column.intValue(a), column.intValue(b));
+                    break;
+                case DocValueType::kDouble:
+                    order = compare(column.doubleValue(a), column.doubleValue(b));
+                    break;
+                case DocValueType::kKeyword:
+                    order = compare(keyword_rank[column.ordinal(a)], keyword_rank[column.ordinal(b)]);
+                    break;
+            }
+            if (order != 0) {
+                return descending ? order > 0 : order < 0;
+            }
+        }
+        return a < b;
+    };
+    
+    const size_t keep = std::min(top_k, doc_ids.size());
+    std::partial_sort(doc_ids.begin(), doc_ids.begin() + keep, doc_ids.end(), before);
+    doc_ids.resize(keep);
+}
+
+std::vector<SearchResult> SearchEngine::searchFuzzy(const std::string& query, size_t top_k,
+                                                    const FuzzyOptions& options) const {
+    if (!inverted_index_ || !term_dictionary_) {
+        return {};
+    }
+    
+    // 1. 分词
+    auto query_terms = tokenizer_.tokenize(query);
+    if (query_terms.empty()) {
+        return {};
+    }
+    
+    const size_t total_docs = inverted_index_->getTotalDocuments();
+    FuzzyMatcher matcher(*term_dictionary_, inverted_index_);
+    
+    // 2. 逐个查询词扩展，组内加权OR，组间AND
+    std::unordered_map<int64_t, double> scores;
+    std::unordered_map<int64_t, size_t> matched_groups;
+    std::vector<std::string> highlight_terms;
+    size_t groups = 0;
+    
+    for (const auto& term : query_terms) {
+        auto expansions = matcher.expand(term, options);
+        if (expansions.empty()) {
+            return {};
+        }
+        groups++;
+        
+        std::unordered_map<int64_t, double> group_scores;
+        for (const auto& expansion : expansions) {
+            highlight_terms.push_back(expansion.term);
+            const auto* postings = inverted_index_->getPostings(expansion.term);
+            if (!postings || postings->empty()) {
+                continue;
+            }
+            double idf = std::log(static_cast<double>(total_docs) / postings->size());
+            for (const auto& posting : *postings) {
+                double score = expansion.weight * posting.term_freq * idf;
+                auto [it, inserted] = group_scores.emplace(posting.doc_id, score);
+                if (!inserted && score > it->second) {
+                    it->second = score;
+                }
+            }
+        }
+        
+        for (const auto& [doc_id, score] : group_scores) {
+            if (matched_groups[doc_id]++ == groups - 1) {
+                scores[doc_id] += score;
+            }
+        }
+    }
+    
+    // 3. 只保留匹配了所有查询词的文档
+    std::vector<SearchResult> results;
+    for (const auto& [doc_id, score] : scores) {
+        if (matched_groups[doc_id] == groups) {
+            results.emplace_back(doc_id, score);
+        }
+    }
     
-    // 4. 返回top_k
     if (results.size() > top_k) {
+        std::partial_sort(results.begin(), results.begin() + top_k, results.end());
         results.resize(top_k);
+    } else {
+        std::sort(results.begin(), results.end());
+    }
+    
+    if (snippet_enabled_ && forward_index_) {
+        snippet_generator_.fill(results, highlight_terms, *forward_index_);
+    }
+    
+    return results;
+}
+
+std::vector<SearchResult> SearchEngine::searchImpact(const std::string& query, size_t top_k,
+                                                     const ImpactBudget& budget,
+                                                     ImpactSearchStats* stats) const {
+    if (!impact_index_) {
+        return {};
+    }
+    
+    auto query_terms = tokenizer_.tokenize(query);
+    if (query_terms.empty()) {
+        return {};
+    }
+    
+    ImpactSearcher searcher(*impact_index_);
+    auto results = searcher.search(query_terms, top_k, budget, stats);
+    
+    if (snippet_enabled_ && forward_index_) {
+        snippet_generator_.fill(results, query_terms, *forward_index_);
     }
     
     return results;
 }
 
-std::vector<int64_t> SearchEngine::executeAndQuery(const std::vector<std::string>& query_terms) const {
+std::vector<int64_t> SearchEngine::executeAndQuery(const std::vector<std::string>& query_terms,
+                                                   const DocBitset* filter,
+                                                   QueryContext& context) const {
     if (query_terms.empty()) {
         return {};
     }
     
-    // 获取每个term的posting list
-    std::vector<std::vector<Posting>> posting_lists;
+    // 获取每个term的posting list（不拷贝）
+    std::vector<const std::vector<Posting>*> posting_lists;
     for (const auto& term : query_terms) {
-        auto postings = inverted_index_->search(term);
-        if (postings.empty()) {
+        const auto* postings = inverted_index_->getPostings(term);
+        if (!postings || postings->empty()) {
             // 如果某个term没有匹配，AND查询返回空
             return {};
         }
         posting_lists.push_back(postings);
     }
     
-    // 找到所有term都包含的文档（交集）
-    // 使用第一个term的posting list作为基准
-    std::unordered_set<int64_t> candidate_docs;
-    for (const auto& posting : posting_lists[0]) {
-        candidate_docs.insert(posting.doc_id);
-    }
+    // 从最短的列表开始，重复的查询词只求交一次
+    std::sort(posting_lists.begin(), posting_lists.end(),
+              [](const std::vector<Posting>* a, const std::vector<Posting>* b) {
+                  return a->size() != b->size() ? a->size() < b->size() : a < b;
+              });
+    posting_lists.erase(std::unique(posting_lists.begin(), posting_lists.end()), posting_lists.end());
     
-    // 与其他term的posting list求交集
-    for (size_t i = 1; i < posting_lists.size(); ++i) {
-        std::unordered_set<int64_t> term_docs;
-        for (const auto& posting : posting_lists[i]) {
-            term_docs.insert(posting.doc_id);
+    std::vector<size_t> cursors(posting_lists.size(), 0);
+    std::vector<int64_t> matches;
+    
+    // 在第first个及之后的列表中倍增查找doc_id，返回是否全部命中；exhausted表示某个列表已走完
+    auto matchAll = [&](int64_t doc_id, size_t first, bool& exhausted) {
+        for (size_t l = first; l < posting_lists.size(); ++l) {
+            const auto& list = *posting_lists[l];
+            cursors[l] = InvertedIndex::seek(list, cursors[l], doc_id);
+            if (cursors[l] == list.size()) {
+                exhausted = true;
+                return false;
+            }
+            if (list[cursors[l]].doc_id != doc_id) {
+                return false;
+            }
         }
-        
-        // 求交集
-        std::vector<int64_t> intersection;
-        for (int64_t doc_id : candidate_docs) {
-            if (term_docs.find(doc_id) != term_docs.end()) {
-                intersection.push_back(doc_id);
+        return true;
+    };
+    
+    bool exhausted = false;
+    if (filter && filter->count() < posting_lists[0]->size()) {
+        // 过滤条件很严格：由位图驱动，在所有posting列表中跳跃查找
+        size_t steps = 0;
+        for (size_t doc = filter->nextSetBit(0); doc < filter->size() && !exhausted;
+             doc = filter->nextSetBit(doc + 1)) {
+            if (steps++ % kIntersectCheckInterval == 0 && !context.checkpoint(QueryStage::kIntersection)) {
+                break;
             }
+            if (matchAll(static_cast<int64_t>(doc), 0, exhausted)) {
+                matches.push_back(static_cast<int64_t>(doc));
+            }
+        }
+        return matches;
+    }
+    
+    // 以最短列表为候选，先测试过滤位图，再在其余有序列表中倍增查找（doc-at-a-time，可按块中断）
+    const auto& candidates = *posting_lists[0];
+    for (size_t i = 0; i < candidates.size() && !exhausted; ++i) {
+        if (i % kIntersectCheckInterval == 0 && !context.checkpoint(QueryStage::kIntersection)) {
+            break;
+        }
+        const int64_t doc_id = candidates[i].doc_id;
+        if (filter && !filter->test(doc_id)) {
+            continue;
+        }
+        if (matchAll(doc_id, 1, exhausted)) {
+            matches.push_back(doc_id);
         }
-        candidate_docs = std::unordered_set<int64_t>(intersection.begin(), intersection.end());
     }
     
-    return std::vector<int64_t>(candidate_docs.begin(), candidate_docs.end());
+    return matches;
 }
 
 } // namespace search_engine
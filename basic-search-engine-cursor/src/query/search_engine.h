@@ -6,10 +6,29 @@
 #include "index/inverted_index.h"
 #include "index/forward_index.h"
 #include "rank/scorer.h"
+#include "rank/ltr_reranker.h"
+#include "query/snippet_generator.h"
+#include "query/fuzzy_matcher.h"
+#include "query/impact_searcher.h"
+#include "query/query_context.h"
+#include "query/doc_filter.h"
+#include "query/facet_collector.h"
+#include "index/doc_values.h"
+#include "index/term_dictionary.h"
 #include "common/tokenizer.h"
 
 namespace search_engine {
 
+/**
+ * @brief 搜索选项（属性过滤、按字段排序、分面）
+ */
+struct SearchOptions {
+    std::vector<Filter> filters;        // 属性过滤条件（AND），在求交阶段生效
+    std::string sort_field;             // 非空时按该字段取top-k（否则按相关性分数），无值的文档排在最后；字段必须存在
+    bool sort_descending = true;        // 按字段排序的方向
+    std::vector<FacetRequest> facets;   // 在完整匹配集合上收集的分面/聚合
+};
+
 /**
  * @brief 搜索引擎主类
  * 
@@ -35,6 +54,16 @@ public:
      */
     void setScorer(std::unique_ptr<Scorer> scorer);
 
+    /**
+     * @brief 设置第二阶段重排序器（SearchEngine会持有所有权，nullptr表示关闭）
+     *
+     * 第一阶段按排序器得分取前max(top_k, depth)个结果，由重排序器用树模型重新打分后取top_k；
+     * 按字段排序的查询不重排序
+     *
+     * @param reranker 重排序器（需已加载模型）
+     */
+    void setReranker(std::unique_ptr<LtrReranker> reranker) { reranker_ = std::move(reranker); }
+
     /**
      * @brief 执行搜索
      * @param query 查询字符串
@@ -43,6 +72,123 @@ public:
      */
     std::vector<SearchResult> search(const std::string& query, size_t top_k = 10) const;
 
+    /**
+     * @brief 执行带截止时间/取消的搜索
+     *
+     * 求交、打分、重排序、摘要各阶段按块检查context，中断后跳过剩余工作并返回已完成的部分：
+     * - 求交阶段中断：不再打分，返回空列表
+     * - 打分阶段中断：返回已打分文档中的top-k（不重排序、不生成摘要）
+     * - 重排序前中断：返回第一阶段的top-k
+     * - 摘要阶段中断：排序结果完整，部分结果没有摘要
+     * context.timedOut()标记结果不完整，中断阶段计入getStageCounters()
+     *
+     * @param query 查询字符串
+     * @param top_k 返回前K个结果
+     * @param context 查询上下文
+     * @return 搜索结果列表（按分数降序）
+     */
+    std::vector<SearchResult> search(const std::string& query, size_t top_k, QueryContext& context) const;
+
+    /**
+     * @brief 执行带属性过滤/按字段排序的搜索
+     *
+     * 过滤条件编译成位图（带缓存）后参与求交：命中文档很少时由位图驱动、在posting列表中跳跃查找，
+     * 否则由最短的posting列表驱动、逐个测试位图。按字段排序时只为最终的top-k打分。
+     * 分面在求交之后、打分之前对完整匹配集合收集；top_k为0时只收集分面，完全不打分。
+     * 选项无效（如sort_field不存在）时返回空列表而不是改按相关性排序，原因见validateOptions()
+     *
+     * @param query 查询字符串
+     * @param top_k 返回前K个结果
+     * @param options 过滤、排序与分面选项（需要先设置文档属性setDocValues）
+     * @param context 查询上下文（求交阶段中断时分面只覆盖已确认的匹配文档）
+     * @param facets 输出分面结果（可选，与options.facets顺序一致）
+     * @return 搜索结果列表
+     */
+    std::vector<SearchResult> search(const std::string& query, size_t top_k,
+                                     const SearchOptions& options, QueryContext& context,
+                                     std::vector<FacetResult>* facets = nullptr) const;
+
+    /**
+     * @brief 执行带属性过滤/按字段排序/分面的搜索（无截止时间）
+     */
+    std::vector<SearchResult> search(const std::string& query, size_t top_k,
+                                     const SearchOptions& options,
+                                     std::vector<FacetResult>* facets = nullptr) const;
+
+    /**
+     * @brief 检查搜索选项能否执行
+     * @param options 搜索选项
+     * @param error 输出失败原因（可选）
+     * @return 有过滤/排序条件但未设置文档属性，或sort_field指向不存在的字段时返回false
+     */
+    bool validateOptions(const SearchOptions& options, std::string* error = nullptr) const;
+
+    /**
+     * @brief 批量执行搜索（查询日志回放、离线评测、预计算缓存）
+     *
+     * 结果与逐个调用search(query, top_k)相同，但多个查询共享的工作只做一次：
+     * - 所有查询中每个不同的词只查一次词典；分词结果完全相同的查询只执行一次，结果直接复制
+     * - 每个查询的词去重后按DF升序（DF相同按词编号）排成一条词路径，所有查询按路径排序，
+     *   前缀相同的查询相邻
+     * - 深度优先遍历路径前缀：同一前缀的求交结果（候选文档及路径上各词的词频）只计算一次，
+     *   由较短的前缀结果驱动、在下一个词的posting列表中倍增查找；第一层直接引用posting列表
+     * - 路径走完的查询用求交时解码出的词频直接打分（ScoreKernel），不再回到posting列表查找
+     * - 各查询各自取top-k（以及重排序、摘要）
+     *
+     * @param queries 查询字符串列表
+     * @param top_k 每个查询返回前K个结果
+     * @return 与queries一一对应的结果列表
+     */
+    std::vector<std::vector<SearchResult>> searchBatch(const std::vector<std::string>& queries,
+                                                       size_t top_k = 10) const;
+
+    /**
+     * @brief 执行容错（模糊）搜索
+     *
+     * 每个查询词通过Levenshtein自动机在词典中扩展出编辑距离内的term，
+     * 扩展词之间为加权OR（同一文档取权重最高的扩展词得分），查询词之间仍为AND
+     * 得分为 weight * TF-IDF 的累加，需要先设置词典（setTermDictionary）
+     *
+     * @param query 查询字符串
+     * @param top_k 返回前K个结果
+     * @param options 模糊匹配配置
+     * @return 搜索结果列表（按分数降序）
+     */
+    std::vector<SearchResult> searchFuzzy(const std::string& query, size_t top_k = 10,
+                                          const FuzzyOptions& options = FuzzyOptions()) const;
+
+    /**
+     * @brief 在影响值索引上执行带预算的查询（score-at-a-time，OR语义）
+     *
+     * 需要先设置影响值索引（setImpactIndex）。预算耗尽时返回当前累加结果中的top-k，
+     * stats中的budget_exhausted标记结果是否为近似
+     *
+     * @param query 查询字符串
+     * @param top_k 返回前K个结果
+     * @param budget 查询预算（posting数 / 时间）
+     * @param stats 输出执行统计（可选）
+     * @return 搜索结果列表（按分数降序）
+     */
+    std::vector<SearchResult> searchImpact(const std::string& query, size_t top_k = 10,
+                                           const ImpactBudget& budget = ImpactBudget(),
+                                           ImpactSearchStats* stats = nullptr) const;
+
+    /**
+     * @brief 设置文档属性（过滤、按字段排序使用）
+     * @param doc_values 文档属性引用
+     */
+    void setDocValues(const DocValues* doc_values) { doc_values_ = doc_values; }
+
+    /**
+     * @brief 获取过滤位图缓存（查看命中率等）
+     */
+    FilterCache& getFilterCache() const { return filter_cache_; }
+
+    /**
+     * @brief 获取各阶段被截止时间/取消中断的次数
+     */
+    const QueryStageCounters& getStageCounters() const { return stage_counters_; }
+
     /**
      * @brief 设置倒排索引
      * @param index 倒排索引引用
@@ -55,18 +201,73 @@ public:
      */
     void setForwardIndex(ForwardIndex* index) { forward_index_ = index; }
 
+    /**
+     * @brief 设置有序词典（模糊搜索使用）
+     * @param dictionary 词典引用
+     */
+    void setTermDictionary(const TermDictionary* dictionary) { term_dictionary_ = dictionary; }
+
+    /**
+     * @brief 设置影响值索引（searchImpact使用）
+     * @param index 影响值索引引用
+     */
+    void setImpactIndex(const ImpactIndex* index) { impact_index_ = index; }
+
+    /**
+     * @brief 设置是否为结果生成摘要（需要设置正排索引，默认开启）
+     * @param enabled 是否开启
+     */
+    void setSnippetEnabled(bool enabled) { snippet_enabled_ = enabled; }
+
+    /**
+     * @brief 设置摘要生成配置
+     * @param options 摘要配置
+     */
+    void setSnippetOptions(const SnippetOptions& options) { snippet_generator_.setOptions(options); }
+
+    /**
+     * @brief 设置分面收集配置（并行阈值、线程数）
+     * @param options 分面配置
+     */
+    void setFacetOptions(const FacetOptions& options) { facet_options_ = options; }
+
 private:
     /**
      * @brief 执行AND查询（所有词都必须匹配）
      * @param query_terms 查询词列表
-     * @return 匹配的文档ID集合
+     * @param filter 属性过滤位图（可为nullptr）
+     * @param context 查询上下文（中断时返回已确认匹配的文档）
+     * @return 匹配的文档ID列表（升序）
+     */
+    std::vector<int64_t> executeAndQuery(const std::vector<std::string>& query_terms,
+                                         const DocBitset* filter,
+                                         QueryContext& context) const;
+
+    /**
+     * @brief 按分数取top_k；有重排序器时先取前depth个交给模型重新打分
+     */
+    void selectTopK(std::vector<SearchResult>& results, const std::vector<std::string>& query_terms,
+                    size_t top_k, QueryContext& context) const;
+
+    /**
+     * @brief 按字段值选出top_k个文档（无值的排在最后，同值按doc_id升序）
      */
-    std::vector<int64_t> executeAndQuery(const std::vector<std::string>& query_terms) const;
+    void selectByField(std::vector<int64_t>& doc_ids, size_t top_k,
+                       const DocValuesColumn& column, bool descending) const;
 
     InvertedIndex* inverted_index_ = nullptr;
     ForwardIndex* forward_index_ = nullptr;
+    const TermDictionary* term_dictionary_ = nullptr;
+    const ImpactIndex* impact_index_ = nullptr;
+    const DocValues* doc_values_ = nullptr;
     std::unique_ptr<Scorer> scorer_;
+    std::unique_ptr<LtrReranker> reranker_;
     Tokenizer tokenizer_;
+    SnippetGenerator snippet_generator_;
+    bool snippet_enabled_ = true;
+    FacetOptions facet_options_;
+    mutable QueryStageCounters stage_counters_;
+    mutable FilterCache filter_cache_;
 };
 
 } // namespace search_engine
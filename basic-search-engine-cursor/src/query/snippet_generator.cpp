@@ -0,0 +1,224 @@
+#include "query/snippet_generator.h"
+#include "common/utils.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace search_engine {
+
+namespace {
+
+const char kEllipsis[] = "...";
+const uint32_t kEllipsisLen = 3;
+
+// 每生成多少条摘要检查一次截止时间
+const size_t kCheckInterval = 16;
+
+// 命中的token：位置 + 查询词编号
+struct TermHit {
+    uint32_t token;
+    uint32_t term;
+};
+
+// 预筛位图中的位：由长度和首尾字节决定
+uint32_t filterBit(std::string_view term) {
+    return (static_cast<uint32_t>(term.size()) * 131 + static_cast<unsigned char>(term.front()) * 31 +
+            static_cast<unsigned char>(term.back())) & 255;
+}
+
+} // namespace
+
+void SnippetGenerator::TermIndex::add(std::string_view term, uint32_t id) {
+    if (term.empty()) {
+        return;
+    }
+    uint32_t bit = filterBit(term);
+    filter[bit >> 6] |= uint64_t(1) << (bit & 63);
+    ids.emplace(term, id);
+}
+
+int SnippetGenerator::TermIndex::find(std::string_view token) const {
+    if (token.empty()) {
+        return -1;
+    }
+    uint32_t bit = filterBit(token);
+    if (!((filter[bit >> 6] >> (bit & 63)) & 1)) {
+        return -1;
+    }
+    auto it = ids.find(token);
+    return it != ids.end() ? static_cast<int>(it->second) : -1;
+}
+
+SnippetGenerator::TermIndex SnippetGenerator::buildTermIndex(const std::vector<std::string>& query_terms) {
+    TermIndex term_index;
+    term_index.num_terms = query_terms.size();
+    term_index.ids.reserve(query_terms.size());
+    for (size_t i = 0; i < query_terms.size(); ++i) {
+        term_index.add(query_terms[i], static_cast<uint32_t>(i));
+    }
+    return term_index;
+}
+
+void SnippetGenerator::generate(const Document& doc,
+                                const std::vector<std::string>& query_terms,
+                                std::string& snippet,
+                                std::vector<TextSpan>& highlights) const {
+    generate(doc, buildTermIndex(query_terms), snippet, highlights);
+}
+
+void SnippetGenerator::generate(const Document& doc, const TermIndex& term_index,
+                                std::string& snippet, std::vector<TextSpan>& highlights) const {
+    snippet.clear();
+    highlights.clear();
+    const std::string& content = doc.content;
+    const size_t max_bytes = std::max<size_t>(options_.max_bytes, 1);
+
+    // 没有位置信息（或与tokens不一致）时退化为截取开头
+    const auto& offsets = doc.token_offsets;
+    if (offsets.size() != doc.tokens.size() || offsets.empty()) {
+        size_t len = utils::utf8PrefixLength(content, max_bytes);
+        snippet.assign(content, 0, len);
+        if (len < content.size()) {
+            snippet += kEllipsis;
+        }
+        return;
+    }
+
+    // 1. 收集命中位置（已存储的token逐个查一次查询词表，不重新分词）
+    // 重复的查询词总是匹配到第一次出现的编号，不需要额外去重
+    thread_local std::vector<TermHit> hits;
+    hits.clear();
+    for (size_t i = 0; i < doc.tokens.size(); ++i) {
+        int term = term_index.find(doc.tokens[i]);
+        if (term >= 0) {
+            hits.push_back({static_cast<uint32_t>(i), static_cast<uint32_t>(term)});
+        }
+    }
+
+    // 2. 滑动窗口：窗口内命中的字节跨度不超过max_bytes，最大化(不同词数, 命中数)
+    size_t first_token = 0;
+    size_t last_token = 0;
+    if (!hits.empty()) {
+        thread_local std::vector<uint32_t> counts;
+        counts.assign(term_index.num_terms, 0);
+        size_t distinct = 0;
+        size_t best_l = 0, best_r = 0, best_distinct = 0, best_hits = 0;
+        size_t l = 0;
+        for (size_t r = 0; r < hits.size(); ++r) {
+            if (counts[hits[r].term]++ == 0) {
+                distinct++;
+            }
+            while (l < r && offsets[hits[r].token].end - offsets[hits[l].token].begin > max_bytes) {
+                if (--counts[hits[l].term] == 0) {
+                    distinct--;
+                }
+                l++;
+            }
+            size_t window_hits = r - l + 1;
+            if (distinct > best_distinct || (distinct == best_distinct && window_hits > best_hits)) {
+                best_distinct = distinct;
+                best_hits = window_hits;
+                best_l = l;
+                best_r = r;
+            }
+        }
+        first_token = hits[best_l].token;
+        last_token = hits[best_r].token;
+    }
+
+    // 3. 向两侧交替扩展整token，填满字节预算
+    uint32_t begin = offsets[first_token].begin;
+    uint32_t end = offsets[last_token].end;
+    bool grew = true;
+    while (grew) {
+        grew = false;
+        if (last_token + 1 < offsets.size() && offsets[last_token + 1].end - begin <= max_bytes) {
+            end = offsets[++last_token].end;
+            grew = true;
+        }
+        if (first_token > 0 && end - offsets[first_token - 1].begin <= max_bytes) {
+            begin = offsets[--first_token].begin;
+            grew = true;
+        }
+    }
+    // 单个token超长：按UTF-8字符边界截断
+    if (end - begin > max_bytes) {
+        std::string_view window(content.data() + begin, end - begin);
+        end = begin + static_cast<uint32_t>(utils::utf8PrefixLength(window, max_bytes));
+    }
+
+    // 4. 输出摘要与高亮（位置相对于snippet）
+    // 前后还有未展示的token时加省略号
+    const bool leading = first_token > 0;
+    const bool trailing = last_token + 1 < offsets.size() || end < offsets[last_token].end;
+    snippet.reserve(end - begin + 2 * kEllipsisLen);
+    if (leading) {
+        snippet += kEllipsis;
+    }
+    snippet.append(content, begin, end - begin);
+    if (trailing) {
+        snippet += kEllipsis;
+    }
+
+    const uint32_t shift = leading ? kEllipsisLen : 0;
+    for (const auto& hit : hits) {
+        const TextSpan& span = offsets[hit.token];
+        if (span.begin >= begin && span.end <= end) {
+            highlights.emplace_back(span.begin - begin + shift, span.end - begin + shift);
+        }
+    }
+}
+
+void SnippetGenerator::fill(std::vector<SearchResult>& results,
+                            const std::vector<std::string>& query_terms,
+                            const ForwardIndex& forward_index,
+                            QueryContext* context) const {
+    const TermIndex term_index = buildTermIndex(query_terms);
+    size_t threads = std::min<size_t>(options_.max_threads,
+                                      std::max<unsigned>(1, std::thread::hardware_concurrency()));
+    bool completed = true;
+    if (results.size() < options_.parallel_threshold || threads <= 1) {
+        completed = fillRange(results, 0, results.size(), term_index, forward_index, context);
+    } else {
+        // 结果较多时按区间并行（正排索引只读访问，线程安全）
+        std::vector<std::thread> workers;
+        std::atomic<bool> all_completed{true};
+        size_t chunk = (results.size() + threads - 1) / threads;
+        for (size_t begin = chunk; begin < results.size(); begin += chunk) {
+            size_t end = std::min(begin + chunk, results.size());
+            workers.emplace_back([&, begin, end]() {
+                if (!fillRange(results, begin, end, term_index, forward_index, context)) {
+                    all_completed = false;
+                }
+            });
+        }
+        completed = fillRange(results, 0, std::min(chunk, results.size()), term_index, forward_index, context);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        completed = completed && all_completed;
+    }
+
+    // 工作线程只读取截止状态，中断统一在这里记录
+    if (!completed && context) {
+        context->checkpoint(QueryStage::kSnippet);
+    }
+}
+
+bool SnippetGenerator::fillRange(std::vector<SearchResult>& results, size_t begin, size_t end,
+                                 const TermIndex& term_index,
+                                 const ForwardIndex& forward_index,
+                                 const QueryContext* context) const {
+    for (size_t i = begin; i < end; ++i) {
+        if (context && (i - begin) % kCheckInterval == 0 && context->expired()) {
+            return false;
+        }
+        const Document* doc = forward_index.findDocument(results[i].doc_id);
+        if (doc) {
+            generate(*doc, term_index, results[i].snippet, results[i].highlights);
+        }
+    }
+    return true;
+}
+
+} // namespace search_engine
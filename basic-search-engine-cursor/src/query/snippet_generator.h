@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "common/document.h"
+#include "index/forward_index.h"
+#include "rank/scorer.h"
+#include "query/query_context.h"
+
+namespace search_engine {
+
+/**
+ * @brief 摘要生成配置
+ */
+struct SnippetOptions {
+    size_t max_bytes = 120;             // 摘要正文最大字节数（不含省略号）
+    size_t parallel_threshold = 256;    // 结果数达到该值时并行生成
+    size_t max_threads = 4;             // 并行生成的最大线程数
+};
+
+/**
+ * @brief 查询相关的摘要生成器
+ *
+ * 在文档中选出覆盖查询词最多的窗口作为摘要，并返回高亮位置
+ *
+ * 设计思路：
+ * - 直接使用建索引时保存的tokens和token_offsets，不重新分词
+ * - 查询词每个查询只建一次哈希表，每个token只查一次
+ * - 双指针滑动窗口：优先覆盖更多不同的查询词，其次命中次数更多
+ * - 窗口边界对齐到token边界，超长token按UTF-8字符边界截断
+ * - 只对最终的top-k结果调用
+ */
+class SnippetGenerator {
+public:
+    explicit SnippetGenerator(const SnippetOptions& options = SnippetOptions())
+        : options_(options) {}
+
+    /**
+     * @brief 为单个文档生成摘要
+     * @param doc 文档（需包含tokens和token_offsets）
+     * @param query_terms 标准化后的查询词
+     * @param snippet 输出摘要文本
+     * @param highlights 输出高亮区间（相对于snippet）
+     */
+    void generate(const Document& doc,
+                  const std::vector<std::string>& query_terms,
+                  std::string& snippet,
+                  std::vector<TextSpan>& highlights) const;
+
+    /**
+     * @brief 为搜索结果批量填充snippet和highlights
+     * @param results 搜索结果（通常是最终的top-k）
+     * @param query_terms 标准化后的查询词
+     * @param forward_index 正排索引
+     * @param context 查询上下文（可选）；中断后剩余结果的snippet保持为空
+     */
+    void fill(std::vector<SearchResult>& results,
+              const std::vector<std::string>& query_terms,
+              const ForwardIndex& forward_index,
+              QueryContext* context = nullptr) const;
+
+    const SnippetOptions& options() const { return options_; }
+    void setOptions(const SnippetOptions& options) { options_ = options; }
+
+private:
+    // 每个查询建一次的查询词表：按(长度, 首尾字节)置位的预筛位图挡掉绝大多数token，
+    // 通过预筛的再查哈希表。编号取该词第一次出现的位置，键指向query_terms中的字符串
+    struct TermIndex {
+        uint64_t filter[4] = {0, 0, 0, 0};
+        std::unordered_map<std::string_view, uint32_t> ids;
+        size_t num_terms = 0;
+
+        void add(std::string_view term, uint32_t id);
+
+        // 查询词编号，未命中返回-1
+        int find(std::string_view token) const;
+    };
+
+    static TermIndex buildTermIndex(const std::vector<std::string>& query_terms);
+
+    void generate(const Document& doc, const TermIndex& term_index,
+                  std::string& snippet, std::vector<TextSpan>& highlights) const;
+
+    // 返回false表示因截止时间/取消提前停止
+    bool fillRange(std::vector<SearchResult>& results, size_t begin, size_t end,
+                   const TermIndex& term_index,
+                   const ForwardIndex& forward_index,
+                   const QueryContext* context) const;
+
+    SnippetOptions options_;
+};
+
+} // namespace search_engine
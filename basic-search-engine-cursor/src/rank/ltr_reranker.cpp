@@ -0,0 +1,149 @@
+#include "rank/ltr_reranker.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace search_engine {
+
+namespace {
+
+double* column(FeatureMatrix& features, RankFeature feature) {
+    return features.column(static_cast<size_t>(feature));
+}
+
+} // namespace
+
+bool LtrReranker::load(const std::string& path) {
+    return validate(model_.load(path));
+}
+
+bool LtrReranker::loadFromString(const std::string& text) {
+    return validate(model_.loadFromString(text));
+}
+
+bool LtrReranker::validate(bool loaded) {
+    if (!loaded) {
+        error_ = model_.lastError();
+        return false;
+    }
+    if (model_.getFeatureCount() > static_cast<size_t>(RankFeature::kCount)) {
+        error_ = "模型使用了未定义的特征号 " + std::to_string(model_.getFeatureCount() - 1);
+        model_.clear();
+        return false;
+    }
+    error_.clear();
+    return true;
+}
+
+void LtrReranker::extractFeatures(const std::vector<SearchResult>& candidates,
+                                  const std::vector<std::string>& query_terms,
+                                  const InvertedIndex& inverted_index,
+                                  FeatureMatrix& features) const {
+    const size_t n = candidates.size();
+    features.reset(n, static_cast<size_t>(RankFeature::kCount));
+
+    std::vector<std::string> terms(query_terms);
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    double* first_stage = column(features, RankFeature::kFirstStageScore);
+    double* doc_length = column(features, RankFeature::kDocLength);
+    double* tf_min = column(features, RankFeature::kTfMin);
+    std::fill(column(features, RankFeature::kQueryTerms), column(features, RankFeature::kQueryTerms) + n,
+              static_cast<double>(terms.size()));
+    std::fill(tf_min, tf_min + n, std::numeric_limits<double>::infinity());
+
+    // 文档长度和平均长度都用倒排索引的全库统计，不随候选集合变化
+    for (size_t i = 0; i < n; ++i) {
+        first_stage[i] = candidates[i].score;
+        doc_length[i] = static_cast<double>(inverted_index.getDocLength(candidates[i].doc_id));
+    }
+    double avg_length = options_.avg_doc_length;
+    if (avg_length <= 0.0) {
+        avg_length = inverted_index.getAverageDocLength();
+    }
+    if (avg_length <= 0.0) {
+        avg_length = 1.0;
+    }
+
+    // 候选按doc_id升序访问，每个posting列表只向前推进一遍
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&candidates](size_t a, size_t b) {
+        return candidates[a].doc_id < candidates[b].doc_id;
+    });
+
+    const double total_docs = static_cast<double>(inverted_index.getTotalDocuments());
+    double* matched = column(features, RankFeature::kMatchedTerms);
+    double* tf_sum = column(features, RankFeature::kTfSum);
+    double* tf_max = column(features, RankFeature::kTfMax);
+    double* idf_sum = column(features, RankFeature::kIdfSum);
+    double* idf_max = column(features, RankFeature::kIdfMax);
+    double* tfidf_sum = column(features, RankFeature::kTfIdfSum);
+    double* bm25_sum = column(features, RankFeature::kBm25Sum);
+
+    for (const auto& term : terms) {
+        const auto* postings = inverted_index.getPostings(term);
+        if (!postings || postings->empty() || total_docs == 0.0) {
+            continue;
+        }
+        const double df = static_cast<double>(postings->size());
+        const double idf = std::log(total_docs / df);
+        const double bm25_idf = std::log(1.0 + (total_docs - df + 0.5) / (df + 0.5));
+
+        auto cursor = postings->begin();
+        for (size_t i : order) {
+            const int64_t doc_id = candidates[i].doc_id;
+            cursor = std::lower_bound(cursor, postings->end(), doc_id,
+                                      [](const Posting& posting, int64_t id) { return posting.doc_id < id; });
+            if (cursor == postings->end()) {
+                break;
+            }
+            if (cursor->doc_id != doc_id) {
+                continue;
+            }
+            const double tf = static_cast<double>(cursor->term_freq);
+            matched[i] += 1.0;
+            tf_sum[i] += tf;
+            tf_min[i] = std::min(tf_min[i], tf);
+            tf_max[i] = std::max(tf_max[i], tf);
+            idf_sum[i] += idf;
+            idf_max[i] = std::max(idf_max[i], idf);
+            tfidf_sum[i] += tf * idf;
+            const double norm = options_.k1 * (1.0 - options_.b + options_.b * doc_length[i] / avg_length);
+            bm25_sum[i] += bm25_idf * tf * (options_.k1 + 1.0) / (tf + norm);
+        }
+    }
+
+    // 没有命中任何词的文档最小词频记为0
+    for (size_t i = 0; i < n; ++i) {
+        if (matched[i] == 0.0) {
+            tf_min[i] = 0.0;
+        }
+    }
+}
+
+void LtrReranker::rerank(std::vector<SearchResult>& candidates,
+                         const std::vector<std::string>& query_terms,
+                         const InvertedIndex& inverted_index) const {
+    if (candidates.empty() || model_.getTreeCount() == 0) {
+        return;
+    }
+
+    // 特征矩阵在同一线程的多次查询间复用
+    thread_local FeatureMatrix features;
+    thread_local std::vector<double> scores;
+    extractFeatures(candidates, query_terms, inverted_index, features);
+    if (!model_.predict(features, scores)) {
+        return;  // 不会发生：load时已保证模型特征号都在RankFeature之内
+    }
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        candidates[i].score = scores[i];
+    }
+    // 模型得分相同时保持第一阶段的顺序
+    std::stable_sort(candidates.begin(), candidates.end());
+}
+
+} // namespace search_engine
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "index/inverted_index.h"
+#include "rank/scorer.h"
+#include "rank/tree_ensemble.h"
+
+namespace search_engine {
+
+/**
+ * @brief 重排序特征（模型中的特征号即枚举值）
+ */
+enum class RankFeature {
+    kFirstStageScore = 0,   // 第一阶段得分
+    kQueryTerms,            // 查询词数（去重后）
+    kMatchedTerms,          // 文档命中的查询词数
+    kTfSum,                 // 命中词的词频之和
+    kTfMin,                 // 命中词的最小词频
+    kTfMax,                 // 命中词的最大词频
+    kIdfSum,                // 命中词的IDF之和
+    kIdfMax,                // 命中词的最大IDF
+    kTfIdfSum,              // TF-IDF之和
+    kBm25Sum,               // BM25之和（文档长度和平均长度取自倒排索引的全库统计）
+    kDocLength,             // 文档长度（各词词频之和，与BM25使用的长度相同）
+    kCount
+};
+
+/**
+ * @brief 重排序配置
+ */
+struct RerankOptions {
+    size_t depth = 100;            // 第一阶段取前多少个结果交给模型
+    double k1 = 1.2;               // BM25参数
+    double b = 0.75;               // BM25参数
+    double avg_doc_length = 0.0;   // 平均文档长度（0表示使用倒排索引的全库平均长度）
+};
+
+/**
+ * @brief 第二阶段重排序器（梯度提升树，Learning to Rank）
+ *
+ * 第一阶段（倒排求交 + 简单打分）选出top-N，重排序器为这N个文档计算特征、
+ * 用树模型打分，按模型得分重新排序
+ *
+ * 设计思路：
+ * - 特征按列批量计算：候选文档按doc_id排序后，每个查询词只沿posting列表向前推进一遍，
+ *   得到所有候选的词频，不对每个(文档, 词)单独二分查找
+ * - 特征矩阵按列存放，树评估见TreeEnsemble::predict
+ * - 模型中的特征号对应RankFeature的枚举值，训练数据需按同样的顺序导出
+ * - 特征只依赖文档和全库统计，与depth和第一阶段召回了哪些文档无关，离线导出的训练特征与线上一致
+ */
+class LtrReranker {
+public:
+    explicit LtrReranker(const RerankOptions& options = RerankOptions()) : options_(options) {}
+
+    /**
+     * @brief 加载模型文件（LightGBM文本模型或XGBoost dump）
+     * @return 是否成功；模型用到RankFeature之外的特征时也返回false（原因见lastError()）
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief 从文本加载模型
+     */
+    bool loadFromString(const std::string& text);
+
+    /**
+     * @brief 为候选文档计算特征
+     * @param candidates 第一阶段结果（score为第一阶段得分）
+     * @param query_terms 查询词
+     * @param inverted_index 倒排索引（提供词频、DF、文档长度和平均文档长度）
+     * @param features 输出特征矩阵（candidates.size()行 × RankFeature::kCount列）
+     */
+    void extractFeatures(const std::vector<SearchResult>& candidates,
+                         const std::vector<std::string>& query_terms,
+                         const InvertedIndex& inverted_index,
+                         FeatureMatrix& features) const;
+
+    /**
+     * @brief 用模型得分替换候选的score并按新得分降序排序
+     */
+    void rerank(std::vector<SearchResult>& candidates,
+                const std::vector<std::string>& query_terms,
+                const InvertedIndex& inverted_index) const;
+
+    const RerankOptions& options() const { return options_; }
+    void setOptions(const RerankOptions& options) { options_ = options; }
+
+    const TreeEnsemble& model() const { return model_; }
+    const std::string& lastError() const { return error_; }
+
+private:
+    bool validate(bool loaded);
+
+    RerankOptions options_;
+    TreeEnsemble model_;
+    std::string error_;
+};
+
+} // namespace search_engine
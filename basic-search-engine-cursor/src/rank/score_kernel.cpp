@@ -0,0 +1,185 @@
+#include "rank/score_kernel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace search_engine {
+
+namespace {
+
+// 单个(文档, 词)的得分；tf为0表示文档不包含该词
+template <ScoringModel Model>
+inline double contribution(double tf, double weight, double norm, double k1_plus_1) {
+    if constexpr (Model == ScoringModel::kBm25) {
+        return tf > 0.0 ? weight * tf * k1_plus_1 / (tf + norm) : 0.0;
+    } else {
+        // TF-IDF为tf * idf；简单计数时decode写入的是0/1，权重为1
+        (void)norm;
+        (void)k1_plus_1;
+        return tf * weight;
+    }
+}
+
+} // namespace
+
+bool ScoreKernel::prepare(const Scorer& scorer,
+                          const std::vector<std::string>& query_terms,
+                          const InvertedIndex& inverted_index) {
+    std::vector<const std::vector<Posting>*> postings;
+    postings.reserve(query_terms.size());
+    for (const auto& term : query_terms) {
+        postings.push_back(inverted_index.getPostings(term));
+    }
+    return prepare(scorer, postings, inverted_index);
+}
+
+bool ScoreKernel::prepare(const Scorer& scorer,
+                          const std::vector<const std::vector<Posting>*>& term_postings,
+                          const InvertedIndex& inverted_index) {
+    const ScoringModel model = scorer.model();
+    const Bm25Scorer* bm25 = nullptr;
+    if (model == ScoringModel::kBm25) {
+        bm25 = dynamic_cast<const Bm25Scorer*>(&scorer);
+        if (!bm25) {
+            return false;
+        }
+        k1_ = bm25->k1();
+        b_ = bm25->b();
+        avg_length_ = inverted_index.getAverageDocLength();
+    }
+
+    inverted_index_ = &inverted_index;
+    presence_ = model == ScoringModel::kSimple;
+    postings_.clear();
+    weights_.clear();
+
+    const size_t total_docs = inverted_index.getTotalDocuments();
+    const bool weighted = model != ScoringModel::kSimple;
+    // 与Scorer::score()的提前返回条件保持一致：此时所有得分为0
+    const bool empty = (weighted && total_docs == 0) || (bm25 && avg_length_ <= 0.0);
+    for (const auto* postings : term_postings) {
+        if (empty || !postings || postings->empty()) {
+            continue;
+        }
+        const double df = static_cast<double>(postings->size());
+        double weight = 1.0;
+        if (model == ScoringModel::kTfIdf) {
+            weight = std::log(static_cast<double>(total_docs) / postings->size());
+        } else if (model == ScoringModel::kBm25) {
+            weight = std::log(1.0 + (total_docs - df + 0.5) / (df + 0.5));
+        }
+        postings_.push_back(postings);
+        weights_.push_back(weight);
+    }
+    cursors_.assign(postings_.size(), 0);
+    tf_.resize(postings_.size() * kBlockSize);
+    norms_.resize(kBlockSize);
+
+    switch (model) {
+        case ScoringModel::kTfIdf:
+            block_ = selectBlock<ScoringModel::kTfIdf>(postings_.size());
+            return true;
+        case ScoringModel::kBm25:
+            block_ = selectBlock<ScoringModel::kBm25>(postings_.size());
+            return true;
+        case ScoringModel::kSimple:
+            block_ = selectBlock<ScoringModel::kSimple>(postings_.size());
+            return true;
+        case ScoringModel::kCustom:
+            break;
+    }
+    block_ = nullptr;
+    return false;
+}
+
+template <ScoringModel Model>
+ScoreKernel::BlockFunction ScoreKernel::selectBlock(size_t terms) {
+    switch (terms) {
+        case 1: return &scoreBlock<Model, 1>;
+        case 2: return &scoreBlock<Model, 2>;
+        case 3: return &scoreBlock<Model, 3>;
+        case 4: return &scoreBlock<Model, 4>;
+        default: return &scoreBlock<Model, 0>;
+    }
+}
+
+void ScoreKernel::score(const int64_t* doc_ids, size_t count, double* scores) {
+    for (size_t begin = 0; begin < count; begin += kBlockSize) {
+        const size_t block = std::min(kBlockSize, count - begin);
+        for (size_t t = 0; t < postings_.size(); ++t) {
+            decode(t, doc_ids + begin, block);
+        }
+        block_(*this, doc_ids + begin, block, scores + begin);
+    }
+}
+
+void ScoreKernel::score(const int64_t* doc_ids, size_t count, const std::vector<const double*>& term_freqs,
+                        double* scores) {
+    for (size_t begin = 0; begin < count; begin += kBlockSize) {
+        const size_t block = std::min(kBlockSize, count - begin);
+        for (size_t t = 0; t < postings_.size(); ++t) {
+            const double* source = term_freqs[t] + begin;
+            double* tf = tf_.data() + t * kBlockSize;
+            for (size_t i = 0; i < block; ++i) {
+                tf[i] = presence_ ? (source[i] > 0.0 ? 1.0 : 0.0) : source[i];
+            }
+        }
+        block_(*this, doc_ids + begin, block, scores + begin);
+    }
+}
+
+void ScoreKernel::decode(size_t term, const int64_t* doc_ids, size_t count) {
+    const auto& postings = *postings_[term];
+    double* tf = tf_.data() + term * kBlockSize;
+    size_t cursor = cursors_[term];
+    for (size_t i = 0; i < count; ++i) {
+        const int64_t doc_id = doc_ids[i];
+        // 文档ID变小（如按字段排序后的结果）时从头查找
+        if (cursor > 0 && postings[cursor - 1].doc_id >= doc_id) {
+            cursor = 0;
+        }
+        cursor = InvertedIndex::seek(postings, cursor, doc_id);
+        if (cursor < postings.size() && postings[cursor].doc_id == doc_id) {
+            tf[i] = presence_ ? 1.0 : static_cast<double>(postings[cursor].term_freq);
+        } else {
+            tf[i] = 0.0;
+        }
+    }
+    cursors_[term] = cursor;
+}
+
+template <ScoringModel Model, size_t Terms>
+void ScoreKernel::scoreBlock(ScoreKernel& kernel, const int64_t* doc_ids, size_t count, double* scores) {
+    const size_t terms = Terms > 0 ? Terms : kernel.weights_.size();
+    double* norms = kernel.norms_.data();
+    const double k1_plus_1 = kernel.k1_ + 1.0;
+    if constexpr (Model == ScoringModel::kBm25) {
+        for (size_t i = 0; i < count; ++i) {
+            const double length = static_cast<double>(kernel.inverted_index_->getDocLength(doc_ids[i]));
+            norms[i] = kernel.k1_ * (1.0 - kernel.b_ + kernel.b_ * length / kernel.avg_length_);
+        }
+    }
+
+    const double* tf = kernel.tf_.data();
+    const double* weights = kernel.weights_.data();
+    if constexpr (Terms > 0) {
+        // 词数固定：内层循环完全展开，每个文档的得分留在寄存器里
+        for (size_t i = 0; i < count; ++i) {
+            double sum = 0.0;
+            for (size_t t = 0; t < Terms; ++t) {
+                sum += contribution<Model>(tf[t * kBlockSize + i], weights[t], norms[i], k1_plus_1);
+            }
+            scores[i] = sum;
+        }
+    } else {
+        std::fill(scores, scores + count, 0.0);
+        for (size_t t = 0; t < terms; ++t) {
+            const double* term_tf = tf + t * kBlockSize;
+            const double weight = weights[t];
+            for (size_t i = 0; i < count; ++i) {
+                scores[i] += contribution<Model>(term_tf[i], weight, norms[i], k1_plus_1);
+            }
+        }
+    }
+}
+
+} // namespace search_engine
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "index/inverted_index.h"
+#include "rank/scorer.h"
+
+namespace search_engine {
+
+/**
+ * @brief 批量打分内核（内置排序公式的编译期特化版本）
+ *
+ * Scorer::score()每次调用只给一个文档打分：虚函数调用挡住了内联，
+ * 每个(文档, 词)都要查一次词典并在posting列表上二分查找
+ *
+ * 设计思路：
+ * - prepare()在查询开始时把每个词的posting列表和权重（IDF）解析成按词排列的数组（SoA），
+ *   之后对整块文档打分时不再查词典
+ * - 按块（kBlockSize个文档）处理：先逐词沿posting列表倍增查找，把词频解码到tf_[词][块内位置]
+ *   （批量查询时由调用方直接提供已解码的词频），再对整块做纯算术的打分循环；打分循环没有分支和函数调用，编译器可以内联并自动向量化
+ * - 打分循环是模板 scoreBlock<公式, 词数>，按公式（TF-IDF/BM25/简单计数）和查询词数（1~4，
+ *   更多词走运行期词数的版本）在prepare()时选定一个实例，块内不再判断公式类型
+ * - 累加顺序与Scorer::score()相同（按查询词顺序，重复的词重复计分），得分逐位一致
+ * - 自定义排序器（model()为kCustom）不走内核，prepare()返回false，由调用方逐文档调用score()
+ */
+class ScoreKernel {
+public:
+    static constexpr size_t kBlockSize = 256;
+
+    /**
+     * @brief 为一次查询准备内核
+     * @param scorer 排序器（决定公式和参数）
+     * @param query_terms 查询词
+     * @param inverted_index 倒排索引（打分期间需保持不变）
+     * @return 是否可用（自定义排序器返回false）
+     */
+    bool prepare(const Scorer& scorer,
+                 const std::vector<std::string>& query_terms,
+                 const InvertedIndex& inverted_index);
+
+    /**
+     * @brief 用已查好的posting列表准备内核（批量查询时每个词只查一次词典）
+     * @param term_postings 按查询词顺序排列的posting列表（nullptr表示词不存在）
+     */
+    bool prepare(const Scorer& scorer,
+                 const std::vector<const std::vector<Posting>*>& term_postings,
+                 const InvertedIndex& inverted_index);
+
+    /**
+     * @brief 批量打分
+     * @param doc_ids 文档ID（升序时posting列表只向前推进一遍，乱序也能得到正确结果）
+     * @param count 文档数
+     * @param scores 输出得分（count个）
+     */
+    void score(const int64_t* doc_ids, size_t count, double* scores);
+
+    /**
+     * @brief 用调用方已解码的词频批量打分（不再查找posting列表）
+     * @param doc_ids 文档ID
+     * @param count 文档数
+     * @param term_freqs 每个有posting的查询词一列（按查询词顺序，与prepare时去掉空词后的顺序一致），
+     *                   term_freqs[t][i]为第i个文档的词频（不包含为0）
+     * @param scores 输出得分（count个）
+     */
+    void score(const int64_t* doc_ids, size_t count, const std::vector<const double*>& term_freqs,
+               double* scores);
+
+private:
+    using BlockFunction = void (*)(ScoreKernel&, const int64_t*, size_t, double*);
+
+    template <ScoringModel Model, size_t Terms>
+    static void scoreBlock(ScoreKernel& kernel, const int64_t* doc_ids, size_t count, double* scores);
+
+    template <ScoringModel Model>
+    static BlockFunction selectBlock(size_t terms);
+
+    // 把第term个词在这块文档上的词频解码到tf_（不包含的文档为0）
+    void decode(size_t term, const int64_t* doc_ids, size_t count);
+
+    const InvertedIndex* inverted_index_ = nullptr;
+    BlockFunction block_ = nullptr;
+    bool presence_ = false;           // 简单计数：命中记1而不是词频
+
+    // 每个查询词一项（没有posting的词已去掉）
+    std::vector<const std::vector<Posting>*> postings_;
+    std::vector<double> weights_;     // IDF（简单计数为1）
+    std::vector<size_t> cursors_;     // 各posting列表上次停下的位置
+
+    std::vector<double> tf_;          // tf_[term * kBlockSize + i]
+    std::vector<double> norms_;       // BM25长度归一化项（块内每个文档一个）
+
+    double k1_ = 0.0;
+    double b_ = 0.0;
+    double avg_length_ = 0.0;
+};
+
+} // namespace search_engine
@@ -3,6 +3,17 @@
 
 namespace search_engine {
 
+namespace {
+
+// 在按doc_id升序的posting列表中二分查找文档
+const Posting* findPosting(const std::vector<Posting>& postings, int64_t doc_id) {
+    auto it = std::lower_bound(postings.begin(), postings.end(), doc_id,
+                               [](const Posting& posting, int64_t id) { return posting.doc_id < id; });
+    return (it != postings.end() && it->doc_id == doc_id) ? &*it : nullptr;
+}
+
+} // namespace
+
 void Scorer::sortResults(std::vector<SearchResult>& results) const {
     std::sort(results.begin(), results.end());
 }
@@ -18,22 +29,54 @@ double TfIdfScorer::score(int64_t doc_id,
     }
     
     for (const auto& term : query_terms) {
-        auto postings = inverted_index.search(term);
+        const auto* postings = inverted_index.getPostings(term);
+        if (!postings) {
+            continue;
+        }
+        
+        // 找到该文档的posting（列表按doc_id有序，二分查找，不拷贝）
+        const Posting* posting = findPosting(*postings, doc_id);
+        if (posting) {
+            // 计算TF
+            double tf = static_cast<double>(posting->term_freq);
+            
+            // 计算IDF（DF即posting列表长度）
+            size_t df = postings->size();
+            double idf = std::log(static_cast<double>(total_docs) / df);
+            total_score += tf * idf;
+        }
+    }
+    
+    return total_score;
+}
+
+double Bm25Scorer::score(int64_t doc_id,
+                        const std::vector<std::string>& query_terms,
+                        const InvertedIndex& inverted_index) const {
+    double total_score = 0.0;
+    size_t total_docs = inverted_index.getTotalDocuments();
+    double avg_length = inverted_index.getAverageDocLength();
+    
+    if (total_docs == 0 || avg_length <= 0.0) {
+        return 0.0;
+    }
+    
+    // 长度归一化项对同一文档的所有查询词相同
+    double length = static_cast<double>(inverted_index.getDocLength(doc_id));
+    double norm = k1_ * (1.0 - b_ + b_ * length / avg_length);
+    
+    for (const auto& term : query_terms) {
+        const auto* postings = inverted_index.getPostings(term);
+        if (!postings) {
+            continue;
+        }
         
-        // 找到该文档的posting
-        for (const auto& posting : postings) {
-            if (posting.doc_id == doc_id) {
-                // 计算TF
-                double tf = static_cast<double>(posting.term_freq);
-                
-                // 计算IDF
-                size_t df = inverted_index.getDocumentFrequency(term);
-                if (df > 0) {
-                    double idf = std::log(static_cast<double>(total_docs) / df);
-                    total_score += tf * idf;
-                }
-                break;
-            }
+        const Posting* posting = findPosting(*postings, doc_id);
+        if (posting) {
+            double tf = static_cast<double>(posting->term_freq);
+            double df = static_cast<double>(postings->size());
+            double idf = std::log(1.0 + (total_docs - df + 0.5) / (df + 0.5));
+            total_score += idf * tf * (k1_ + 1.0) / (tf + norm);
         }
     }
     
@@ -46,12 +89,9 @@ double SimpleScorer::score(int64_t doc_id,
     int match_count = 0;
     
     for (const auto& term : query_terms) {
-        auto postings = inverted_index.search(term);
-        for (const auto& posting : postings) {
-            if (posting.doc_id == doc_id) {
-                match_count++;
-                break;
-            }
+        const auto* postings = inverted_index.getPostings(term);
+        if (postings && findPosting(*postings, doc_id)) {
+            match_count++;
         }
     }
     
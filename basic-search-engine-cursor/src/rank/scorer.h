@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <cmath>
 #include "index/inverted_index.h"
+#include "common/document.h"
 
 namespace search_engine {
 
@@ -14,7 +15,8 @@ namespace search_engine {
 struct SearchResult {
     int64_t doc_id;      // 文档ID
     double score;        // 相关性分数
-    std::string snippet; // 文档摘要（后续实现）
+    std::string snippet; // 文档摘要（包含查询词的最佳片段）
+    std::vector<TextSpan> highlights;  // 查询词在snippet中的位置
     
     SearchResult() : doc_id(-1), score(0.0) {}
     SearchResult(int64_t id, double s) : doc_id(id), score(s) {}
@@ -25,12 +27,25 @@ struct SearchResult {
     }
 };
 
+/**
+ * @brief 排序公式类型（内置公式可由ScoreKernel批量计算）
+ */
+enum class ScoringModel {
+    kCustom,   // 自定义排序器，只能逐文档调用score()
+    kTfIdf,
+    kBm25,
+    kSimple
+};
+
 /**
  * @brief 排序器基类
  * 
  * 设计思路：
- * - 当前实现：TF-IDF、简单词频统计
- * - 后续可扩展：BM25、学习排序（Learning to Rank）、向量相似度等
+ * - 当前实现：TF-IDF、BM25、简单词频统计
+ * - 内置排序器通过model()声明公式，查询时由ScoreKernel按块批量打分；
+ *   自定义排序器保持默认的kCustom，逐文档调用虚函数score()
+ * - 学习排序（Learning to Rank）见LtrReranker，作为第二阶段对top-N重新打分
+ * - 后续可扩展：向量相似度等
  */
 class Scorer {
 public:
@@ -48,6 +63,14 @@ public:
                         const std::vector<std::string>& query_terms,
                         const InvertedIndex& inverted_index) const = 0;
 
+    /**
+     * @brief 排序公式类型
+     *
+     * 返回kCustom以外的值表示score()与该内置公式完全一致，可以用ScoreKernel代替逐文档调用；
+     * 继承内置排序器并重写score()时需同时重写此函数返回kCustom
+     */
+    virtual ScoringModel model() const { return ScoringModel::kCustom; }
+
     /**
      * @brief 对搜索结果进行排序
      * @param results 搜索结果列表
@@ -69,6 +92,33 @@ public:
     double score(int64_t doc_id,
                 const std::vector<std::string>& query_terms,
                 const InvertedIndex& inverted_index) const override;
+
+    ScoringModel model() const override { return ScoringModel::kTfIdf; }
+};
+
+/**
+ * @brief BM25排序器
+ * 
+ * BM25 = IDF(term) * TF * (k1 + 1) / (TF + k1 * (1 - b + b * len / avg_len))
+ * - IDF: log(1 + (N - DF + 0.5) / (DF + 0.5))
+ * - len: 文档长度（各term词频之和），avg_len: 平均文档长度
+ */
+class Bm25Scorer : public Scorer {
+public:
+    explicit Bm25Scorer(double k1 = 1.2, double b = 0.75) : k1_(k1), b_(b) {}
+    
+    double score(int64_t doc_id,
+                const std::vector<std::string>& query_terms,
+                const InvertedIndex& inverted_index) const override;
+
+    ScoringModel model() const override { return ScoringModel::kBm25; }
+
+    double k1() const { return k1_; }
+    double b() const { return b_; }
+
+private:
+    double k1_;
+    double b_;
 };
 
 /**
@@ -82,6 +132,8 @@ public:
     double score(int64_t doc_id,
                 const std::vector<std::string>& query_terms,
                 const InvertedIndex& inverted_index) const override;
+
+    ScoringModel model() const override { return ScoringModel::kSimple; }
 };
 
 } // namespace search_engine
@@ -0,0 +1,569 @@
+#include "rank/tree_ensemble.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace search_engine {
+
+namespace {
+
+// 解析空格分隔的数值列表
+template <typename T>
+bool parseList(const std::string& text, std::vector<T>& values) {
+    values.clear();
+    const char* p = text.c_str();
+    char* end = nullptr;
+    while (true) {
+        while (*p == ' ' || *p == '\t') {
+            ++p;
+        }
+        if (*p == '\0' || *p == '\r') {
+            return true;
+        }
+        double value = std::strtod(p, &end);
+        if (end == p) {
+            return false;
+        }
+        values.push_back(static_cast<T>(value));
+        p = end;
+    }
+}
+
+bool startsWith(const std::string& text, const std::string& prefix) {
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+// LightGBM判断0值的阈值（kZeroThreshold）
+const double kZeroThreshold = 1e-35f;
+
+// QuickScorer每次评估的文档数和树数：一块的叶子掩码（kTreeBlock × kBlock × 8字节）留在L1中，
+// 节点条件每个文档块只读一遍
+const size_t kBlock = 32;
+const size_t kTreeBlock = 32;
+static_assert(kBlock <= 32 && kBlock % 2 == 0, "块内缺失值用uint32位图记录，SSE2每次处理两个文档");
+
+/**
+ * @brief 对块内特征值大于阈值（条件为假、走右边）的文档清掉左子树的叶子
+ * @param values 块内kBlock个文档的特征值（16字节对齐）
+ * @param masks 该树上kBlock个文档的叶子掩码
+ */
+inline void clearLeaves(const double* values, double threshold, uint64_t keep, uint64_t* masks) {
+#if defined(__SSE2__)
+    const __m128d t = _mm_set1_pd(threshold);
+    const __m128i clear = _mm_set1_epi64x(static_cast<long long>(~keep));
+    for (size_t d = 0; d < kBlock; d += 2) {
+        const __m128i hit = _mm_castpd_si128(_mm_cmpgt_pd(_mm_load_pd(values + d), t));
+        __m128i* p = reinterpret_cast<__m128i*>(masks + d);
+        _mm_storeu_si128(p, _mm_andnot_si128(_mm_and_si128(hit, clear), _mm_loadu_si128(p)));
+    }
+#else
+    for (size_t d = 0; d < kBlock; ++d) {
+        if (values[d] > threshold) {
+            masks[d] &= keep;
+        }
+    }
+#endif
+}
+
+/**
+ * @brief 数值切分是否走左边（与LightGBM的NumericalDecision一致）
+ * @param missing_type 0: None, 1: Zero, 2: NaN
+ */
+inline bool goLeft(double value, double threshold, bool default_left, uint8_t missing_type) {
+    if (std::isnan(value)) {
+        if (missing_type == 2) {
+            return default_left;
+        }
+        value = 0.0;
+    }
+    if (missing_type == 1 && std::fabs(value) <= kZeroThreshold) {
+        return default_left;
+    }
+    return value <= threshold;
+}
+
+} // namespace
+
+bool TreeEnsemble::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        clear();
+        return fail("无法打开模型文件: " + path);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return loadFromString(buffer.str());
+}
+
+bool TreeEnsemble::loadFromString(const std::string& text) {
+    clear();
+    bool loaded = false;
+    if (text.find("Tree=") != std::string::npos) {
+        loaded = parseLightGbm(text);
+    } else if (text.find("booster[") != std::string::npos) {
+        loaded = parseXgboost(text);
+    } else {
+        return fail("无法识别的模型格式（需要LightGBM文本模型或XGBoost dump）");
+    }
+    if (loaded) {
+        buildQuickScorer();
+    }
+    return loaded;
+}
+
+bool TreeEnsemble::fail(const std::string& message) {
+    clear();
+    error_ = message;
+    return false;
+}
+
+void TreeEnsemble::clear() {
+    features_.clear();
+    thresholds_.clear();
+    left_.clear();
+    right_.clear();
+    default_left_.clear();
+    missing_types_.clear();
+    values_.clear();
+    roots_.clear();
+    qs_offsets_.clear();
+    qs_thresholds_.clear();
+    qs_trees_.clear();
+    qs_masks_.clear();
+    qs_default_left_.clear();
+    qs_missing_types_.clear();
+    qs_zero_missing_.clear();
+    qs_leaf_offsets_.clear();
+    qs_leaf_values_.clear();
+    large_trees_.clear();
+    leaf_count_ = 0;
+    num_features_ = 0;
+    error_.clear();
+}
+
+bool TreeEnsemble::appendTree(const std::vector<LocalNode>& nodes) {
+    if (nodes.empty()) {
+        return fail("模型中有空树");
+    }
+    // 孩子编号总是大于父节点，保证评估时一定能走到叶子
+    const int32_t size = static_cast<int32_t>(nodes.size());
+    for (int32_t i = 0; i < size; ++i) {
+        const LocalNode& node = nodes[i];
+        if (!node.leaf && (node.left <= i || node.right <= i || node.left >= size || node.right >= size)) {
+            return fail("模型中的孩子节点编号无效");
+        }
+    }
+
+    const int32_t base = static_cast<int32_t>(features_.size());
+    for (int32_t i = 0; i < size; ++i) {
+        const LocalNode& node = nodes[i];
+        features_.push_back(node.leaf ? 0 : node.feature);
+        thresholds_.push_back(node.leaf ? 0.0 : node.threshold);
+        left_.push_back(base + (node.leaf ? i : node.left));
+        right_.push_back(base + (node.leaf ? i : node.right));
+        default_left_.push_back(node.default_left ? 1 : 0);
+        missing_types_.push_back(node.missing_type);
+        values_.push_back(node.leaf ? node.value : 0.0);
+        if (node.leaf) {
+            leaf_count_++;
+        } else {
+            num_features_ = std::max(num_features_, static_cast<size_t>(node.feature) + 1);
+        }
+    }
+    roots_.push_back(base);
+    return true;
+}
+
+bool TreeEnsemble::parseLightGbm(const std::string& text) {
+    std::istringstream input(text);
+    std::string line;
+    std::unordered_map<std::string, std::string> fields;
+    bool in_tree = false;
+
+    // 一棵树的字段收集完后转换成局部节点：内部节点i -> i，叶子k -> 内部节点数 + k
+    auto finishTree = [&]() {
+        const size_t num_leaves = static_cast<size_t>(std::atol(fields["num_leaves"].c_str()));
+        std::vector<double> leaf_values;
+        if (num_leaves == 0 || !parseList(fields["leaf_value"], leaf_values) || leaf_values.size() != num_leaves) {
+            return fail("LightGBM模型的叶子数与leaf_value不一致");
+        }
+        if (std::atol(fields["num_cat"].c_str()) > 0) {
+            return fail("不支持类别型切分");
+        }
+
+        const size_t num_nodes = num_leaves - 1;
+        std::vector<double> split_feature, threshold, decision_type, left_child, right_child;
+        if (num_nodes > 0 &&
+            (!parseList(fields["split_feature"], split_feature) || !parseList(fields["threshold"], threshold) ||
+             !parseList(fields["left_child"], left_child) || !parseList(fields["right_child"], right_child) ||
+             split_feature.size() != num_nodes || threshold.size() != num_nodes ||
+             left_child.size() != num_nodes || right_child.size() != num_nodes)) {
+            return fail("LightGBM模型的节点数组长度不一致");
+        }
+        if (num_nodes > 0 && !fields["decision_type"].empty() &&
+            (!parseList(fields["decision_type"], decision_type) || decision_type.size() != num_nodes)) {
+            return fail("LightGBM模型的decision_type长度不一致");
+        }
+
+        // 负数孩子编号表示叶子 ~leaf
+        auto child = [&](double id) {
+            const int32_t local = static_cast<int32_t>(id);
+            return local >= 0 ? local : static_cast<int32_t>(num_nodes) + ~local;
+        };
+        std::vector<LocalNode> nodes(num_nodes + num_leaves);
+        for (size_t i = 0; i < num_nodes; ++i) {
+            const int decision = decision_type.empty() ? 0 : static_cast<int>(decision_type[i]);
+            if ((decision & 1) != 0) {
+                return fail("不支持类别型切分");
+            }
+            if (split_feature[i] < 0) {
+                return fail("LightGBM模型的特征号无效");
+            }
+            nodes[i].feature = static_cast<uint32_t>(split_feature[i]);
+            nodes[i].threshold = threshold[i];
+            nodes[i].default_left = (decision & 2) != 0;
+            nodes[i].missing_type = static_cast<uint8_t>((decision >> 2) & 3);
+            if (nodes[i].missing_type > kMissingNaN) {
+                return fail("LightGBM模型的缺失值类型无效");
+            }
+            nodes[i].left = child(left_child[i]);
+            nodes[i].right = child(right_child[i]);
+        }
+        for (size_t k = 0; k < num_leaves; ++k) {
+            nodes[num_nodes + k].leaf = true;
+            nodes[num_nodes + k].value = leaf_values[k];
+        }
+        return appendTree(nodes);
+    };
+
+    while (std::getline(input, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (startsWith(line, "num_class=") && std::atol(line.c_str() + 10) != 1) {
+            return fail("只支持单输出模型（num_class=1）");
+        }
+        if (startsWith(line, "Tree=") || line == "end of trees") {
+            if (in_tree && !finishTree()) {
+                return false;
+            }
+            fields.clear();
+            in_tree = line != "end of trees";
+            if (!in_tree) {
+                break;
+            }
+            continue;
+        }
+        if (in_tree) {
+            size_t eq = line.find('=');
+            if (eq != std::string::npos) {
+                fields[line.substr(0, eq)] = line.substr(eq + 1);
+            }
+        }
+    }
+    if (in_tree && !finishTree()) {
+        return false;
+    }
+    if (roots_.empty()) {
+        return fail("模型中没有树");
+    }
+    return true;
+}
+
+bool TreeEnsemble::parseXgboost(const std::string& text) {
+    struct RawNode {
+        bool leaf = false;
+        uint32_t feature = 0;
+        double threshold = 0.0;
+        int yes = -1;
+        int no = -1;
+        int missing = -1;
+        double value = 0.0;
+    };
+
+    std::istringstream input(text);
+    std::string line;
+    std::map<int, RawNode> raw;
+    bool in_tree = false;
+
+    // 按节点编号升序转换成局部节点（dump中的孩子编号总是大于父节点）
+    auto finishTree = [&]() {
+        if (raw.count(0) == 0) {
+            return fail("XGBoost dump中的树缺少根节点");
+        }
+        std::unordered_map<int, int32_t> local;
+        for (const auto& [id, node] : raw) {
+            local.emplace(id, static_cast<int32_t>(local.size()));
+        }
+        std::vector<LocalNode> nodes;
+        for (const auto& [id, node] : raw) {
+            LocalNode converted;
+            converted.leaf = node.leaf;
+            converted.value = node.value;
+            if (!node.leaf) {
+                auto yes = local.find(node.yes);
+                auto no = local.find(node.no);
+                if (yes == local.end() || no == local.end()) {
+                    return fail("XGBoost dump中的孩子节点不存在");
+                }
+                // value < threshold 等价于 value <= threshold的前一个可表示值
+                converted.feature = node.feature;
+                converted.threshold = std::nextafter(node.threshold, -std::numeric_limits<double>::infinity());
+                converted.default_left = node.missing == node.yes;
+                converted.left = yes->second;
+                converted.right = no->second;
+            }
+            nodes.push_back(converted);
+        }
+        raw.clear();
+        return appendTree(nodes);
+    };
+
+    while (std::getline(input, line)) {
+        size_t begin = line.find_first_not_of(" \t");
+        if (begin == std::string::npos) {
+            continue;
+        }
+        std::string content = line.substr(begin);
+        if (startsWith(content, "booster[")) {
+            if (in_tree && !finishTree()) {
+                return false;
+            }
+            in_tree = true;
+            continue;
+        }
+        if (!in_tree) {
+            continue;
+        }
+
+        // 节点行: "3:[f2<0.5] yes=5,no=6,missing=5" 或 "4:leaf=0.125"
+        char* end = nullptr;
+        const int id = static_cast<int>(std::strtol(content.c_str(), &end, 10));
+        if (end == content.c_str() || *end != ':') {
+            return fail("无法解析XGBoost节点: " + content);
+        }
+        RawNode node;
+        std::string body(end + 1);
+        if (startsWith(body, "leaf=")) {
+            node.leaf = true;
+            node.value = std::strtod(body.c_str() + 5, nullptr);
+        } else {
+            size_t less = body.find('<');
+            size_t close = body.find(']');
+            if (body.size() < 3 || body[0] != '[' || body[1] != 'f' || less == std::string::npos ||
+                close == std::string::npos || less > close) {
+                return fail("只支持形如[f<特征号><阈值]的数值切分: " + content);
+            }
+            node.feature = static_cast<uint32_t>(std::strtoul(body.c_str() + 2, nullptr, 10));
+            node.threshold = std::strtod(body.c_str() + less + 1, nullptr);
+            auto read = [&body](const std::string& key) {
+                size_t pos = body.find(key + "=");
+                return pos == std::string::npos ? -1 : std::atoi(body.c_str() + pos + key.size() + 1);
+            };
+            node.yes = read("yes");
+            node.no = read("no");
+            node.missing = read("missing");
+        }
+        raw[id] = node;
+    }
+    if (in_tree && !finishTree()) {
+        return false;
+    }
+    if (roots_.empty()) {
+        return fail("模型中没有树");
+    }
+    return true;
+}
+
+void TreeEnsemble::buildQuickScorer() {
+    struct Condition {
+        uint32_t feature;
+        double threshold;
+        uint32_t tree;
+        uint64_t mask;
+        uint8_t default_left;
+        uint8_t missing_type;
+    };
+    std::vector<Condition> conditions;
+
+    for (size_t t = 0; t < roots_.size(); ++t) {
+        // 中序遍历给叶子从左到右编号，同时得到每个内部节点左子树的叶子区间
+        std::vector<std::pair<int32_t, bool>> stack{{roots_[t], false}};
+        std::vector<int32_t> leaves;
+        std::vector<std::pair<int32_t, size_t>> internal;   // (节点, 左子树第一个叶子的编号)
+        std::vector<size_t> left_end;
+        std::unordered_map<int32_t, size_t> left_begin;
+        while (!stack.empty()) {
+            auto [n, visited] = stack.back();
+            stack.pop_back();
+            if (left_[n] == n) {
+                leaves.push_back(n);
+            } else if (!visited) {
+                left_begin[n] = leaves.size();
+                stack.push_back({right_[n], false});
+                stack.push_back({n, true});
+                stack.push_back({left_[n], false});
+            } else {
+                // 左子树已遍历完：[left_begin, leaves.size()) 是左子树的叶子
+                internal.emplace_back(n, left_begin[n]);
+                left_end.push_back(leaves.size());
+            }
+        }
+        if (leaves.size() > 64) {
+            large_trees_.push_back(t);
+            continue;
+        }
+
+        const uint32_t qs_tree = static_cast<uint32_t>(qs_leaf_offsets_.size());
+        qs_leaf_offsets_.push_back(qs_leaf_values_.size());
+        for (int32_t leaf : leaves) {
+            qs_leaf_values_.push_back(values_[leaf]);
+        }
+        for (size_t i = 0; i < internal.size(); ++i) {
+            const auto [n, begin] = internal[i];
+            const size_t count = left_end[i] - begin;
+            const uint64_t bits = count == 64 ? ~uint64_t(0) : ((uint64_t(1) << count) - 1) << begin;
+            conditions.push_back(
+                {features_[n], thresholds_[n], qs_tree, ~bits, default_left_[n], missing_types_[n]});
+        }
+    }
+
+    // 按(树块, 特征, 阈值)排序：条件数组按树块分段，段内按特征分组
+    std::sort(conditions.begin(), conditions.end(), [](const Condition& a, const Condition& b) {
+        if (a.tree / kTreeBlock != b.tree / kTreeBlock) {
+            return a.tree / kTreeBlock < b.tree / kTreeBlock;
+        }
+        return a.feature != b.feature ? a.feature < b.feature : a.threshold < b.threshold;
+    });
+    const size_t num_tree_blocks = (qs_leaf_offsets_.size() + kTreeBlock - 1) / kTreeBlock;
+    qs_offsets_.assign(num_tree_blocks * (num_features_ + 1), 0);
+    qs_zero_missing_.assign(num_features_, 0);
+    for (const auto& condition : conditions) {
+        qs_offsets_[condition.tree / kTreeBlock * (num_features_ + 1) + condition.feature + 1]++;
+        qs_thresholds_.push_back(condition.threshold);
+        qs_trees_.push_back(condition.tree % kTreeBlock);
+        qs_masks_.push_back(condition.mask);
+        qs_default_left_.push_back(condition.default_left);
+        qs_missing_types_.push_back(condition.missing_type);
+        if (condition.missing_type == kMissingZero) {
+            qs_zero_missing_[condition.feature] = 1;
+        }
+    }
+    // 整体前缀和：每个树块第一个特征的起点即上一个树块的终点
+    for (size_t k = 1; k < qs_offsets_.size(); ++k) {
+        qs_offsets_[k] += qs_offsets_[k - 1];
+    }
+}
+
+double TreeEnsemble::traverse(int32_t n, const FeatureMatrix& features, size_t row) const {
+    while (left_[n] != n) {
+        const double value = features.column(features_[n])[row];
+        n = goLeft(value, thresholds_[n], default_left_[n], missing_types_[n]) ? left_[n] : right_[n];
+    }
+    return values_[n];
+}
+
+bool TreeEnsemble::predict(const FeatureMatrix& features, std::vector<double>& scores) const {
+    const size_t rows = features.rows();
+    if (features.features() < num_features_) {
+        scores.clear();
+        return false;
+    }
+    scores.assign(rows, base_score_);
+
+    // 每次评估kBlock个文档 × kTreeBlock棵树：masks[tree * kBlock + d]为第d个文档在块内第tree棵树上
+    // 仍可能到达的叶子，整块掩码留在L1中
+    thread_local std::vector<double> values;        // values[f * kBlock + d]，缺失值记为-inf
+    thread_local std::vector<double> block_max;     // 每个特征在块内（非缺失值）的最大值
+    thread_local std::vector<uint32_t> missing;     // 每个特征在块内取缺失值的文档位图
+    alignas(16) uint64_t masks[kTreeBlock * kBlock];
+    values.resize(num_features_ * kBlock);
+    block_max.resize(num_features_);
+    missing.resize(num_features_);
+
+    const size_t num_trees = qs_leaf_offsets_.size();
+    const double lowest = -std::numeric_limits<double>::infinity();
+    for (size_t base = 0; base < rows; base += kBlock) {
+        const size_t count = std::min(kBlock, rows - base);
+
+        // 1. 取出块内特征值；缺失值（NaN，或该特征有Zero类型节点时的0）之后逐个节点按缺失值类型判断，
+        //    在阈值比较中记为-inf（任何节点条件都为真）
+        for (size_t f = 0; f < num_features_; ++f) {
+            const double* column = features.column(f) + base;
+            double* block = values.data() + f * kBlock;
+            block_max[f] = lowest;
+            missing[f] = 0;
+            for (size_t d = 0; d < kBlock; ++d) {
+                double value = d < count ? column[d] : lowest;
+                if (d < count && (std::isnan(value) || (qs_zero_missing_[f] && std::fabs(value) <= kZeroThreshold))) {
+                    missing[f] |= uint32_t(1) << d;
+                    value = lowest;
+                }
+                block[d] = value;
+                block_max[f] = std::max(block_max[f], value);
+            }
+        }
+
+        // 2. 逐个树块更新掩码并累加叶子值
+        for (size_t first_tree = 0; first_tree < num_trees; first_tree += kTreeBlock) {
+            const size_t trees = std::min(kTreeBlock, num_trees - first_tree);
+            const size_t* offsets = qs_offsets_.data() + first_tree / kTreeBlock * (num_features_ + 1);
+            std::fill(masks, masks + trees * kBlock, ~uint64_t(0));
+            for (size_t f = 0; f < num_features_; ++f) {
+                const size_t begin = offsets[f];
+                const size_t end = offsets[f + 1];
+                for (uint32_t rest = missing[f]; rest != 0; rest &= rest - 1) {
+                    const size_t d = static_cast<size_t>(__builtin_ctz(rest));
+                    const double value = features.column(f)[base + d];
+                    for (size_t i = begin; i < end; ++i) {
+                        if (!goLeft(value, qs_thresholds_[i], qs_default_left_[i], qs_missing_types_[i])) {
+                            masks[qs_trees_[i] * kBlock + d] &= qs_masks_[i];
+                        }
+                    }
+                }
+                // 阈值升序：阈值不小于块内最大值之后的节点对块内所有文档都为真
+                const double* block = values.data() + f * kBlock;
+                for (size_t i = begin; i < end && qs_thresholds_[i] < block_max[f]; ++i) {
+                    clearLeaves(block, qs_thresholds_[i], qs_masks_[i], masks + qs_trees_[i] * kBlock);
+                }
+            }
+            for (size_t t = 0; t < trees; ++t) {
+                const double* leaf_values = qs_leaf_values_.data() + qs_leaf_offsets_[first_tree + t];
+                const uint64_t* tree_masks = masks + t * kBlock;
+                for (size_t d = 0; d < count; ++d) {
+                    scores[base + d] += leaf_values[__builtin_ctzll(tree_masks[d])];
+                }
+            }
+        }
+        for (size_t d = 0; d < count; ++d) {
+            for (size_t t : large_trees_) {
+                scores[base + d] += traverse(roots_[t], features, base + d);
+            }
+        }
+    }
+    return true;
+}
+
+double TreeEnsemble::predictOne(const double* row) const {
+    // 逐棵树从根走到叶子
+    double score = base_score_;
+    for (int32_t n : roots_) {
+        while (left_[n] != n) {
+            const double value = row[features_[n]];
+            n = goLeft(value, thresholds_[n], default_left_[n], missing_types_[n]) ? left_[n] : right_[n];
+        }
+        score += values_[n];
+    }
+    return score;
+}
+
+} // namespace search_engine
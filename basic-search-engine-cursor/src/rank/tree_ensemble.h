@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace search_engine {
+
+/**
+ * @brief 列式特征矩阵
+ *
+ * 按特征存储：column(f)[i] 是第i个候选文档的第f个特征，
+ * 同一特征的值连续存放，特征提取和树评估都按列批量访问
+ */
+class FeatureMatrix {
+public:
+    FeatureMatrix() = default;
+    FeatureMatrix(size_t num_rows, size_t num_features) { reset(num_rows, num_features); }
+
+    /**
+     * @brief 重置大小并把所有值清零
+     */
+    void reset(size_t num_rows, size_t num_features) {
+        num_rows_ = num_rows;
+        num_features_ = num_features;
+        values_.assign(num_rows * num_features, 0.0);
+    }
+
+    size_t rows() const { return num_rows_; }
+    size_t features() const { return num_features_; }
+
+    double* column(size_t feature) { return values_.data() + feature * num_rows_; }
+    const double* column(size_t feature) const { return values_.data() + feature * num_rows_; }
+
+    double get(size_t row, size_t feature) const { return values_[feature * num_rows_ + row]; }
+    void set(size_t row, size_t feature, double value) { values_[feature * num_rows_ + row] = value; }
+
+private:
+    size_t num_rows_ = 0;
+    size_t num_features_ = 0;
+    std::vector<double> values_;
+};
+
+/**
+ * @brief 梯度提升树模型（只做推理）
+ *
+ * 支持两种文本格式：
+ * - LightGBM `save_model` 输出的文本模型（Tree=...段，只支持数值型切分）
+ * - XGBoost `dump_model` 输出的文本（booster[i]: 段，特征名为f0、f1...）
+ * 模型得分为所有树叶子值之和加上base_score
+ *
+ * 设计思路：
+ * - 所有树的节点（含叶子）打平存放在连续数组里（特征号/阈值/左右孩子/叶子值各一个数组），
+ *   同一棵树的节点相邻，不使用指针；叶子的左右孩子指向自己
+ * - XGBoost的 "value < threshold" 统一转换成 "value <= threshold'"，评估时只有一种比较
+ * - 缺失值按节点的缺失值类型处理（与LightGBM一致）：
+ *   None：NaN当作0.0比较；Zero：0（及NaN）走缺省方向；NaN：NaN走缺省方向。
+ *   XGBoost的切分都是NaN类型
+ * - 批量评估使用QuickScorer：叶子数不超过64的树，每棵树用一个64位掩码表示仍可能到达的叶子
+ *   （按中序从左到右编号）。所有节点按特征分组、组内按阈值升序排列，评估一个文档时
+ *   对每个特征顺序扫描阈值小于特征值的节点（即条件为假、要走右边的节点），
+ *   把其左子树的叶子从掩码中清掉；最终每棵树掩码的最低位就是到达的叶子。
+ *   扫描是连续内存上的独立操作，没有逐层的指针追踪和分支预测失败
+ * - 按块评估（BlockWise-QS）：文档每32个一块，树每32棵一块（条件数组按树块分段），
+ *   一块的掩码只有8KB、留在L1中；对每个特征只扫描一遍节点条件（到阈值不小于块内最大值为止），
+ *   每个条件用SSE2同时比较两个文档并无分支地更新它们的掩码，节点数组每个文档块读一遍
+ * - 叶子超过64个的树退化为逐层遍历打平数组
+ */
+class TreeEnsemble {
+public:
+    /**
+     * @brief 从文件加载模型（按内容自动识别LightGBM/XGBoost格式）
+     * @return 是否成功（失败原因见lastError()）
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief 从文本加载模型
+     */
+    bool loadFromString(const std::string& text);
+
+    /**
+     * @brief 批量评估（QuickScorer）
+     * @param features 特征矩阵（列数不少于getFeatureCount()）
+     * @param scores 输出每行的得分
+     * @return 特征矩阵的列数少于模型用到的特征数时返回false（scores被清空）
+     */
+    bool predict(const FeatureMatrix& features, std::vector<double>& scores) const;
+
+    /**
+     * @brief 评估单个文档（逐棵树遍历，供对照测试使用）
+     * @param row 按特征号排列的特征值
+     */
+    double predictOne(const double* row) const;
+
+    /**
+     * @brief 设置常数偏置（XGBoost的base_score不在dump文本中）
+     */
+    void setBaseScore(double base_score) { base_score_ = base_score; }
+
+    size_t getTreeCount() const { return roots_.size(); }
+    size_t getNodeCount() const { return features_.size() - leaf_count_; }
+    size_t getLeafCount() const { return leaf_count_; }
+
+    /**
+     * @brief 模型用到的特征数（最大特征号 + 1）
+     */
+    size_t getFeatureCount() const { return num_features_; }
+
+    const std::string& lastError() const { return error_; }
+
+    void clear();
+
+private:
+    /**
+     * @brief 节点的缺失值类型（LightGBM decision_type的第2~3位）
+     */
+    enum MissingType : uint8_t {
+        kMissingNone = 0,
+        kMissingZero = 1,
+        kMissingNaN = 2,
+    };
+
+    /**
+     * @brief 解析阶段的单棵树节点（局部编号，孩子编号必须大于父节点）
+     */
+    struct LocalNode {
+        bool leaf = false;
+        uint32_t feature = 0;
+        double threshold = 0.0;
+        bool default_left = false;
+        uint8_t missing_type = kMissingNaN;
+        int32_t left = -1;
+        int32_t right = -1;
+        double value = 0.0;
+    };
+
+    bool parseLightGbm(const std::string& text);
+    bool parseXgboost(const std::string& text);
+    bool appendTree(const std::vector<LocalNode>& nodes);
+    void buildQuickScorer();
+    double traverse(int32_t node, const FeatureMatrix& features, size_t row) const;
+    bool fail(const std::string& message);
+
+    // 打平后的节点（下标为全局节点号，叶子的左右孩子指向自己）
+    std::vector<uint32_t> features_;
+    std::vector<double> thresholds_;
+    std::vector<int32_t> left_;
+    std::vector<int32_t> right_;
+    std::vector<uint8_t> default_left_;
+    std::vector<uint8_t> missing_types_;
+    std::vector<double> values_;      // 叶子值（内部节点为0）
+
+    std::vector<int32_t> roots_;      // 每棵树的根节点
+
+    // QuickScorer结构：按特征分组、组内按阈值升序的节点条件
+    std::vector<size_t> qs_offsets_;        // 树块b中特征f的条件位于[qs_offsets_[k], qs_offsets_[k+1])，k = b*(特征数+1)+f
+    std::vector<double> qs_thresholds_;
+    std::vector<uint32_t> qs_trees_;        // 条件所属的树（在树块内的编号）
+    std::vector<uint64_t> qs_masks_;        // 条件为假时保留的叶子（左子树的叶子位为0）
+    std::vector<uint8_t> qs_default_left_;
+    std::vector<uint8_t> qs_missing_types_;
+    std::vector<uint8_t> qs_zero_missing_;  // 特征f是否有Zero类型的节点（有时0值不能按阈值比较）
+    std::vector<size_t> qs_leaf_offsets_;   // 每棵树的叶子值（中序）在qs_leaf_values_中的起点
+    std::vector<double> qs_leaf_values_;
+    std::vector<size_t> large_trees_;       // 叶子超过64个、逐层遍历的树
+
+    size_t leaf_count_ = 0;
+    size_t num_features_ = 0;
+    double base_score_ = 0.0;
+    std::string error_;
+};
+
+} // namespace search_engine
@@ -0,0 +1,21 @@
+#include "server/index_snapshot.h"
+
+namespace search_engine {
+
+IndexSnapshot::IndexSnapshot(std::unique_ptr<IndexBuilder> builder, uint64_t version)
+    : builder_(std::move(builder)), version_(version) {
+    engine_.setInvertedIndex(&builder_->getInvertedIndex());
+    engine_.setForwardIndex(&builder_->getForwardIndex());
+    engine_.setDocValues(&builder_->getDocValues());
+    // 协议只返回文档ID和分数，不生成摘要
+    engine_.setSnippetEnabled(false);
+}
+
+IndexStats IndexSnapshot::collectStats() const {
+    IndexStats stats = builder_->collectStats();
+    const FilterCache& filter_cache = engine_.getFilterCache();
+    stats.caches.push_back({"filter_cache", filter_cache.size(), filter_cache.bytes()});
+    return stats;
+}
+
+} // namespace search_engine
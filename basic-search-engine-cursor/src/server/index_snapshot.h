@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "storage/index_builder.h"
+#include "query/search_engine.h"
+
+namespace search_engine {
+
+/**
+ * @brief 只读索引快照
+ *
+ * 持有一份构建完成的索引（IndexBuilder）和指向它的SearchEngine，发布后不再修改，
+ * 可被任意多个查询线程同时使用
+ */
+class IndexSnapshot {
+public:
+    /**
+     * @param builder 构建完成的索引（快照持有所有权）
+     * @param version 快照版本号（随响应返回给客户端）
+     */
+    IndexSnapshot(std::unique_ptr<IndexBuilder> builder, uint64_t version);
+
+    IndexSnapshot(const IndexSnapshot&) = delete;
+    IndexSnapshot& operator=(const IndexSnapshot&) = delete;
+
+    const SearchEngine& engine() const { return engine_; }
+    uint64_t version() const { return version_; }
+    size_t documentCount() const { return builder_->getForwardIndex().size(); }
+
+    /**
+     * @brief 内部文档ID转换为原始文档ID（文档重排序之后两者不同）
+     */
+    int64_t originalDocId(int64_t doc_id) const { return builder_->getForwardIndex().getOriginalDocId(doc_id); }
+
+    /**
+     * @brief 快照的内存统计（索引结构 + 查询缓存），可在查询进行中调用
+     */
+    IndexStats collectStats() const;
+
+private:
+    std::unique_ptr<IndexBuilder> builder_;
+    SearchEngine engine_;
+    uint64_t version_;
+};
+
+/**
+ * @brief 当前快照的持有者（在线切换索引）
+ *
+ * 查询开始时取一份shared_ptr，整个查询都使用这份快照；publish()替换当前快照后，
+ * 新查询立即使用新快照，旧快照在最后一个使用它的查询结束时释放
+ */
+class SnapshotHolder {
+public:
+    std::shared_ptr<const IndexSnapshot> current() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return snapshot_;
+    }
+
+    void publish(std::shared_ptr<const IndexSnapshot> snapshot) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            snapshot_.swap(snapshot);
+        }
+        // snapshot此时是旧快照：如果这是最后一个引用，在锁外析构
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::shared_ptr<const IndexSnapshot> snapshot_;
+};
+
+} // namespace search_engine
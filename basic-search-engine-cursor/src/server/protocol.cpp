@@ -0,0 +1,107 @@
+#include "server/protocol.h"
+#include <cstring>
+
+namespace search_engine {
+
+namespace {
+
+const size_t kRequestFixedSize = 8;     // request_id + top_k + flags
+const size_t kResponseFixedSize = 17;   // request_id + status + snapshot_version + count
+const size_t kHitSize = 16;
+
+template <typename T>
+void putBigEndian(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bytes[i] = static_cast<char>((static_cast<uint64_t>(value) >> (8 * (sizeof(T) - 1 - i))) & 0xFF);
+    }
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+T getBigEndian(const char* data) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value = (value << 8) | static_cast<uint8_t>(data[i]);
+    }
+    return static_cast<T>(value);
+}
+
+// 读出帧长并检查帧是否完整
+FrameStatus frameBody(const char* data, size_t size, size_t min_body, size_t& body_size) {
+    if (size < protocol::kFrameHeaderSize) {
+        return FrameStatus::kIncomplete;
+    }
+    body_size = getBigEndian<uint32_t>(data);
+    if (body_size < min_body || body_size > protocol::kMaxFrameSize) {
+        return FrameStatus::kMalformed;
+    }
+    return size < protocol::kFrameHeaderSize + body_size ? FrameStatus::kIncomplete : FrameStatus::kComplete;
+}
+
+} // namespace
+
+void encodeRequest(const QueryRequest& request, std::string& out) {
+    putBigEndian<uint32_t>(out, static_cast<uint32_t>(kRequestFixedSize + request.query.size()));
+    putBigEndian<uint32_t>(out, request.request_id);
+    putBigEndian<uint16_t>(out, request.top_k);
+    putBigEndian<uint16_t>(out, request.flags);
+    out += request.query;
+}
+
+void encodeResponse(const QueryResponse& response, std::string& out) {
+    putBigEndian<uint32_t>(out, static_cast<uint32_t>(kResponseFixedSize + response.hits.size() * kHitSize));
+    putBigEndian<uint32_t>(out, response.request_id);
+    out.push_back(static_cast<char>(response.status));
+    putBigEndian<uint64_t>(out, response.snapshot_version);
+    putBigEndian<uint32_t>(out, static_cast<uint32_t>(response.hits.size()));
+    for (const auto& hit : response.hits) {
+        uint64_t score_bits = 0;
+        std::memcpy(&score_bits, &hit.score, sizeof(score_bits));
+        putBigEndian<uint64_t>(out, static_cast<uint64_t>(hit.doc_id));
+        putBigEndian<uint64_t>(out, score_bits);
+    }
+}
+
+FrameStatus decodeRequest(const char* data, size_t size, QueryRequest& request, size_t& consumed) {
+    size_t body_size = 0;
+    FrameStatus status = frameBody(data, size, kRequestFixedSize, body_size);
+    if (status != FrameStatus::kComplete) {
+        return status;
+    }
+    const char* body = data + protocol::kFrameHeaderSize;
+    request.request_id = getBigEndian<uint32_t>(body);
+    request.top_k = getBigEndian<uint16_t>(body + 4);
+    request.flags = getBigEndian<uint16_t>(body + 6);
+    request.query.assign(body + kRequestFixedSize, body_size - kRequestFixedSize);
+    consumed = protocol::kFrameHeaderSize + body_size;
+    return FrameStatus::kComplete;
+}
+
+FrameStatus decodeResponse(const char* data, size_t size, QueryResponse& response, size_t& consumed) {
+    size_t body_size = 0;
+    FrameStatus status = frameBody(data, size, kResponseFixedSize, body_size);
+    if (status != FrameStatus::kComplete) {
+        return status;
+    }
+    const char* body = data + protocol::kFrameHeaderSize;
+    const uint32_t count = getBigEndian<uint32_t>(body + 13);
+    if (body_size != kResponseFixedSize + static_cast<size_t>(count) * kHitSize) {
+        return FrameStatus::kMalformed;
+    }
+    response.request_id = getBigEndian<uint32_t>(body);
+    response.status = static_cast<ResponseStatus>(static_cast<uint8_t>(body[4]));
+    response.snapshot_version = getBigEndian<uint64_t>(body + 5);
+    response.hits.resize(count);
+    const char* hit = body + kResponseFixedSize;
+    for (auto& entry : response.hits) {
+        const uint64_t score_bits = getBigEndian<uint64_t>(hit + 8);
+        entry.doc_id = static_cast<int64_t>(getBigEndian<uint64_t>(hit));
+        std::memcpy(&entry.score, &score_bits, sizeof(score_bits));
+        hit += kHitSize;
+    }
+    consumed = protocol::kFrameHeaderSize + body_size;
+    return FrameStatus::kComplete;
+}
+
+} // namespace search_engine
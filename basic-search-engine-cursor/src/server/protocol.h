@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace search_engine {
+
+/**
+ * @brief 查询协议（长度前缀的二进制帧，整数均为大端）
+ *
+ * 请求: [u32 帧长][u32 request_id][u16 top_k][u16 flags][查询串(UTF-8)]
+ * 响应: [u32 帧长][u32 request_id][u8 status][u64 snapshot_version][u32 count]
+ *       count × ([i64 doc_id][f64 score])
+ * 帧长不包含自身的4个字节
+ *
+ * 同一连接上可以连续发送多个请求而不等待响应（pipelining），
+ * 响应按完成顺序返回，客户端用request_id对应请求
+ */
+namespace protocol {
+
+const size_t kFrameHeaderSize = 4;
+const size_t kMaxFrameSize = 64 * 1024;
+
+} // namespace protocol
+
+/**
+ * @brief 响应状态
+ */
+enum class ResponseStatus : uint8_t {
+    kOk = 0,
+    kPartial = 1,       // 查询超时，结果不完整
+    kBadRequest = 2,    // top_k为0或超过上限
+    kOverloaded = 3,    // 查询队列已满，请求被拒绝
+    kUnavailable = 4    // 还没有发布索引快照
+};
+
+/**
+ * @brief 帧解析结果
+ */
+enum class FrameStatus {
+    kComplete,      // 解析出一帧
+    kIncomplete,    // 数据不足一帧，等待更多数据
+    kMalformed      // 帧长非法，连接应关闭
+};
+
+struct QueryRequest {
+    uint32_t request_id = 0;
+    uint16_t top_k = 10;
+    uint16_t flags = 0;
+    std::string query;
+};
+
+struct QueryHit {
+    int64_t doc_id = 0;
+    double score = 0.0;
+};
+
+struct QueryResponse {
+    uint32_t request_id = 0;
+    ResponseStatus status = ResponseStatus::kOk;
+    uint64_t snapshot_version = 0;
+    std::vector<QueryHit> hits;
+};
+
+/**
+ * @brief 把请求编码成一帧追加到out
+ */
+void encodeRequest(const QueryRequest& request, std::string& out);
+
+/**
+ * @brief 把响应编码成一帧追加到out
+ */
+void encodeResponse(const QueryResponse& response, std::string& out);
+
+/**
+ * @brief 从缓冲区开头解析一个请求帧
+ * @param data 缓冲区
+ * @param size 缓冲区长度
+ * @param request 输出请求
+ * @param consumed 输出该帧占用的字节数（kComplete时有效）
+ */
+FrameStatus decodeRequest(const char* data, size_t size, QueryRequest& request, size_t& consumed);
+
+/**
+ * @brief 从缓冲区开头解析一个响应帧
+ */
+FrameStatus decodeResponse(const char* data, size_t size, QueryResponse& response, size_t& consumed);
+
+} // namespace search_engine
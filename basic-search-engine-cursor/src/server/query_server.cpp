@@ -0,0 +1,423 @@
+#include "server/query_server.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace search_engine {
+
+namespace {
+
+// epoll事件中的特殊编号（连接编号从0开始递增，不会用到这两个值）
+const uint64_t kListenId = UINT64_MAX;
+const uint64_t kWakeupId = UINT64_MAX - 1;
+
+const int kMaxEvents = 64;
+const size_t kReadChunk = 16 * 1024;
+
+bool addToEpoll(int epoll_fd, int fd, uint32_t events, uint64_t id) {
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = id;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+} // namespace
+
+QueryServer::QueryServer(const SnapshotHolder& snapshots, const ServerOptions& options)
+    : snapshots_(snapshots), options_(options), jobs_(options.queue_capacity) {}
+
+QueryServer::~QueryServer() {
+    stop();
+}
+
+bool QueryServer::fail(const std::string& message) {
+    error_ = message + ": " + std::strerror(errno);
+    return false;
+}
+
+bool QueryServer::start() {
+    if (io_thread_.joinable()) {
+        error_ = "服务已启动";
+        return false;
+    }
+    if (!listen()) {
+        stop();
+        return false;
+    }
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ < 0 || wakeup_fd_ < 0 ||
+        !addToEpoll(epoll_fd_, listen_fd_, EPOLLIN | EPOLLET, kListenId) ||
+        !addToEpoll(epoll_fd_, wakeup_fd_, EPOLLIN | EPOLLET, kWakeupId)) {
+        fail("epoll初始化失败");
+        stop();
+        return false;
+    }
+
+    const size_t threads = options_.worker_threads == 0 ? 1 : options_.worker_threads;
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back(&QueryServer::workerLoop, this);
+    }
+    io_thread_ = std::thread(&QueryServer::eventLoop, this);
+    error_.clear();
+    return true;
+}
+
+bool QueryServer::listen() {
+    if (!options_.unix_path.empty()) {
+        sockaddr_un address{};
+        if (options_.unix_path.size() >= sizeof(address.sun_path)) {
+            error_ = "Unix套接字路径过长: " + options_.unix_path;
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, options_.unix_path.c_str(), options_.unix_path.size() + 1);
+        listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) {
+            return fail("创建套接字失败");
+        }
+        ::unlink(options_.unix_path.c_str());
+        if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            return fail("绑定 " + options_.unix_path + " 失败");
+        }
+    } else {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(options_.port);
+        if (inet_pton(AF_INET, options_.host.c_str(), &address.sin_addr) != 1) {
+            error_ = "无效的监听地址: " + options_.host;
+            return false;
+        }
+        listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) {
+            return fail("创建套接字失败");
+        }
+        int reuse = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            return fail("绑定 " + options_.host + ":" + std::to_string(options_.port) + " 失败");
+        }
+        socklen_t length = sizeof(address);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length);
+        port_ = ntohs(address.sin_port);
+    }
+    if (::listen(listen_fd_, SOMAXCONN) != 0) {
+        return fail("监听失败");
+    }
+    return true;
+}
+
+void QueryServer::stop() {
+    if (io_thread_.joinable()) {
+        stopping_ = true;
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t written = ::write(wakeup_fd_, &one, sizeof(one));
+        io_thread_.join();
+    }
+    // I/O线程退出后再关闭队列：查询线程执行完剩余请求后退出，它们的响应直接丢弃
+    jobs_.close();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    for (int* fd : {&listen_fd_, &epoll_fd_, &wakeup_fd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    if (!options_.unix_path.empty()) {
+        ::unlink(options_.unix_path.c_str());
+    }
+}
+
+ServerStats QueryServer::stats() const {
+    ServerStats stats;
+    stats.connections = connections_accepted_.load(std::memory_order_relaxed);
+    stats.requests = requests_.load(std::memory_order_relaxed);
+    stats.partial = partial_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    stats.malformed = malformed_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void QueryServer::eventLoop() {
+    epoll_event events[kMaxEvents];
+    while (!stopping_) {
+        int count = epoll_wait(epoll_fd_, events, kMaxEvents, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (int i = 0; i < count; ++i) {
+            const uint64_t id = events[i].data.u64;
+            if (id == kListenId) {
+                acceptConnections();
+                continue;
+            }
+            if (id == kWakeupId) {
+                uint64_t value = 0;
+                while (::read(wakeup_fd_, &value, sizeof(value)) > 0) {
+                }
+                drainCompletions();
+                continue;
+            }
+            auto it = connections_.find(id);
+            if (it == connections_.end()) {
+                continue;
+            }
+            if (events[i].events & EPOLLERR) {
+                closeConnection(id);
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+                // readConnection内部会在需要时关闭连接
+                readConnection(id, it->second);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                finishIo(id, it->second);
+            }
+        }
+    }
+
+    for (auto& [id, connection] : connections_) {
+        ::close(connection.fd);
+    }
+    connections_.clear();
+}
+
+void QueryServer::acceptConnections() {
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            // EAGAIN：已取完；其他错误（如fd耗尽）等下一次事件再试
+            return;
+        }
+        if (options_.unix_path.empty()) {
+            int nodelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+        }
+        const uint64_t id = next_connection_id_++;
+        if (!addToEpoll(epoll_fd_, fd, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, id)) {
+            ::close(fd);
+            continue;
+        }
+        connections_[id].fd = fd;
+        connections_accepted_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void QueryServer::readConnection(uint64_t id, Connection& connection) {
+    char buffer[kReadChunk];
+    bool resume = true;
+    while (resume) {
+        connection.paused = false;
+        while (true) {
+            // 先处理已缓冲的输入，达到上限后不再读取（边沿触发下恢复时需要主动调用本函数）
+            if (!processInput(id, connection)) {
+                return;
+            }
+            if (overLimit(connection)) {
+                connection.paused = true;
+                break;
+            }
+            ssize_t n = ::read(connection.fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                connection.input.append(buffer, static_cast<size_t>(n));
+                continue;
+            }
+            if (n == 0) {
+                connection.peer_closed = true;
+                break;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            closeConnection(id);
+            return;
+        }
+        if (!flushConnection(connection)) {
+            closeConnection(id);
+            return;
+        }
+        // 发送后低于上限：继续读取（可能再次暂停）
+        resume = connection.paused && !overLimit(connection);
+    }
+    if (!connection.paused && connection.peer_closed && connection.in_flight == 0 && connection.output.empty()) {
+        closeConnection(id);
+    }
+}
+
+bool QueryServer::processInput(uint64_t id, Connection& connection) {
+    // 分帧：完整的请求交给查询线程，参数错误或队列已满时直接回复
+    size_t offset = 0;
+    while (!overLimit(connection)) {
+        Job job;
+        size_t consumed = 0;
+        FrameStatus status = decodeRequest(connection.input.data() + offset, connection.input.size() - offset,
+                                           job.request, consumed);
+        if (status == FrameStatus::kIncomplete) {
+            break;
+        }
+        if (status == FrameStatus::kMalformed) {
+            malformed_.fetch_add(1, std::memory_order_relaxed);
+            closeConnection(id);
+            return false;
+        }
+        offset += consumed;
+        requests_.fetch_add(1, std::memory_order_relaxed);
+
+        QueryResponse response;
+        response.request_id = job.request.request_id;
+        if (job.request.top_k == 0 || job.request.top_k > options_.max_top_k) {
+            response.status = ResponseStatus::kBadRequest;
+        } else if (jobs_.size() >= options_.queue_capacity) {
+            // 只有I/O线程入队，检查之后队列只会变短，push不会阻塞
+            response.status = ResponseStatus::kOverloaded;
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            job.connection_id = id;
+            connection.in_flight++;
+            jobs_.push(std::move(job));
+            continue;
+        }
+        encodeResponse(response, connection.output);
+    }
+    connection.input.erase(0, offset);
+    return true;
+}
+
+bool QueryServer::overLimit(const Connection& connection) const {
+    return connection.output.size() - connection.output_offset >= options_.max_output_bytes ||
+           connection.in_flight >= options_.max_in_flight;
+}
+
+void QueryServer::finishIo(uint64_t id, Connection& connection) {
+    if (!flushConnection(connection)) {
+        closeConnection(id);
+        return;
+    }
+    if (connection.paused && !overLimit(connection)) {
+        // 响应已发出或已返回，恢复读取
+        readConnection(id, connection);
+        return;
+    }
+    if (!connection.paused && connection.peer_closed && connection.in_flight == 0 && connection.output.empty()) {
+        closeConnection(id);
+    }
+}
+
+bool QueryServer::flushConnection(Connection& connection) {
+    while (connection.output_offset < connection.output.size()) {
+        ssize_t n = ::send(connection.fd, connection.output.data() + connection.output_offset,
+                           connection.output.size() - connection.output_offset, MSG_NOSIGNAL);
+        if (n > 0) {
+            connection.output_offset += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // 发送缓冲区满：等待EPOLLOUT
+            return true;
+        }
+        return false;
+    }
+    connection.output.clear();
+    connection.output_offset = 0;
+    return true;
+}
+
+void QueryServer::drainCompletions() {
+    std::vector<Completion> completions;
+    {
+        std::lock_guard<std::mutex> lock(completion_mutex_);
+        completions.swap(completions_);
+    }
+    // 先把响应都追加到各自的发送缓冲区，再逐个连接发送，减少小包
+    std::vector<uint64_t> touched;
+    for (auto& completion : completions) {
+        auto it = connections_.find(completion.connection_id);
+        if (it == connections_.end()) {
+            continue;
+        }
+        it->second.output += completion.frame;
+        it->second.in_flight--;
+        touched.push_back(completion.connection_id);
+    }
+    for (uint64_t id : touched) {
+        auto it = connections_.find(id);
+        if (it == connections_.end()) {
+            continue;
+        }
+        finishIo(id, it->second);
+    }
+}
+
+void QueryServer::closeConnection(uint64_t id) {
+    auto it = connections_.find(id);
+    if (it == connections_.end()) {
+        return;
+    }
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    ::close(it->second.fd);
+    connections_.erase(it);
+}
+
+void QueryServer::workerLoop() {
+    Job job;
+    while (jobs_.pop(job)) {
+        QueryResponse response;
+        response.request_id = job.request.request_id;
+        std::shared_ptr<const IndexSnapshot> snapshot = snapshots_.current();
+        if (!snapshot) {
+            response.status = ResponseStatus::kUnavailable;
+        } else {
+            QueryContext context(options_.query_timeout);
+            auto results = snapshot->engine().search(job.request.query, job.request.top_k, context);
+            if (context.timedOut()) {
+                response.status = ResponseStatus::kPartial;
+                partial_.fetch_add(1, std::memory_order_relaxed);
+            }
+            response.snapshot_version = snapshot->version();
+            response.hits.reserve(results.size());
+            for (const auto& result : results) {
+                response.hits.push_back({snapshot->originalDocId(result.doc_id), result.score});
+            }
+        }
+
+        Completion completion;
+        completion.connection_id = job.connection_id;
+        encodeResponse(response, completion.frame);
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lock(completion_mutex_);
+            wake = completions_.empty();
+            completions_.push_back(std::move(completion));
+        }
+        // 列表由空变非空时才需要唤醒：否则I/O线程还没取走上一批，会一起处理
+        if (wake) {
+            uint64_t one = 1;
+            [[maybe_unused]] ssize_t written = ::write(wakeup_fd_, &one, sizeof(one));
+        }
+    }
+}
+
+} // namespace search_engine
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "common/bounded_queue.h"
+#include "server/index_snapshot.h"
+#include "server/protocol.h"
+
+namespace search_engine {
+
+/**
+ * @brief 查询服务配置
+ */
+struct ServerOptions {
+    std::string host = "127.0.0.1";     // TCP监听地址
+    uint16_t port = 0;                  // TCP端口（0表示由系统分配，见QueryServer::port()）
+    std::string unix_path;              // 非空时改为监听Unix域套接字
+    size_t worker_threads = 4;          // 查询线程数
+    size_t queue_capacity = 4096;       // 等待执行的查询上限，超过时直接返回kOverloaded
+    std::chrono::milliseconds query_timeout{100};   // 单个查询的截止时间，超时返回部分结果
+    uint16_t max_top_k = 1000;
+    // 单个连接的上限：待发送的响应字节数或在途请求数达到上限时暂停读取该连接，
+    // 响应发出后恢复（客户端只发不收时服务端内存有界）
+    size_t max_output_bytes = 1 << 20;
+    size_t max_in_flight = 256;
+};
+
+/**
+ * @brief 查询服务统计
+ */
+struct ServerStats {
+    uint64_t connections = 0;       // 累计接受的连接数
+    uint64_t requests = 0;          // 累计收到的请求数
+    uint64_t partial = 0;           // 超时返回部分结果的请求数
+    uint64_t rejected = 0;          // 因队列满被拒绝的请求数
+    uint64_t malformed = 0;         // 因帧格式错误被关闭的连接数
+};
+
+/**
+ * @brief 查询服务（epoll事件循环 + 查询线程池）
+ *
+ * 协议见protocol.h。设计思路：
+ * - 一个I/O线程运行边沿触发（EPOLLET）的epoll循环：监听套接字、所有连接和一个eventfd。
+ *   套接字都是非阻塞的，每次事件都读/写到EAGAIN为止
+ * - 连接处理与查询执行分离：I/O线程只负责收发和分帧，解析出的请求放入有界队列，
+ *   由查询线程执行；队列满时I/O线程直接回复kOverloaded，不会阻塞
+ * - 查询线程把编码好的响应放入完成列表并写eventfd唤醒I/O线程，由I/O线程追加到连接的发送缓冲区。
+ *   同一连接的多个请求可以同时在途，响应按完成顺序返回（pipelining）
+ * - 完成的响应按连接编号（不复用）投递，连接在查询执行期间关闭时响应直接丢弃
+ * - 连接级反压：待发送字节数或在途请求数超过上限时停止读取和分帧（数据留在内核缓冲区，
+ *   由TCP流控限制客户端），发送缓冲区清空或响应返回后继续处理
+ * - 每个查询开始时从SnapshotHolder取当前快照，发布新快照不影响正在执行的查询
+ */
+class QueryServer {
+public:
+    QueryServer(const SnapshotHolder& snapshots, const ServerOptions& options = ServerOptions());
+    ~QueryServer();
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    /**
+     * @brief 监听并启动I/O线程和查询线程
+     * @return 是否成功（失败原因见lastError()）
+     */
+    bool start();
+
+    /**
+     * @brief 停止服务：关闭所有连接，等待线程退出（可重复调用）
+     */
+    void stop();
+
+    /**
+     * @brief 实际监听的TCP端口
+     */
+    uint16_t port() const { return port_; }
+
+    ServerStats stats() const;
+
+    const std::string& lastError() const { return error_; }
+
+private:
+    struct Connection {
+        int fd = -1;
+        std::string input;          // 未解析完的输入
+        std::string output;         // 待发送的响应
+        size_t output_offset = 0;
+        size_t in_flight = 0;       // 已提交给查询线程、尚未返回的请求数
+        bool peer_closed = false;
+        bool paused = false;        // 达到上限而停止读取，套接字中可能还有未读数据
+    };
+
+    struct Job {
+        uint64_t connection_id = 0;
+        QueryRequest request;
+    };
+
+    struct Completion {
+        uint64_t connection_id = 0;
+        std::string frame;
+    };
+
+    bool listen();
+    void eventLoop();
+    void workerLoop();
+    void acceptConnections();
+    void readConnection(uint64_t id, Connection& connection);
+    bool processInput(uint64_t id, Connection& connection);
+    bool overLimit(const Connection& connection) const;
+    // 发送缓冲区中的响应；暂停的连接低于上限后恢复读取，对端已关闭且无待处理请求时关闭连接
+    void finishIo(uint64_t id, Connection& connection);
+    bool flushConnection(Connection& connection);
+    void drainCompletions();
+    void closeConnection(uint64_t id);
+    bool fail(const std::string& message);
+
+    const SnapshotHolder& snapshots_;
+    ServerOptions options_;
+    uint16_t port_ = 0;
+    std::string error_;
+
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int wakeup_fd_ = -1;
+    std::atomic<bool> stopping_{false};
+    std::thread io_thread_;
+    std::vector<std::thread> workers_;
+
+    // 只由I/O线程访问
+    std::unordered_map<uint64_t, Connection> connections_;
+    uint64_t next_connection_id_ = 0;
+
+    BoundedQueue<Job> jobs_;
+    std::mutex completion_mutex_;
+    std::vector<Completion> completions_;
+
+    std::atomic<uint64_t> connections_accepted_{0};
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> partial_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> malformed_{0};
+};
+
+} // namespace search_engine
@@ -0,0 +1,161 @@
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "storage/index_builder.h"
+#include "storage/bulk_loader.h"
+#include "server/index_snapshot.h"
+#include "server/query_server.h"
+
+using namespace search_engine;
+
+namespace {
+
+/**
+ * @brief 构建一份索引快照：有语料文件时批量导入，否则使用内置的示例文档
+ */
+std::shared_ptr<const IndexSnapshot> buildSnapshot(const std::string& path, const std::string& format,
+                                                   uint64_t version) {
+    auto builder = std::make_unique<IndexBuilder>();
+    if (path.empty()) {
+        builder->addDocument(Document(1, "政采云 技术 团队 欢迎 你"));
+        builder->addDocument(Document(2, "原创 干货 技术 氛围 很好"));
+        builder->addDocument(Document(3, "搜索引擎 技术 实现 倒排索引"));
+        builder->addDocument(Document(4, "C++ 编程 语言 高性能"));
+        builder->addDocument(Document(5, "腾讯 WXG 搜索 团队 图片搜一搜"));
+        builder->addDocument(Document(6, "AI 大模型 生成式 搜索"));
+        builder->addDocument(Document(7, "向量检索 倒排索引 混合搜索"));
+        builder->addDocument(Document(8, "技术 分享 学习 成长"));
+    } else {
+        BulkLoadOptions options;
+        options.format = (format == "tsv") ? CorpusFormat::kTsv : CorpusFormat::kJsonLines;
+        BulkLoader loader(*builder);
+        if (!loader.load(path, options)) {
+            std::cerr << "语料加载失败: " << loader.lastError() << std::endl;
+            return nullptr;
+        }
+    }
+    return std::make_shared<IndexSnapshot>(std::move(builder), version);
+}
+
+/**
+ * @brief 输出当前快照的内存统计JSON（path为空时输出到标准输出）
+ */
+void dumpStats(const SnapshotHolder& snapshots, const std::string& path) {
+    auto snapshot = snapshots.current();
+    if (!snapshot) {
+        return;
+    }
+    const std::string json = snapshot->collectStats().toJson();
+    if (path.empty()) {
+        std::cout << json << std::flush;
+        return;
+    }
+    std::ofstream file(path);
+    file << json;
+    if (!file) {
+        std::cerr << "写入内存统计失败: " << path << std::endl;
+        return;
+    }
+    std::cout << "快照 v" << snapshot->version() << " 的内存统计已写入 " << path << std::endl;
+}
+
+} // namespace
+
+/**
+ * @brief 查询服务
+ *
+ * 用法: search_server [语料文件] [jsonl|tsv] [--port N] [--host ADDR] [--unix PATH]
+ *                     [--threads N] [--timeout-ms N] [--stats-json PATH]
+ * 协议见server/protocol.h；收到SIGHUP时重新导入语料并切换快照，SIGUSR1时输出当前快照的
+ * 内存统计JSON（写入--stats-json指定的文件，未指定时输出到标准输出），SIGINT/SIGTERM退出
+ */
+int main(int argc, char* argv[]) {
+    ServerOptions options;
+    options.port = 9527;
+    std::string stats_path;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--port" && has_value) {
+            options.port = static_cast<uint16_t>(std::stoul(argv[++i]));
+        } else if (arg == "--host" && has_value) {
+            options.host = argv[++i];
+        } else if (arg == "--unix" && has_value) {
+            options.unix_path = argv[++i];
+        } else if (arg == "--threads" && has_value) {
+            options.worker_threads = std::stoul(argv[++i]);
+        } else if (arg == "--timeout-ms" && has_value) {
+            options.query_timeout = std::chrono::milliseconds(std::stoul(argv[++i]));
+        } else if (arg == "--stats-json" && has_value) {
+            stats_path = argv[++i];
+        } else {
+            args.push_back(arg);
+        }
+    }
+    const std::string corpus = args.empty() ? "" : args[0];
+    const std::string format = args.size() > 1 ? args[1] : "jsonl";
+
+    // 信号在所有线程中屏蔽，由主线程sigwait同步处理
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    sigaddset(&signals, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    uint64_t version = 1;
+    SnapshotHolder snapshots;
+    auto snapshot = buildSnapshot(corpus, format, version);
+    if (!snapshot) {
+        return 1;
+    }
+    snapshots.publish(snapshot);
+    std::cout << "索引快照 v" << version << ": " << snapshot->documentCount() << " 篇文档" << std::endl;
+    snapshot.reset();
+
+    QueryServer server(snapshots, options);
+    if (!server.start()) {
+        std::cerr << "服务启动失败: " << server.lastError() << std::endl;
+        return 1;
+    }
+    if (options.unix_path.empty()) {
+        std::cout << "监听 " << options.host << ":" << server.port();
+    } else {
+        std::cout << "监听 " << options.unix_path;
+    }
+    std::cout << "，查询线程 " << options.worker_threads << " 个" << std::endl;
+
+    while (true) {
+        int signal = 0;
+        if (sigwait(&signals, &signal) != 0) {
+            continue;
+        }
+        if (signal == SIGUSR1) {
+            dumpStats(snapshots, stats_path);
+            continue;
+        }
+        if (signal != SIGHUP) {
+            break;
+        }
+        // 重新构建期间旧快照继续服务
+        auto fresh = buildSnapshot(corpus, format, version + 1);
+        if (!fresh) {
+            std::cerr << "重新加载失败，继续使用快照 v" << version << std::endl;
+            continue;
+        }
+        version++;
+        std::cout << "切换到索引快照 v" << version << ": " << fresh->documentCount() << " 篇文档" << std::endl;
+        snapshots.publish(std::move(fresh));
+    }
+
+    server.stop();
+    const ServerStats stats = server.stats();
+    std::cout << "服务已停止: 连接 " << stats.connections << " | 请求 " << stats.requests << " | 部分结果 "
+              << stats.partial << " | 拒绝 " << stats.rejected << std::endl;
+    return 0;
+}
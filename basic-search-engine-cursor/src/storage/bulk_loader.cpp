@@ -0,0 +1,464 @@
+#include "storage/bulk_loader.h"
+#include "common/bounded_queue.h"
+#include "common/line_scanner.h"
+#include "common/mapped_file.h"
+#include "common/utils.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace search_engine {
+
+namespace {
+
+// 读取阶段产出的原始批次：mmap区域上的一段完整行
+struct RawBatch {
+    uint64_t seq = 0;
+    size_t begin = 0;           // 在文件中的偏移
+    size_t end = 0;
+};
+
+struct ParsedDoc {
+    Document doc;
+    bool has_id = false;   // 为false时在写索引阶段按顺序自动分配ID
+    std::vector<std::pair<std::string, int32_t>> term_freqs;
+};
+
+// 解析阶段产出的批次
+struct ParsedBatch {
+    uint64_t seq = 0;
+    size_t end = 0;
+    uint64_t records = 0;
+    uint64_t malformed = 0;
+    std::vector<ParsedDoc> docs;
+};
+
+// ---------- 最小JSON解析（只处理单层对象中的字符串/整数字段） ----------
+
+void skipWhitespace(std::string_view s, size_t& pos) {
+    while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\r' || s[pos] == '\n')) {
+        ++pos;
+    }
+}
+
+bool parseHex4(std::string_view s, size_t pos, uint32_t& value) {
+    if (pos + 4 > s.size()) {
+        return false;
+    }
+    value = 0;
+    for (size_t i = pos; i < pos + 4; ++i) {
+        char c = s[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= static_cast<uint32_t>(c - '0');
+        else if (c >= 'a' && c <= 'f') value |= static_cast<uint32_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') value |= static_cast<uint32_t>(c - 'A' + 10);
+        else return false;
+    }
+    return true;
+}
+
+// 解析JSON字符串，pos指向开头的引号；out为nullptr时只跳过
+bool parseJsonString(std::string_view s, size_t& pos, std::string* out) {
+    if (pos >= s.size() || s[pos] != '"') {
+        return false;
+    }
+    ++pos;
+    while (pos < s.size()) {
+        // 快速路径：整段拷贝不含转义的内容
+        size_t run = pos;
+        while (run < s.size() && s[run] != '"' && s[run] != '\\') {
+            ++run;
+        }
+        if (out) {
+            out->append(s.data() + pos, run - pos);
+        }
+        pos = run;
+        if (pos >= s.size()) {
+            return false;
+        }
+        if (s[pos] == '"') {
+            ++pos;
+            return true;
+        }
+        // 转义字符
+        if (++pos >= s.size()) {
+            return false;
+        }
+        char c = s[pos++];
+        if (!out) {
+            if (c == 'u') pos += 4;
+            continue;
+        }
+        switch (c) {
+            case '"': out->push_back('"'); break;
+            case '\\': out->push_back('\\'); break;
+            case '/': out->push_back('/'); break;
+            case 'b': out->push_back('\b'); break;
+            case 'f': out->push_back('\f'); break;
+            case 'n': out->push_back('\n'); break;
+            case 'r': out->push_back('\r'); break;
+            case 't': out->push_back('\t'); break;
+            case 'u': {
+                uint32_t cp = 0;
+                if (!parseHex4(s, pos, cp)) {
+                    return false;
+                }
+                pos += 4;
+                // 代理对
+                if (cp >= 0xD800 && cp <= 0xDBFF && pos + 6 <= s.size() &&
+                    s[pos] == '\\' && s[pos + 1] == 'u') {
+                    uint32_t low = 0;
+                    if (parseHex4(s, pos + 2, low) && low >= 0xDC00 && low <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        pos += 6;
+                    }
+                }
+                utils::appendUtf8(cp, *out);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+// 跳过任意JSON值（数字、字面量、嵌套对象/数组）
+bool skipJsonValue(std::string_view s, size_t& pos) {
+    if (pos >= s.size()) {
+        return false;
+    }
+    char c = s[pos];
+    if (c == '"') {
+        return parseJsonString(s, pos, nullptr);
+    }
+    if (c == '{' || c == '[') {
+        int depth = 0;
+        while (pos < s.size()) {
+            char ch = s[pos];
+            if (ch == '"') {
+                if (!parseJsonString(s, pos, nullptr)) {
+                    return false;
+                }
+                continue;
+            }
+            if (ch == '{' || ch == '[') {
+                ++depth;
+            } else if (ch == '}' || ch == ']') {
+                if (--depth == 0) {
+                    ++pos;
+                    return true;
+                }
+            }
+            ++pos;
+        }
+        return false;
+    }
+    while (pos < s.size() && s[pos] != ',' && s[pos] != '}' && s[pos] != ']' &&
+           s[pos] != ' ' && s[pos] != '\t' && s[pos] != '\r') {
+        ++pos;
+    }
+    return true;
+}
+
+bool parseInt64(std::string_view s, int64_t& value) {
+    if (s.empty()) {
+        return false;
+    }
+    auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+    return result.ec == std::errc() && result.ptr == s.data() + s.size();
+}
+
+bool parseJsonRecord(std::string_view line, const BulkLoadOptions& options,
+                     Document& doc, bool& has_id) {
+    size_t pos = 0;
+    skipWhitespace(line, pos);
+    if (pos >= line.size() || line[pos] != '{') {
+        return false;
+    }
+    ++pos;
+
+    bool has_content = false;
+    std::string key;
+    while (true) {
+        skipWhitespace(line, pos);
+        if (pos < line.size() && line[pos] == '}') {
+            break;
+        }
+        key.clear();
+        if (!parseJsonString(line, pos, &key)) {
+            return false;
+        }
+        skipWhitespace(line, pos);
+        if (pos >= line.size() || line[pos] != ':') {
+            return false;
+        }
+        ++pos;
+        skipWhitespace(line, pos);
+
+        if (key == options.content_field && pos < line.size() && line[pos] == '"') {
+            doc.content.clear();
+            if (!parseJsonString(line, pos, &doc.content)) {
+                return false;
+            }
+            has_content = true;
+        } else if (key == options.title_field && pos < line.size() && line[pos] == '"') {
+            doc.title.clear();
+            if (!parseJsonString(line, pos, &doc.title)) {
+                return false;
+            }
+        } else if (key == options.id_field) {
+            size_t start = pos;
+            if (pos < line.size() && line[pos] == '"') {
+                std::string id_text;
+                if (!parseJsonString(line, pos, &id_text)) {
+                    return false;
+                }
+                has_id = parseInt64(id_text, doc.doc_id);
+            } else {
+                if (!skipJsonValue(line, pos)) {
+                    return false;
+                }
+                has_id = parseInt64(line.substr(start, pos - start), doc.doc_id);
+            }
+        } else if (!skipJsonValue(line, pos)) {
+            return false;
+        }
+
+        skipWhitespace(line, pos);
+        if (pos < line.size() && line[pos] == ',') {
+            ++pos;
+            continue;
+        }
+        if (pos < line.size() && line[pos] == '}') {
+            break;
+        }
+        return false;
+    }
+    return has_content;
+}
+
+bool parseTsvRecord(std::string_view line, const BulkLoadOptions& options,
+                    std::vector<std::string_view>& fields, Document& doc, bool& has_id) {
+    scan::splitFields(line, '\t', fields);
+    auto column = [&fields](int index) -> const std::string_view* {
+        if (index < 0 || static_cast<size_t>(index) >= fields.size()) {
+            return nullptr;
+        }
+        return &fields[static_cast<size_t>(index)];
+    };
+
+    const std::string_view* content = column(options.content_column);
+    if (!content) {
+        return false;
+    }
+    doc.content.assign(content->data(), content->size());
+    if (const std::string_view* title = column(options.title_column)) {
+        doc.title.assign(title->data(), title->size());
+    }
+    if (const std::string_view* id = column(options.id_column)) {
+        has_id = parseInt64(*id, doc.doc_id);
+    }
+    return true;
+}
+
+void parseBatch(const MappedFile& file, const RawBatch& raw, const BulkLoadOptions& options,
+                const Tokenizer& tokenizer, ParsedBatch& out) {
+    out.seq = raw.seq;
+    out.end = raw.end;
+
+    std::vector<std::string_view> fields;
+    std::unordered_map<std::string, int32_t> term_freq;
+    LineScanner scanner(file.data() + raw.begin, raw.end - raw.begin);
+    std::string_view line;
+
+    while (scanner.next(line)) {
+        if (line.empty()) {
+            continue;
+        }
+        out.records++;
+
+        ParsedDoc parsed;
+        bool ok = options.format == CorpusFormat::kJsonLines
+            ? parseJsonRecord(line, options, parsed.doc, parsed.has_id)
+            : parseTsvRecord(line, options, fields, parsed.doc, parsed.has_id);
+        if (!ok) {
+            out.malformed++;
+            continue;
+        }
+
+        parsed.doc.tokens = tokenizer.tokenize(parsed.doc.content, &parsed.doc.token_offsets);
+        term_freq.clear();
+        for (const auto& token : parsed.doc.tokens) {
+            term_freq[token]++;
+        }
+        parsed.term_freqs.assign(term_freq.begin(), term_freq.end());
+        out.docs.push_back(std::move(parsed));
+    }
+}
+
+} // namespace
+
+bool BulkLoader::load(const std::string& filepath, const BulkLoadOptions& options) {
+    stats_ = BulkLoadStats();
+    error_.clear();
+
+    MappedFile file;
+    if (!file.open(filepath)) {
+        error_ = file.lastError();
+        return false;
+    }
+    stats_.total_bytes = file.size();
+    if (file.size() == 0) {
+        return true;
+    }
+
+    size_t num_workers = options.num_workers;
+    if (num_workers == 0) {
+        num_workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    size_t max_inflight = options.max_inflight_batches;
+    if (max_inflight == 0) {
+        max_inflight = num_workers * 2;
+    }
+    const size_t batch_bytes = std::max<size_t>(options.batch_bytes, 4096);
+
+    BoundedQueue<RawBatch> raw_queue(max_inflight);
+    BoundedQueue<ParsedBatch> parsed_queue(max_inflight);
+
+    // 在途批次计数：读取线程在达到上限时等待写索引阶段消费
+    std::mutex inflight_mutex;
+    std::condition_variable inflight_cv;
+    size_t inflight = 0;
+    bool aborted = false;
+
+    const auto start_time = std::chrono::steady_clock::now();
+    auto elapsed = [&start_time]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    };
+
+    // 1. 读取阶段：按批次切分，每个批次以完整行结尾
+    std::thread reader([&]() {
+        const char* data = file.data();
+        const size_t size = file.size();
+        size_t offset = 0;
+        uint64_t seq = 0;
+        while (offset < size) {
+            size_t end = std::min(offset + batch_bytes, size);
+            if (end < size) {
+                const char* nl = scan::findByte(data + end, data + size, '\n');
+                end = (nl == data + size) ? size : static_cast<size_t>(nl - data) + 1;
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(inflight_mutex);
+                inflight_cv.wait(lock, [&] { return aborted || inflight < max_inflight; });
+                if (aborted) {
+                    break;
+                }
+                inflight++;
+            }
+
+            RawBatch batch;
+            batch.seq = seq++;
+            batch.begin = offset;
+            batch.end = end;
+            if (!raw_queue.push(batch)) {
+                break;
+            }
+            offset = end;
+        }
+        raw_queue.close();
+    });
+
+    // 2. 解析 + 分词阶段
+    const Tokenizer& tokenizer = builder_.getTokenizer();
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back([&]() {
+            RawBatch raw;
+            while (raw_queue.pop(raw)) {
+                ParsedBatch parsed;
+                parseBatch(file, raw, options, tokenizer, parsed);
+                if (!parsed_queue.push(std::move(parsed))) {
+                    break;
+                }
+            }
+        });
+    }
+    std::thread closer([&]() {
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        parsed_queue.close();
+    });
+
+    // 3. 写索引阶段（当前线程）：按批次序号顺序写入
+    std::map<uint64_t, ParsedBatch> pending;
+    uint64_t next_seq = 0;
+    size_t released = 0;
+    uint64_t next_progress = options.progress_interval_docs;
+    ParsedBatch batch;
+    while (parsed_queue.pop(batch)) {
+        pending.emplace(batch.seq, std::move(batch));
+        for (auto it = pending.find(next_seq); it != pending.end(); it = pending.find(next_seq)) {
+            ParsedBatch& ready = it->second;
+            for (auto& parsed : ready.docs) {
+                if (!parsed.has_id) {
+                    parsed.doc.doc_id = builder_.reserveDocIds(1);
+                }
+                if (builder_.addTokenizedDocument(std::move(parsed.doc), parsed.term_freqs)) {
+                    stats_.docs_indexed++;
+                } else {
+                    stats_.duplicate_ids++;
+                }
+            }
+            stats_.records += ready.records;
+            stats_.malformed += ready.malformed;
+            stats_.bytes_processed = ready.end;
+
+            // 之前的批次都已解析完成（内容已拷贝出来），对应页面可以释放
+            file.release(released, ready.end - released);
+            released = ready.end;
+
+            pending.erase(it);
+            next_seq++;
+            {
+                std::lock_guard<std::mutex> lock(inflight_mutex);
+                inflight--;
+            }
+            inflight_cv.notify_one();
+
+            if (options.progress_callback && options.progress_interval_docs > 0 &&
+                stats_.docs_indexed >= next_progress) {
+                stats_.elapsed_seconds = elapsed();
+                options.progress_callback(stats_);
+                next_progress = stats_.docs_indexed + options.progress_interval_docs;
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(inflight_mutex);
+        aborted = true;
+    }
+    inflight_cv.notify_all();
+    reader.join();
+    closer.join();
+
+    stats_.elapsed_seconds = elapsed();
+    if (options.progress_callback) {
+        options.progress_callback(stats_);
+    }
+    return true;
+}
+
+} // namespace search_engine
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <cstdint>
+#include "storage/index_builder.h"
+
+namespace search_engine {
+
+/**
+ * @brief 批量导入的语料格式
+ */
+enum class CorpusFormat {
+    kJsonLines,   // 每行一个JSON对象
+    kTsv          // 每行一条记录，字段以制表符分隔
+};
+
+/**
+ * @brief 批量导入统计信息
+ */
+struct BulkLoadStats {
+    uint64_t total_bytes = 0;      // 文件总字节数
+    uint64_t bytes_processed = 0;  // 已写入索引的记录所覆盖的字节数
+    uint64_t records = 0;          // 读到的非空行数
+    uint64_t docs_indexed = 0;     // 成功写入索引的文档数
+    uint64_t malformed = 0;        // 格式错误被跳过的记录数
+    uint64_t duplicate_ids = 0;    // 文档ID与已导入文档重复被跳过的记录数
+    double elapsed_seconds = 0.0;  // 已用时间
+
+    double megabytesPerSecond() const {
+        return elapsed_seconds > 0 ? bytes_processed / 1048576.0 / elapsed_seconds : 0.0;
+    }
+    double docsPerSecond() const {
+        return elapsed_seconds > 0 ? docs_indexed / elapsed_seconds : 0.0;
+    }
+};
+
+/**
+ * @brief 批量导入配置
+ */
+struct BulkLoadOptions {
+    CorpusFormat format = CorpusFormat::kJsonLines;
+
+    // JSONL字段名（id缺失或非整数时自动分配文档ID；显式ID与已导入的文档重复时跳过该记录，
+    // 包括之前自动分配出去的ID，因此混用两种方式时显式ID应避开自动分配的范围）
+    std::string id_field = "id";
+    std::string title_field = "title";
+    std::string content_field = "content";
+
+    // TSV列号（-1表示不存在）
+    int id_column = 0;
+    int title_column = -1;
+    int content_column = 1;
+
+    size_t num_workers = 0;              // 解析/分词线程数（0表示按CPU核数）
+    size_t batch_bytes = 4 << 20;        // 每个批次的大约字节数
+    size_t max_inflight_batches = 0;     // 流水线中最多的在途批次数（0表示num_workers*2）
+    uint64_t progress_interval_docs = 100000;  // 每导入多少文档回调一次进度
+
+    std::function<void(const BulkLoadStats&)> progress_callback;
+};
+
+/**
+ * @brief 大文件批量导入器
+ *
+ * 从按行分隔的语料（JSONL / TSV）中批量构建索引：
+ *
+ *   读取（mmap + SIMD换行扫描，切分成批次）
+ *     → 解析 + 分词 + 词频统计（多个工作线程）
+ *     → 写索引（调用线程，按批次顺序写入，保证文档ID有序）
+ *
+ * 设计思路：
+ * - 零拷贝读取：记录在解析前只是mmap区域上的视图
+ * - 反压：在途批次数有上限，写索引跟不上时读取线程阻塞，内存占用有界
+ * - 已写入索引的批次对应的页面会被释放（MADV_DONTNEED），常驻内存不随文件大小增长
+ * - 索引结构不是线程安全的，写索引阶段保持单线程，其余工作都放在并行阶段
+ */
+class BulkLoader {
+public:
+    explicit BulkLoader(IndexBuilder& builder) : builder_(builder) {}
+
+    /**
+     * @brief 导入语料文件
+     * @param filepath 文件路径
+     * @param options 导入配置
+     * @return 是否成功（文件无法打开时返回false，单条记录格式错误只计数不失败）
+     */
+    bool load(const std::string& filepath, const BulkLoadOptions& options = BulkLoadOptions());
+
+    /**
+     * @brief 获取最近一次导入的统计信息
+     */
+    const BulkLoadStats& stats() const { return stats_; }
+
+    /**
+     * @brief 获取最近一次失败的原因
+     */
+    const std::string& lastError() const { return error_; }
+
+private:
+    IndexBuilder& builder_;
+    BulkLoadStats stats_;
+    std::string error_;
+};
+
+} // namespace search_engine
@@ -0,0 +1,303 @@
+#include "storage/doc_reorderer.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+namespace search_engine {
+
+namespace {
+
+// splitmix64，用作MinHash的哈希函数族
+inline uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+size_t resolveThreads(size_t requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+// 把[0, count)切成若干段并行执行
+template <typename Func>
+void parallelFor(size_t count, size_t num_threads, Func&& func) {
+    num_threads = std::min(num_threads, std::max<size_t>(1, count / 4096));
+    if (num_threads <= 1) {
+        func(0, count);
+        return;
+    }
+    std::vector<std::thread> threads;
+    const size_t chunk = (count + num_threads - 1) / num_threads;
+    for (size_t begin = 0; begin < count; begin += chunk) {
+        threads.emplace_back(func, begin, std::min(begin + chunk, count));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// 图二分的线程私有工作区：term度数按term编号直接寻址，只清理用到的项
+struct Workspace {
+    std::vector<int32_t> left_degree;
+    std::vector<int32_t> right_degree;
+    std::vector<float> gain_to_right;
+    std::vector<float> gain_to_left;
+    std::vector<uint32_t> touched;
+    std::vector<std::pair<float, uint32_t>> left_gains;
+    std::vector<std::pair<float, uint32_t>> right_gains;
+
+    explicit Workspace(size_t num_terms)
+        : left_degree(num_terms, 0), right_degree(num_terms, 0),
+          gain_to_right(num_terms, 0.0f), gain_to_left(num_terms, 0.0f) {}
+};
+
+class Bisector {
+public:
+    Bisector(const DocTermGraph& graph, const ReorderOptions& options)
+        : graph_(graph), options_(options),
+          spare_threads_(resolveThreads(options.num_threads) - 1) {
+        // log2表：代价函数只需要[0, 文档数+1]上的对数
+        log2_.resize(graph.numDocs() + 2);
+        for (size_t i = 1; i < log2_.size(); ++i) {
+            log2_[i] = static_cast<float>(std::log2(static_cast<double>(i)));
+        }
+    }
+
+    void run(std::vector<uint32_t>& order) {
+        Workspace workspace(graph_.num_terms);
+        bisect(order.data(), order.size(), 0, workspace);
+    }
+
+private:
+    // 某个term在大小为n的分区中出现在d个文档里时，差值编码的近似代价
+    float cost(int32_t d, size_t n) const {
+        return d * (log2_[n] - log2_[d + 1]);
+    }
+
+    void bisect(uint32_t* docs, size_t n, size_t depth, Workspace& workspace) {
+        if (n <= std::max<size_t>(options_.leaf_size, 1) ||
+            (options_.max_depth > 0 && depth >= options_.max_depth)) {
+            return;
+        }
+        const size_t half = n / 2;
+        partition(docs, n, half, workspace);
+
+        // 大分区的左半边交给新线程，右半边在当前线程继续
+        if (n >= options_.parallel_threshold && acquireThread()) {
+            std::thread worker([this, docs, half, depth] {
+                Workspace local(graph_.num_terms);
+                bisect(docs, half, depth + 1, local);
+                spare_threads_.fetch_add(1);
+            });
+            bisect(docs + half, n - half, depth + 1, workspace);
+            worker.join();
+        } else {
+            bisect(docs, half, depth + 1, workspace);
+            bisect(docs + half, n - half, depth + 1, workspace);
+        }
+    }
+
+    bool acquireThread() {
+        size_t available = spare_threads_.load();
+        while (available > 0) {
+            if (spare_threads_.compare_exchange_weak(available, available - 1)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 把docs[0, n)分成[0, half)和[half, n)两部分，迭代交换收益为正的文档对
+    void partition(uint32_t* docs, size_t n, size_t half, Workspace& ws) {
+        const size_t n1 = half;
+        const size_t n2 = n - half;
+        auto termsOf = [this](uint32_t doc) {
+            return std::make_pair(graph_.terms.data() + graph_.offsets[doc],
+                                  graph_.terms.data() + graph_.offsets[doc + 1]);
+        };
+
+        ws.touched.clear();
+        for (size_t i = 0; i < n; ++i) {
+            auto [begin, end] = termsOf(docs[i]);
+            for (const uint32_t* t = begin; t != end; ++t) {
+                if (ws.left_degree[*t] == 0 && ws.right_degree[*t] == 0) {
+                    ws.touched.push_back(*t);
+                }
+                if (i < half) {
+                    ws.left_degree[*t]++;
+                } else {
+                    ws.right_degree[*t]++;
+                }
+            }
+        }
+
+        for (size_t iteration = 0; iteration < options_.iterations; ++iteration) {
+            // 1. 每个term移动一个文档带来的代价变化只与(d1, d2)有关，先按term算好
+            for (uint32_t t : ws.touched) {
+                const int32_t d1 = ws.left_degree[t];
+                const int32_t d2 = ws.right_degree[t];
+                const float current = cost(d1, n1) + cost(d2, n2);
+                ws.gain_to_right[t] = d1 > 0 ? current - cost(d1 - 1, n1) - cost(d2 + 1, n2) : 0.0f;
+                ws.gain_to_left[t] = d2 > 0 ? current - cost(d1 + 1, n1) - cost(d2 - 1, n2) : 0.0f;
+            }
+
+            // 2. 文档的移动收益 = 其所有term的收益之和
+            ws.left_gains.clear();
+            ws.right_gains.clear();
+            for (size_t i = 0; i < n; ++i) {
+                auto [begin, end] = termsOf(docs[i]);
+                const std::vector<float>& gains = i < half ? ws.gain_to_right : ws.gain_to_left;
+                float gain = 0.0f;
+                for (const uint32_t* t = begin; t != end; ++t) {
+                    gain += gains[*t];
+                }
+                (i < half ? ws.left_gains : ws.right_gains).emplace_back(gain, docs[i]);
+            }
+            auto higher = [](const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) {
+                return a.first > b.first;
+            };
+            std::sort(ws.left_gains.begin(), ws.left_gains.end(), higher);
+            std::sort(ws.right_gains.begin(), ws.right_gains.end(), higher);
+
+            // 3. 两边按收益从高到低配对交换，直到一对的总收益不再为正
+            size_t swaps = 0;
+            const size_t pairs = std::min(ws.left_gains.size(), ws.right_gains.size());
+            for (; swaps < pairs; ++swaps) {
+                auto& left = ws.left_gains[swaps];
+                auto& right = ws.right_gains[swaps];
+                if (left.first + right.first <= 0.0f) {
+                    break;
+                }
+                auto [lbegin, lend] = termsOf(left.second);
+                for (const uint32_t* t = lbegin; t != lend; ++t) {
+                    ws.left_degree[*t]--;
+                    ws.right_degree[*t]++;
+                }
+                auto [rbegin, rend] = termsOf(right.second);
+                for (const uint32_t* t = rbegin; t != rend; ++t) {
+                    ws.right_degree[*t]--;
+                    ws.left_degree[*t]++;
+                }
+                std::swap(left.second, right.second);
+            }
+            for (size_t i = 0; i < n1; ++i) {
+                docs[i] = ws.left_gains[i].second;
+            }
+            for (size_t i = 0; i < n2; ++i) {
+                docs[half + i] = ws.right_gains[i].second;
+            }
+            if (swaps == 0) {
+                break;
+            }
+        }
+
+        for (uint32_t t : ws.touched) {
+            ws.left_degree[t] = 0;
+            ws.right_degree[t] = 0;
+        }
+    }
+
+    const DocTermGraph& graph_;
+    const ReorderOptions& options_;
+    std::vector<float> log2_;
+    std::atomic<size_t> spare_threads_;
+};
+
+} // namespace
+
+DocTermGraph DocReorderer::buildGraph(const InvertedIndex& index,
+                                      const std::vector<int64_t>& doc_ids,
+                                      size_t min_term_df) {
+    DocTermGraph graph;
+    std::unordered_map<int64_t, uint32_t> dense;
+    dense.reserve(doc_ids.size());
+    for (size_t i = 0; i < doc_ids.size(); ++i) {
+        dense.emplace(doc_ids[i], static_cast<uint32_t>(i));
+    }
+
+    // 1. 收集 (文档, term) 边，同时统计每个文档的度数
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<uint32_t> degrees(doc_ids.size(), 0);
+    index.forEachPostingList([&](const std::string&, const std::vector<Posting>& postings) {
+        if (postings.size() < std::max<size_t>(min_term_df, 1)) {
+            return;
+        }
+        const uint32_t term = static_cast<uint32_t>(graph.num_terms++);
+        for (const auto& posting : postings) {
+            auto it = dense.find(posting.doc_id);
+            if (it != dense.end()) {
+                edges.emplace_back(it->second, term);
+                degrees[it->second]++;
+            }
+        }
+    });
+
+    // 2. 按文档计数排序成CSR
+    graph.offsets.assign(doc_ids.size() + 1, 0);
+    for (size_t i = 0; i < doc_ids.size(); ++i) {
+        graph.offsets[i + 1] = graph.offsets[i] + degrees[i];
+    }
+    graph.terms.resize(edges.size());
+    std::vector<uint32_t> cursor(graph.offsets.begin(), graph.offsets.end() - 1);
+    for (const auto& [doc, term] : edges) {
+        graph.terms[cursor[doc]++] = term;
+    }
+    return graph;
+}
+
+std::vector<uint32_t> DocReorderer::computeOrder(const DocTermGraph& graph) const {
+    std::vector<uint32_t> order = minHashOrder(graph);
+    if (options_.method == ReorderMethod::kGraphBisection) {
+        graphBisection(graph, order);
+    }
+    return order;
+}
+
+std::vector<uint32_t> DocReorderer::minHashOrder(const DocTermGraph& graph) const {
+    const size_t num_docs = graph.numDocs();
+    const size_t k = std::max<size_t>(options_.minhash_signatures, 1);
+
+    // 每个签名是文档term集合在一个哈希函数下的最小值；相似文档的签名大概率相同
+    std::vector<uint64_t> signatures(num_docs * k, std::numeric_limits<uint64_t>::max());
+    parallelFor(num_docs, resolveThreads(options_.num_threads), [&](size_t begin, size_t end) {
+        for (size_t doc = begin; doc < end; ++doc) {
+            uint64_t* signature = signatures.data() + doc * k;
+            for (uint32_t i = graph.offsets[doc]; i < graph.offsets[doc + 1]; ++i) {
+                for (size_t j = 0; j < k; ++j) {
+                    uint64_t hash = mix64(graph.terms[i] ^ (0x5851F42D4C957F2DULL * (j + 1)));
+                    signature[j] = std::min(signature[j], hash);
+                }
+            }
+        }
+    });
+
+    std::vector<uint32_t> order(num_docs);
+    for (size_t i = 0; i < num_docs; ++i) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        const uint64_t* sa = signatures.data() + size_t(a) * k;
+        const uint64_t* sb = signatures.data() + size_t(b) * k;
+        for (size_t j = 0; j < k; ++j) {
+            if (sa[j] != sb[j]) {
+                return sa[j] < sb[j];
+            }
+        }
+        return a < b;
+    });
+    return order;
+}
+
+void DocReorderer::graphBisection(const DocTermGraph& graph, std::vector<uint32_t>& order) const {
+    Bisector bisector(graph, options_);
+    bisector.run(order);
+}
+
+} // namespace search_engine
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "index/inverted_index.h"
+
+namespace search_engine {
+
+/**
+ * @brief 文档重排序算法
+ */
+enum class ReorderMethod {
+    kMinHash,          // 按term集合的MinHash签名排序（线性时间，效果一般）
+    kGraphBisection    // 递归图二分（Recursive Graph Bisection，效果好，较慢）
+};
+
+/**
+ * @brief 文档重排序配置
+ */
+struct ReorderOptions {
+    ReorderMethod method = ReorderMethod::kGraphBisection;
+
+    size_t min_term_df = 2;             // 文档频率低于该值的term不参与（对压缩没有影响）
+    size_t minhash_signatures = 4;      // MinHash签名个数（按签名字典序排序）
+
+    size_t iterations = 20;             // 图二分每层最多的交换轮数
+    size_t leaf_size = 16;              // 分区文档数不超过该值时停止二分
+    size_t max_depth = 0;               // 最大递归深度（0表示不限制）
+    size_t num_threads = 0;             // 线程数（0表示按CPU核数）
+    size_t parallel_threshold = 4096;   // 分区文档数超过该值时左右子问题并行处理
+};
+
+/**
+ * @brief 文档重排序统计信息
+ */
+struct ReorderStats {
+    size_t docs = 0;                    // 参与重排序的文档数
+    size_t terms = 0;                   // 参与重排序的term数
+    size_t postings = 0;                // posting总数
+    size_t posting_bytes_before = 0;    // 重排序前doc_id差值Varint编码字节数
+    size_t posting_bytes_after = 0;     // 重排序后doc_id差值Varint编码字节数
+    double elapsed_seconds = 0.0;       // 重排序耗时
+
+    double bitsPerPostingBefore() const {
+        return postings > 0 ? 8.0 * posting_bytes_before / postings : 0.0;
+    }
+    double bitsPerPostingAfter() const {
+        return postings > 0 ? 8.0 * posting_bytes_after / postings : 0.0;
+    }
+};
+
+/**
+ * @brief 文档-term二部图（CSR存储）
+ * 文档i的term为 terms[offsets[i], offsets[i+1])，term用稠密编号表示
+ */
+struct DocTermGraph {
+    std::vector<uint32_t> offsets{0};
+    std::vector<uint32_t> terms;
+    size_t num_terms = 0;
+
+    size_t numDocs() const { return offsets.size() - 1; }
+};
+
+/**
+ * @brief 文档重排序器
+ *
+ * 为文档重新分配ID，使内容相似的文档ID相邻，posting列表中的doc_id差值变小，
+ * 差值编码后更短，遍历时的访问也更集中
+ *
+ * 设计思路：
+ * - 图二分（Dhulipala等, KDD'16）：把文档集合递归地一分为二，
+ *   每层迭代交换两边"移动收益"最大的文档对，目标是最小化差值编码的对数代价
+ *   sum_t d1*log2(n1/(d1+1)) + d2*log2(n2/(d2+1))
+ * - 以MinHash排序结果作为二分的初始顺序，收敛更快
+ * - 左右子问题互不相关，大分区在独立线程中处理（每个线程一份term度数工作区）
+ */
+class DocReorderer {
+public:
+    explicit DocReorderer(const ReorderOptions& options = ReorderOptions()) : options_(options) {}
+
+    /**
+     * @brief 从倒排索引构建文档-term二部图
+     * @param index 倒排索引
+     * @param doc_ids 参与重排序的文档ID（图中的文档i对应doc_ids[i]）
+     * @param min_term_df 文档频率低于该值的term不加入图
+     */
+    static DocTermGraph buildGraph(const InvertedIndex& index,
+                                   const std::vector<int64_t>& doc_ids,
+                                   size_t min_term_df);
+
+    /**
+     * @brief 计算新的文档顺序
+     * @param graph 文档-term二部图
+     * @return order[新位置] = 图中的文档编号
+     */
+    std::vector<uint32_t> computeOrder(const DocTermGraph& graph) const;
+
+private:
+    std::vector<uint32_t> minHashOrder(const DocTermGraph& graph) const;
+    void graphBisection(const DocTermGraph& graph, std::vector<uint32_t>& order) const;
+
+    ReorderOptions options_;
+};
+
+} // namespace search_engine
@@ -0,0 +1,101 @@
+#include "storage/durable_index_writer.h"
+
+namespace search_engine {
+
+namespace {
+
+WalRecord makeRecord(WalOp op, const Document& doc) {
+    WalRecord record;
+    record.op = op;
+    record.doc_id = doc.doc_id;
+    record.title = doc.title;
+    record.content = doc.content;
+    return record;
+}
+
+} // namespace
+
+bool DurableIndexWriter::open(const std::string& path, const WalOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    failed_ = false;
+    if (!log_.open(path, options, [this](const WalRecord& record) { applyRecord(record); })) {
+        return false;
+    }
+    applied_lsn_ = log_.lastLsn();
+    return true;
+}
+
+bool DurableIndexWriter::addDocument(const Document& doc) {
+    return applyBatch({makeRecord(WalOp::kAdd, doc)});
+}
+
+bool DurableIndexWriter::updateDocument(const Document& doc) {
+    return applyBatch({makeRecord(WalOp::kUpdate, doc)});
+}
+
+bool DurableIndexWriter::removeDocument(int64_t doc_id) {
+    WalRecord record;
+    record.op = WalOp::kDelete;
+    record.doc_id = doc_id;
+    return applyBatch({record});
+}
+
+bool DurableIndexWriter::applyBatch(const std::vector<WalRecord>& records) {
+    if (records.empty()) {
+        return true;
+    }
+    uint64_t lsn = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (failed_) {
+            return false;
+        }
+        lsn = log_.enqueue(records);
+        if (lsn == 0) {
+            failed_ = true;
+            applied_cv_.notify_all();
+            return false;
+        }
+    }
+    const uint64_t first_lsn = lsn - records.size() + 1;
+
+    // 等待落盘不持锁，并发提交由组提交合并
+    const bool durable = log_.options().durability == WalDurability::kNone || log_.waitDurable(lsn);
+
+    // 按lsn顺序修改内存索引：等前面的批次应用完
+    std::unique_lock<std::mutex> lock(mutex_);
+    applied_cv_.wait(lock, [this, first_lsn] { return applied_lsn_ + 1 == first_lsn || failed_; });
+    if (!durable || failed_) {
+        failed_ = true;
+        applied_cv_.notify_all();
+        return false;
+    }
+    for (const auto& record : records) {
+        applyRecord(record);
+    }
+    applied_lsn_ = lsn;
+    applied_cv_.notify_all();
+    return true;
+}
+
+void DurableIndexWriter::applyRecord(const WalRecord& record) {
+    switch (record.op) {
+        case WalOp::kAdd:
+        case WalOp::kUpdate: {
+            // ID已存在时IndexBuilder::addDocument会重复计入倒排和文档长度，
+            // 添加统一按更新处理（旧版本不存在时等同于添加）；是否已存在要到应用时才能确定
+            // （前面的批次可能还在等待落盘），重放时也走同一路径
+            Document doc(record.doc_id, record.content);
+            doc.title = record.title;
+            builder_.updateDocument(doc);
+            break;
+        }
+        case WalOp::kDelete:
+            builder_.removeDocument(record.doc_id);
+            break;
+        case WalOp::kCheckpoint:
+            break;
+    }
+}
+
+} // namespace search_engine
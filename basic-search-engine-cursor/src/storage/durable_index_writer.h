@@ -0,0 +1,81 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "storage/index_builder.h"
+#include "storage/write_ahead_log.h"
+
+namespace search_engine {
+
+/**
+ * @brief 带预写日志的增量索引写入器
+ *
+ * 所有写操作先追加到WriteAheadLog、按持久化级别提交之后再修改内存索引；
+ * 启动时open()把日志重放进IndexBuilder，恢复崩溃前已提交的写入。
+ *
+ * 设计思路：
+ * - 分配lsn在mutex_内完成；等待落盘在锁外进行，多个线程并发提交时由组提交合并成一次fdatasync；
+ *   落盘后再按lsn顺序修改内存索引，保证内存索引的修改顺序与日志顺序一致
+ * - kGroupCommit/kSync：只有已落盘的写入才对内存索引可见；日志写入或刷盘失败时
+ *   本批及之后的写入都不会应用
+ * - kNone：不等待落盘，立即应用；后台刷盘失败时已应用的写入在重启后丢失
+ * - 日志失败后写入器进入失败状态，之后的写入都返回false，需要重新open()
+ * - 一批文档（applyBatch）共用一次提交，是吞吐和持久性之间的主要调节手段
+ * - IndexBuilder本身不是线程安全的，写入期间不能同时查询同一个索引
+ *   （在线服务应在另一份索引上查询，见IndexSnapshot）
+ * - 写入的都是未分词的原文，重放时重新分词；文档属性（DocValues）不记录日志，
+ *   更新文档时保留原有属性，删除文档时清除
+ */
+class DurableIndexWriter {
+public:
+    explicit DurableIndexWriter(IndexBuilder& builder) : builder_(builder) {}
+
+    DurableIndexWriter(const DurableIndexWriter&) = delete;
+    DurableIndexWriter& operator=(const DurableIndexWriter&) = delete;
+
+    /**
+     * @brief 打开日志并把已有记录重放进索引
+     * @param path 日志文件路径
+     * @param options 日志配置
+     * @return 是否成功（失败原因见lastError()）
+     */
+    bool open(const std::string& path, const WalOptions& options = WalOptions());
+
+    /**
+     * @brief 添加 / 更新 / 删除文档
+     * 添加已存在的ID时替换旧版本（与updateDocument相同），不会重复计入索引
+     * @return 是否已提交并应用（返回false时本次写入没有修改内存索引）
+     */
+    bool addDocument(const Document& doc);
+    bool updateDocument(const Document& doc);
+    bool removeDocument(int64_t doc_id);
+
+    /**
+     * @brief 批量提交：整批只写一次日志、等待一次落盘
+     * @param records 操作列表（按顺序应用）
+     */
+    bool applyBatch(const std::vector<WalRecord>& records);
+
+    /**
+     * @brief 刷盘并关闭日志
+     */
+    void close() { log_.close(); }
+
+    WriteAheadLog& log() { return log_; }
+    const WalReplayStats& replayStats() const { return log_.replayStats(); }
+    const std::string& lastError() const { return log_.lastError(); }
+
+private:
+    void applyRecord(const WalRecord& record);
+
+    IndexBuilder& builder_;
+    WriteAheadLog log_;
+    std::mutex mutex_;
+    std::condition_variable applied_cv_;    // 等待前面的批次应用到内存索引
+    uint64_t applied_lsn_ = 0;              // 已应用到内存索引的最后一个lsn
+    bool failed_ = false;
+};
+
+} // namespace search_engine
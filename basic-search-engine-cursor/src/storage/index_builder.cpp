@@ -1,6 +1,8 @@
 #include "storage/index_builder.h"
 #include "common/utils.h"
 #include <algorithm>
+#include <chrono>
+#include <unordered_map>
 
 namespace search_engine {
 
@@ -17,9 +19,33 @@ void IndexBuilder::addDocuments(const std::vector<Document>& docs) {
     }
 }
 
+bool IndexBuilder::removeDocument(int64_t doc_id) {
+    if (!removeIndexedDocument(doc_id)) {
+        return false;
+    }
+    doc_values_.removeDocument(doc_id);
+    return true;
+}
+
+void IndexBuilder::updateDocument(const Document& doc) {
+    // 属性不随正文变化，保留原有的DocValues
+    removeIndexedDocument(doc.doc_id);
+    buildIndex(doc);
+}
+
+bool IndexBuilder::removeIndexedDocument(int64_t doc_id) {
+    const Document* doc = forward_index_.findDocument(doc_id);
+    if (!doc) {
+        return false;
+    }
+    inverted_index_.removeDocument(doc_id, doc->tokens);
+    forward_index_.removeDocument(doc_id);
+    return true;
+}
+
 bool IndexBuilder::loadFromFile(const std::string& filepath, int64_t doc_id) {
-    std::string content = utils::readFile(filepath);
-    if (content.empty()) {
+    std::string content;
+    if (!utils::readFile(filepath, content)) {
         return false;
     }
     
@@ -27,19 +53,21 @@ bool IndexBuilder::loadFromFile(const std::string& filepath, int64_t doc_id) {
         doc_id = next_doc_id_++;
     }
     
-    Document doc(doc_id, content);
+    Document doc(doc_id, std::move(content));
     buildIndex(doc);
     
     return true;
 }
 
 void IndexBuilder::buildIndex(const Document& doc) {
-    // 1. 分词
-    auto tokens = tokenizer_.tokenize(doc);
+    // 1. 分词（同时记录token位置，供摘要生成使用）
+    std::vector<TextSpan> offsets;
+    auto tokens = tokenizer_.tokenize(doc.content, &offsets);
     
     // 2. 创建文档副本并保存tokens
     Document doc_with_tokens = doc;
     doc_with_tokens.tokens = tokens;
+    doc_with_tokens.token_offsets = std::move(offsets);
     
     // 3. 添加到正排索引
     forward_index_.addDocument(doc_with_tokens);
@@ -48,9 +76,95 @@ void IndexBuilder::buildIndex(const Document& doc) {
     inverted_index_.addDocument(doc.doc_id, tokens);
 }
 
+bool IndexBuilder::addTokenizedDocument(Document&& doc,
+                                        const std::vector<std::pair<std::string, int32_t>>& term_freqs) {
+    int64_t doc_id = doc.doc_id;
+    // 显式ID可能落在之前已分配出去的自动ID上（或与更早的显式ID重复），
+    // 覆盖会让正排被替换、倒排重复计入，因此直接拒绝
+    if (forward_index_.findDocument(doc_id)) {
+        return false;
+    }
+    // 自动ID只向后分配：显式ID不小于next_doc_id_时推进它，之后的自动ID不会再与之冲突
+    if (doc_id >= next_doc_id_) {
+        next_doc_id_ = doc_id + 1;
+    }
+    forward_index_.addDocument(std::move(doc));
+    inverted_index_.addDocument(doc_id, term_freqs);
+    return true;
+}
+
+int64_t IndexBuilder::reserveDocIds(size_t count) {
+    int64_t first = next_doc_id_;
+    next_doc_id_ += static_cast<int64_t>(count);
+    return first;
+}
+
+ReorderStats IndexBuilder::reorderDocuments(const ReorderOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+    ReorderStats stats;
+    
+    // 1. 以当前ID顺序作为图中的文档编号
+    std::vector<int64_t> doc_ids;
+    doc_ids.reserve(forward_index_.size());
+    forward_index_.forEachDocument([&doc_ids](const Document& doc) {
+        doc_ids.push_back(doc.doc_id);
+    });
+    std::sort(doc_ids.begin(), doc_ids.end());
+    
+    stats.docs = doc_ids.size();
+    stats.postings = inverted_index_.getPostingCount();
+    stats.posting_bytes_before = inverted_index_.getEncodedPostingBytes();
+    
+    // 2. 计算新顺序
+    DocReorderer reorderer(options);
+    DocTermGraph graph = DocReorderer::buildGraph(inverted_index_, doc_ids, options.min_term_df);
+    stats.terms = graph.num_terms;
+    std::vector<uint32_t> order = reorderer.computeOrder(graph);
+    
+    // 3. 按新顺序分配稠密ID并改写两个索引
+    std::unordered_map<int64_t, int64_t> mapping;
+    mapping.reserve(order.size());
+    for (size_t position = 0; position < order.size(); ++position) {
+        mapping.emplace(doc_ids[order[position]], static_cast<int64_t>(position + 1));
+    }
+    inverted_index_.remapDocIds(mapping);
+    forward_index_.remapDocIds(mapping);
+    doc_values_.remapDocIds(mapping);
+    next_doc_id_ = static_cast<int64_t>(order.size()) + 1;
+    
+    stats.posting_bytes_after = inverted_index_.getEncodedPostingBytes();
+    stats.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+const TermDictionary& IndexBuilder::buildTermDictionary() {
+    term_dictionary_.build(inverted_index_);
+    return term_dictionary_;
+}
+
+const ImpactIndex& IndexBuilder::buildImpactIndex(const ImpactOptions& options) {
+    impact_index_.build(inverted_index_, options);
+    return impact_index_;
+}
+
+IndexStats IndexBuilder::collectStats() const {
+    IndexStats stats;
+    stats.inverted = inverted_index_.collectStats();
+    stats.forward = forward_index_.collectStats();
+    stats.doc_values_columns = doc_values_.getColumnCount();
+    stats.doc_values_bytes = doc_values_.bytes();
+    stats.term_dictionary_bytes = term_dictionary_.bytes();
+    stats.impact_index_bytes = impact_index_.bytes();
+    stats.process_rss_bytes = utils::residentBytes();
+    return stats;
+}
+
 void IndexBuilder::clear() {
     inverted_index_.clear();
     forward_index_.clear();
+    term_dictionary_.clear();
+    impact_index_.clear();
+    doc_values_.clear();
     next_doc_id_ = 1;
 }
 
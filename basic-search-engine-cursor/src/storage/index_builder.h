@@ -2,8 +2,14 @@
 
 #include <vector>
 #include <string>
+#include <utility>
 #include "index/inverted_index.h"
 #include "index/forward_index.h"
+#include "index/term_dictionary.h"
+#include "index/impact_index.h"
+#include "index/doc_values.h"
+#include "index/index_stats.h"
+#include "storage/doc_reorderer.h"
 #include "common/tokenizer.h"
 #include "common/document.h"
 
@@ -17,7 +23,8 @@ namespace search_engine {
  * 设计思路：
  * - 可扩展的pipeline设计
  * - 支持批量构建
- * - 后续可扩展：多线程构建、增量更新、持久化等
+ * - 支持按文档删除/更新；持久化见DurableIndexWriter（预写日志）
+ * - 后续可扩展：多线程构建等
  */
 class IndexBuilder {
 public:
@@ -36,11 +43,25 @@ public:
      */
     void addDocuments(const std::vector<Document>& docs);
 
+    /**
+     * @brief 删除文档（正排、倒排和文档属性）
+     * @param doc_id 文档ID
+     * @return 文档是否存在
+     */
+    bool removeDocument(int64_t doc_id);
+
+    /**
+     * @brief 更新文档：删除同ID的旧版本后重新添加（旧版本不存在时等同于添加）
+     * 只替换正文和标题，文档属性（DocValues）保持不变
+     * @param doc 文档对象
+     */
+    void updateDocument(const Document& doc);
+
     /**
      * @brief 从文件加载文档并构建索引
      * @param filepath 文件路径
      * @param doc_id 文档ID（如果为-1则自动分配）
-     * @return 是否成功
+     * @return 是否成功（文件无法读取时返回false，空文件按空文档处理）
      */
     bool loadFromFile(const std::string& filepath, int64_t doc_id = -1);
 
@@ -50,6 +71,39 @@ public:
      */
     void buildIndex(const Document& doc);
 
+    /**
+     * @brief 添加已分词、已统计词频的文档（跳过分词阶段）
+     * 供批量导入流水线使用：分词和词频统计在工作线程完成，这里只做索引写入
+     * @param doc 文档对象（tokens已填充）
+     * @param term_freqs (term, 词频) 列表
+     * @return 是否写入（文档ID已存在时不写入，返回false）
+     */
+    bool addTokenizedDocument(Document&& doc,
+                              const std::vector<std::pair<std::string, int32_t>>& term_freqs);
+
+    /**
+     * @brief 预留一段连续的自动分配文档ID
+     * @param count 预留数量
+     * @return 第一个ID
+     */
+    int64_t reserveDocIds(size_t count);
+
+    /**
+     * @brief 离线文档重排序：按内容相似度重新分配文档ID（1..N），并重排posting列表
+     *
+     * 应在所有文档导入之后、查询之前调用，之前拿到的文档ID全部失效（词典不受影响）。
+     * 原始ID可通过ForwardIndex::getOriginalDocId取回
+     *
+     * @param options 重排序配置
+     * @return 重排序统计信息（含重排前后posting列表的编码字节数）
+     */
+    ReorderStats reorderDocuments(const ReorderOptions& options = ReorderOptions());
+
+    /**
+     * @brief 获取分词器（只读，线程安全）
+     */
+    const Tokenizer& getTokenizer() const { return tokenizer_; }
+
     /**
      * @brief 获取倒排索引
      * @return 倒排索引引用
@@ -62,14 +116,57 @@ public:
      */
     ForwardIndex& getForwardIndex() { return forward_index_; }
 
+    /**
+     * @brief 获取文档属性（按doc_id写入属性值，重排序时随文档一起重新编号）
+     * @return 文档属性引用
+     */
+    DocValues& getDocValues() { return doc_values_; }
+
+    /**
+     * @brief 根据当前倒排索引重建有序词典（添加文档后需重新调用）
+     * @return 词典引用
+     */
+    const TermDictionary& buildTermDictionary();
+
+    /**
+     * @brief 获取有序词典
+     * @return 词典引用
+     */
+    const TermDictionary& getTermDictionary() const { return term_dictionary_; }
+
+    /**
+     * @brief 根据当前倒排索引重建影响值索引（添加文档或重排序后需重新调用）
+     * @param options 影响值模型配置
+     * @return 影响值索引引用
+     */
+    const ImpactIndex& buildImpactIndex(const ImpactOptions& options = ImpactOptions());
+
+    /**
+     * @brief 获取影响值索引
+     * @return 影响值索引引用
+     */
+    const ImpactIndex& getImpactIndex() const { return impact_index_; }
+
+    /**
+     * @brief 统计各索引结构的内存占用（遍历所有term和文档，耗时与索引大小成正比）
+     * @return 统计报告（caches/auxiliary为空，由持有缓存的调用方追加）
+     */
+    IndexStats collectStats() const;
+
     /**
      * @brief 清空所有索引
      */
     void clear();
 
 private:
+    // 从正排和倒排索引中删除文档（不动文档属性）
+    bool removeIndexedDocument(int64_t doc_id);
+
     InvertedIndex inverted_index_;
     ForwardIndex forward_index_;
+    TermDictionary term_dictionary_;
+    ImpactIndex impact_index_;
+    DocValues doc_values_;
     Tokenizer tokenizer_;
     int64_t next_doc_id_;  // 自动分配的文档ID
 };
@@ -0,0 +1,420 @@
+#include "storage/write_ahead_log.h"
+#include "common/crc32c.h"
+#include "common/mapped_file.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace search_engine {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const size_t kHeaderSize = 8;                       // [u32 载荷长度][u32 CRC32C]
+const size_t kFixedPayloadSize = 8 + 1 + 8 + 4 + 4; // lsn + op + doc_id + 两个长度
+
+void putU32(std::string& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+void putU64(std::string& out, uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+uint32_t getU32(const char* p) {
+    const auto* b = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint32_t>(b[0]) | (static_cast<uint32_t>(b[1]) << 8) |
+           (static_cast<uint32_t>(b[2]) << 16) | (static_cast<uint32_t>(b[3]) << 24);
+}
+
+uint64_t getU64(const char* p) {
+    return static_cast<uint64_t>(getU32(p)) | (static_cast<uint64_t>(getU32(p + 4)) << 32);
+}
+
+// 解析一条记录的载荷，格式不合法返回false
+bool decodePayload(const char* p, size_t size, uint64_t& lsn, WalRecord& record) {
+    if (size < kFixedPayloadSize) {
+        return false;
+    }
+    lsn = getU64(p);
+    uint8_t op = static_cast<uint8_t>(p[8]);
+    if (op < static_cast<uint8_t>(WalOp::kAdd) || op > static_cast<uint8_t>(WalOp::kCheckpoint)) {
+        return false;
+    }
+    record.op = static_cast<WalOp>(op);
+    record.doc_id = static_cast<int64_t>(getU64(p + 9));
+    size_t offset = 17;
+    uint32_t title_size = getU32(p + offset);
+    offset += 4;
+    if (title_size > size - kFixedPayloadSize) {
+        return false;
+    }
+    record.title.assign(p + offset, title_size);
+    offset += title_size;
+    uint32_t content_size = getU32(p + offset);
+    offset += 4;
+    if (offset + content_size != size) {
+        return false;
+    }
+    record.content.assign(p + offset, content_size);
+    return true;
+}
+
+// 解析从p开始的一条完整记录（长度、校验、载荷格式都合法且lsn非0），返回记录字节数，不合法返回0
+size_t parseRecord(const char* p, size_t remaining, uint64_t& lsn, WalRecord& record) {
+    if (remaining < kHeaderSize) {
+        return 0;
+    }
+    uint32_t payload_size = getU32(p);
+    if (payload_size < kFixedPayloadSize || payload_size > remaining - kHeaderSize) {
+        return 0;
+    }
+    const char* payload = p + kHeaderSize;
+    if (crc32c::value(payload, payload_size) != getU32(p + 4) ||
+        !decodePayload(payload, payload_size, lsn, record) || lsn == 0) {
+        return 0;
+    }
+    return kHeaderSize + payload_size;
+}
+
+// 新建文件后同步其所在目录，保证目录项本身持久化
+bool syncParentDirectory(const std::string& path) {
+    size_t slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+} // namespace
+
+WriteAheadLog::~WriteAheadLog() {
+    close();
+}
+
+bool WriteAheadLog::open(const std::string& path, const WalOptions& options, const ReplayCallback& replay_callback) {
+    close();
+    options_ = options;
+    error_.clear();
+    replay_stats_ = WalReplayStats();
+    stats_ = WalStats();
+    pending_.clear();
+    next_lsn_ = 1;
+    durable_lsn_ = 0;
+    failed_ = false;
+    closing_ = false;
+
+    struct stat st;
+    const bool exists = ::stat(path.c_str(), &st) == 0;
+    uint64_t valid_bytes = 0;
+    if (exists && !replay(path, replay_callback, valid_bytes)) {
+        return false;
+    }
+
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        return fail("open " + path + ": " + std::strerror(errno));
+    }
+    if (replay_stats_.truncated_bytes > 0) {
+        // 截掉损坏的尾部，否则新记录会接在无法解析的数据之后
+        if (::ftruncate(fd_, static_cast<off_t>(valid_bytes)) != 0 || ::fdatasync(fd_) != 0) {
+            fail("truncate " + path + ": " + std::strerror(errno));
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+    }
+    if (!exists && !syncParentDirectory(path)) {
+        fail("fsync directory of " + path + ": " + std::strerror(errno));
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    if (options_.durability != WalDurability::kSync) {
+        flusher_ = std::thread(&WriteAheadLog::flushLoop, this);
+    }
+    return true;
+}
+
+bool WriteAheadLog::replay(const std::string& path, const ReplayCallback& callback, uint64_t& valid_bytes) {
+    auto start = Clock::now();
+    MappedFile file;
+    if (!file.open(path)) {
+        return fail(file.lastError());
+    }
+
+    const char* data = file.data();
+    const size_t size = file.size();
+
+    // 1. 校验：找到连续有效记录的结束位置
+    size_t offset = 0;
+    uint64_t expected_lsn = 0;  // 0表示第一条记录（reset()之后的日志以检查点记录开头，lsn不从1开始）
+    uint64_t lsn = 0;
+    WalRecord record;
+    while (size_t length = parseRecord(data + offset, size - offset, lsn, record)) {
+        if (expected_lsn != 0 && lsn != expected_lsn) {
+            break;
+        }
+        expected_lsn = lsn + 1;
+        offset += length;
+    }
+
+    // 之后的任意位置还能解析出更晚的记录，说明不是写了一半的尾部而是中间损坏：
+    // 截断会删掉已确认的记录，直接报错并保持文件不变
+    for (size_t p = offset; offset < size && p + kHeaderSize <= size; ++p) {
+        uint64_t later = 0;
+        if (parseRecord(data + p, size - p, later, record) && later >= expected_lsn) {
+            return fail("日志 " + path + " 在偏移 " + std::to_string(offset) + " 处损坏，之后还有有效记录（lsn " +
+                        std::to_string(later) + "）");
+        }
+    }
+
+    // 2. 重放有效部分
+    for (size_t p = 0; p < offset;) {
+        p += parseRecord(data + p, offset - p, lsn, record);
+        if (record.op == WalOp::kCheckpoint) {
+            continue;
+        }
+        if (callback) {
+            callback(record);
+        }
+        replay_stats_.records++;
+    }
+
+    valid_bytes = offset;
+    replay_stats_.bytes = offset;
+    replay_stats_.truncated_bytes = size - offset;
+    if (expected_lsn != 0) {
+        next_lsn_ = expected_lsn;
+        durable_lsn_ = expected_lsn - 1;
+    }
+    replay_stats_.elapsed_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return true;
+}
+
+uint64_t WriteAheadLog::encode(const std::vector<WalRecord>& records, std::string& out) {
+    for (const auto& record : records) {
+        const size_t payload_size = kFixedPayloadSize + record.title.size() + record.content.size();
+        const size_t begin = out.size();
+        out.reserve(begin + kHeaderSize + payload_size);
+        putU32(out, static_cast<uint32_t>(payload_size));
+        putU32(out, 0);  // 校验值，载荷写完后回填
+        putU64(out, next_lsn_++);
+        out.push_back(static_cast<char>(record.op));
+        putU64(out, static_cast<uint64_t>(record.doc_id));
+        putU32(out, static_cast<uint32_t>(record.title.size()));
+        out.append(record.title);
+        putU32(out, static_cast<uint32_t>(record.content.size()));
+        out.append(record.content);
+
+        uint32_t checksum = crc32c::value(out.data() + begin + kHeaderSize, payload_size);
+        for (int i = 0; i < 4; ++i) {
+            out[begin + 4 + i] = static_cast<char>((checksum >> (8 * i)) & 0xFF);
+        }
+    }
+    stats_.records += records.size();
+    return next_lsn_ - 1;
+}
+
+uint64_t WriteAheadLog::append(const WalRecord& record) {
+    return append(std::vector<WalRecord>{record});
+}
+
+uint64_t WriteAheadLog::append(const std::vector<WalRecord>& records) {
+    uint64_t lsn = enqueue(records);
+    if (lsn == 0 || options_.durability != WalDurability::kGroupCommit) {
+        return lsn;
+    }
+    return waitDurable(lsn) ? lsn : 0;
+}
+
+uint64_t WriteAheadLog::enqueue(const std::vector<WalRecord>& records) {
+    if (options_.durability != WalDurability::kSync) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (fd_ < 0 || failed_ || closing_) {
+            return 0;
+        }
+        uint64_t lsn = encode(records, pending_);
+        pending_cv_.notify_one();
+        return lsn;
+    }
+
+    // kSync：调用线程直接写入并刷盘，write_mutex_保证文件中的顺序与lsn一致
+    std::lock_guard<std::mutex> write_lock(write_mutex_);
+    std::string data;
+    uint64_t lsn = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (fd_ < 0 || failed_) {
+            return 0;
+        }
+        lsn = encode(records, data);
+    }
+    std::string error;
+    bool ok = writeAndSync(data, error);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ok) {
+        failed_ = true;
+        error_ = error;
+        durable_cv_.notify_all();
+        return 0;
+    }
+    durable_lsn_ = lsn;
+    stats_.bytes += data.size();
+    stats_.syncs++;
+    return lsn;
+}
+
+bool WriteAheadLog::waitDurable(uint64_t lsn) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    durable_cv_.wait(lock, [this, lsn] { return durable_lsn_ >= lsn || failed_; });
+    return durable_lsn_ >= lsn;
+}
+
+bool WriteAheadLog::sync() {
+    return waitDurable(lastLsn());
+}
+
+bool WriteAheadLog::reset() {
+    if (!sync()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> write_lock(write_mutex_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0 || failed_) {
+        return false;
+    }
+    // 清空后写一条检查点记录保存最后的lsn，重新打开时lsn从它之后继续
+    std::string checkpoint;
+    if (next_lsn_ > 1) {
+        // 检查点沿用最后一个lsn，不占用新的lsn（encode会把next_lsn_加回来）
+        WalRecord record;
+        record.op = WalOp::kCheckpoint;
+        next_lsn_--;
+        encode({record}, checkpoint);
+        stats_.records--;
+    }
+    std::string error;
+    bool ok = ::ftruncate(fd_, 0) == 0;
+    if (!ok) {
+        error = std::string("truncate: ") + std::strerror(errno);
+    } else {
+        ok = writeAndSync(checkpoint, error);
+    }
+    if (!ok) {
+        failed_ = true;
+        error_ = error;
+        durable_cv_.notify_all();
+        return false;
+    }
+    stats_.bytes += checkpoint.size();
+    stats_.syncs++;
+    return true;
+}
+
+void WriteAheadLog::close() {
+    if (flusher_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closing_ = true;
+        }
+        pending_cv_.notify_all();
+        flusher_.join();  // 刷盘线程退出前会写完剩余的记录
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+uint64_t WriteAheadLog::lastLsn() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_lsn_ - 1;
+}
+
+uint64_t WriteAheadLog::durableLsn() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return durable_lsn_;
+}
+
+WalStats WriteAheadLog::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void WriteAheadLog::flushLoop() {
+    std::string batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        pending_cv_.wait(lock, [this] { return !pending_.empty() || closing_; });
+        if (pending_.empty()) {
+            break;  // closing_且没有剩余记录
+        }
+        if (options_.group_commit_delay.count() > 0 && !closing_) {
+            pending_cv_.wait_for(lock, options_.group_commit_delay, [this] { return closing_; });
+        }
+        batch.clear();
+        batch.swap(pending_);
+        const uint64_t batch_lsn = next_lsn_ - 1;
+        lock.unlock();
+
+        std::string error;
+        bool ok;
+        {
+            std::lock_guard<std::mutex> write_lock(write_mutex_);
+            ok = writeAndSync(batch, error);
+        }
+
+        lock.lock();
+        if (!ok) {
+            failed_ = true;
+            error_ = error;
+            pending_.clear();
+            durable_cv_.notify_all();
+            break;
+        }
+        durable_lsn_ = batch_lsn;
+        stats_.bytes += batch.size();
+        stats_.syncs++;
+        durable_cv_.notify_all();
+    }
+}
+
+bool WriteAheadLog::writeAndSync(const std::string& data, std::string& error) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = ::write(fd_, data.data() + written, data.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = std::string("write: ") + std::strerror(errno);
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    if (::fdatasync(fd_) != 0) {
+        error = std::string("fdatasync: ") + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool WriteAheadLog::fail(const std::string& message) {
+    error_ = message;
+    return false;
+}
+
+} // namespace search_engine
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace search_engine {
+
+/**
+ * @brief 日志操作类型
+ */
+enum class WalOp : uint8_t {
+    kAdd = 1,       // 添加文档
+    kUpdate = 2,    // 更新文档（删除旧版本后添加）
+    kDelete = 3,    // 删除文档（只有doc_id）
+    kCheckpoint = 4 // reset()写入的检查点：保存最后一个lsn，重放时跳过，不交给回调
+};
+
+/**
+ * @brief 一条日志记录
+ */
+struct WalRecord {
+    WalOp op = WalOp::kAdd;
+    int64_t doc_id = 0;
+    std::string title;
+    std::string content;
+};
+
+/**
+ * @brief 持久化级别
+ */
+enum class WalDurability {
+    kNone,          // 记录交给后台线程写入，append立即返回；崩溃可能丢失最近一批记录
+    kGroupCommit,   // 后台线程把并发提交的记录合并成一次write + fdatasync，append等所在批次落盘后返回
+    kSync           // 每次append在调用线程write + fdatasync，不与其他提交合并
+};
+
+/**
+ * @brief 预写日志配置
+ */
+struct WalOptions {
+    WalDurability durability = WalDurability::kGroupCommit;
+    // 组提交时，刷盘线程拿到第一条记录后再等待多久以攒更多记录（0表示不等待，
+    // 上一次fdatasync期间到达的记录自然会合并到下一批）
+    std::chrono::microseconds group_commit_delay{0};
+};
+
+/**
+ * @brief 日志重放统计
+ */
+struct WalReplayStats {
+    uint64_t records = 0;           // 重放的记录数
+    uint64_t bytes = 0;             // 有效记录的字节数
+    uint64_t truncated_bytes = 0;   // 崩溃时写了一半、被截掉的尾部字节数
+    double elapsed_seconds = 0.0;
+};
+
+/**
+ * @brief 预写日志统计
+ */
+struct WalStats {
+    uint64_t records = 0;   // 本次打开后追加的记录数
+    uint64_t bytes = 0;     // 本次打开后写入的字节数
+    uint64_t syncs = 0;     // fdatasync次数（records / syncs 即平均每次刷盘合并的记录数）
+};
+
+/**
+ * @brief 追加写的预写日志（WAL）
+ *
+ * 文件格式（整数均为小端）：
+ *   记录: [u32 载荷长度][u32 CRC32C(载荷)][载荷]
+ *   载荷: [u64 lsn][u8 op][i64 doc_id][u32 标题长度][标题][u32 内容长度][内容]
+ * lsn从1开始连续递增；reset()之后文件以一条检查点记录开头，lsn接着之前的继续
+ *
+ * 设计思路：
+ * - 打开时先用mmap顺序扫描整个文件，逐条校验后交给回调重放。遇到长度越界、校验失败或
+ *   lsn不连续的记录时，如果之后再也解析不出更晚的有效记录，就是崩溃时写了一半的尾部，
+ *   截断到最后一条有效记录之后再继续追加；否则是中间损坏，open()失败且不修改文件
+ *   （截断会删掉已确认的记录）。只有全部校验通过才开始重放
+ * - 组提交：append只把编码好的记录放进内存缓冲区并分配lsn；刷盘线程每次取走缓冲区中的
+ *   全部记录，一次write + fdatasync，然后唤醒等待这些lsn的提交者。并发写入越多，
+ *   每次fdatasync分摊的记录越多
+ * - 写入或刷盘失败后日志进入失败状态，之后的append都返回0（不再保证顺序和持久性）
+ * - 只负责日志本身；没有检查点，日志随写入持续增长，需要由上层在持久化索引后调用reset()
+ */
+class WriteAheadLog {
+public:
+    using ReplayCallback = std::function<void(const WalRecord&)>;
+
+    WriteAheadLog() = default;
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /**
+     * @brief 打开日志：重放已有记录，截掉写了一半的尾部，然后准备追加
+     * 日志中间损坏（之后还有有效记录）时返回false，不重放也不修改文件
+     * @param path 日志文件路径（不存在时创建）
+     * @param options 配置
+     * @param replay 重放回调（按lsn顺序调用，可为空）
+     * @return 是否成功（失败原因见lastError()）
+     */
+    bool open(const std::string& path, const WalOptions& options = WalOptions(),
+              const ReplayCallback& replay = nullptr);
+
+    /**
+     * @brief 追加一条记录
+     * @return 记录的lsn（失败返回0）；kNone级别返回时记录可能尚未落盘
+     */
+    uint64_t append(const WalRecord& record);
+
+    /**
+     * @brief 追加一批记录（整批一起刷盘）
+     * @return 最后一条记录的lsn（失败返回0）
+     */
+    uint64_t append(const std::vector<WalRecord>& records);
+
+    /**
+     * @brief 只分配lsn、放入缓冲区，不等待落盘（配合waitDurable把等待移到锁外）
+     * @return 最后一条记录的lsn（失败返回0）
+     */
+    uint64_t enqueue(const std::vector<WalRecord>& records);
+
+    /**
+     * @brief 等待lsn之前（含）的记录全部落盘
+     * @return 是否成功（日志处于失败状态时返回false）
+     */
+    bool waitDurable(uint64_t lsn);
+
+    /**
+     * @brief 把已追加的记录全部刷盘（任意持久化级别）
+     */
+    bool sync();
+
+    /**
+     * @brief 清空日志（上层已把索引完整持久化之后调用），只保留一条检查点记录，
+     *        之后（包括重新打开后）lsn继续递增
+     * 调用期间不能有并发写入
+     */
+    bool reset();
+
+    /**
+     * @brief 刷盘并关闭（可重复调用）
+     */
+    void close();
+
+    bool isOpen() const { return fd_ >= 0; }
+    const WalOptions& options() const { return options_; }
+
+    /**
+     * @brief 最后分配的lsn / 已落盘的lsn
+     */
+    uint64_t lastLsn() const;
+    uint64_t durableLsn() const;
+
+    const WalReplayStats& replayStats() const { return replay_stats_; }
+    WalStats stats() const;
+
+    const std::string& lastError() const { return error_; }
+
+private:
+    // 重放日志，valid_bytes输出最后一条有效记录的结束位置
+    bool replay(const std::string& path, const ReplayCallback& callback, uint64_t& valid_bytes);
+    // 编码记录并分配lsn（调用方持有mutex_），返回最后一条记录的lsn
+    uint64_t encode(const std::vector<WalRecord>& records, std::string& out);
+    bool writeAndSync(const std::string& data, std::string& error);
+    bool fail(const std::string& message);
+    void flushLoop();
+
+    int fd_ = -1;
+    WalOptions options_;
+    WalReplayStats replay_stats_;
+    std::string error_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable pending_cv_;    // 刷盘线程等待新记录
+    std::condition_variable durable_cv_;    // 提交者等待落盘
+    std::string pending_;                   // 已分配lsn、尚未写入的记录
+    uint64_t next_lsn_ = 1;
+    uint64_t durable_lsn_ = 0;
+    bool failed_ = false;
+    bool closing_ = false;
+    std::thread flusher_;
+
+    // 串行化文件写入（kSync级别的调用线程、刷盘线程和reset()）
+    std::mutex write_mutex_;
+
+    WalStats stats_;
+};
+
+} // namespace search_engine